@@ -0,0 +1,2368 @@
+/*
+This work is licensed under the Creative Commons Attribution 3.0 United States
+License. To view a copy of this license, visit
+http://creativecommons.org/licenses/by/3.0/us/ or send a letter to Creative
+Commons, 444 Castro Street, Suite 900, Mountain View, California, 94041, USA.
+
+Copyright (C) 2013 Oak Ridge National Laboratory
+*/
+/**
+ * \file conductance.cc
+ * \brief Implementation of the Landauer conductance for the voltage-dependent
+ *        models.
+ *
+ * The vector versions are written once, using GCC's generic vector types,
+ * and instantiated for 4-wide (AVX2) and 8-wide (AVX-512) vectors inside
+ * functions compiled for the respective instruction sets. Everything is
+ * also templated on the element type, so that the single-precision batch
+ * functions are the same code run on 8-wide and 16-wide float vectors.
+ *
+ * \author Gaibo Zhang and Matthew G.\ Reuter
+ * \date August 2013; October 2026
+ */
+
+#include "conductance.h"
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <cfloat>
+
+/// Four doubles (one AVX2 register).
+typedef double v4d __attribute__((vector_size(32)));
+
+/// Eight doubles (one AVX-512 register).
+typedef double v8d __attribute__((vector_size(64)));
+
+/// Eight floats (one AVX2 register).
+typedef float v8f __attribute__((vector_size(32)));
+
+/// Sixteen floats (one AVX-512 register).
+typedef float v16f __attribute__((vector_size(64)));
+
+/// Sixteen doubles (two AVX-512 registers), for widening v16f.
+typedef double v16d __attribute__((vector_size(128)));
+
+/**
+ * \brief The vector types for each element type and instruction set.
+ */
+template <typename T>
+struct st_vectors;
+
+template <>
+struct st_vectors<double> {
+	typedef v4d avx2;
+	typedef v8d avx512;
+};
+
+template <>
+struct st_vectors<float> {
+	typedef v8f avx2;
+	typedef v16f avx512;
+};
+
+/// Signature shared by the batch functions.
+typedef void (*batch_fn)(const double*, const double*, const double*, double,
+	double, double*, size_t);
+
+/// Signature shared by the voltage grid functions.
+typedef void (*grid_fn)(const double*, size_t, const double*, const double*,
+	double, double, double*, size_t);
+
+/// Signature shared by the current functions.
+typedef void (*current_fn)(const double*, size_t, const double*,
+	const double*, double*, size_t);
+
+/// Signature shared by the asymmetric batch functions.
+typedef void (*batch_a_fn)(const double*, const double*, const double*,
+	const double*, double, double, double*, size_t);
+
+/// Signature shared by the chain batch functions.
+typedef void (*batch_c_fn)(const double*, const double*,
+	const double *const*, const double *const*, int, double, double, double*,
+	size_t);
+
+/// Signature shared by the molecule batch functions.
+typedef void (*batch_h_fn)(const double*, const double*, const double*,
+	const double *const*, const double *const*, int, double, double, double*,
+	size_t);
+
+/// Signature shared by the finite-temperature batch functions.
+typedef void (*batch_t_fn)(const double*, const double*, const double*,
+	double, double, double, double*, size_t);
+
+/// Signature shared by the single-precision batch functions.
+typedef void (*batch_f_fn)(const float*, const float*, const float*, float,
+	float, float*, size_t);
+
+/// The hopping between the two sites in the double-site model.
+static const double beta_d = -3.0;
+
+// Voltage-independent model
+template <typename T>
+static T transmission_i(T gamma, T epsilon, T E) {
+	return gamma*gamma /
+		((E-epsilon)*(E-epsilon) + gamma*gamma);
+}
+
+template <typename T>
+static T conductance_i_t(T V, T gamma, T epsilon, T eta, T EF) {
+	return eta*transmission_i(gamma, epsilon, EF + eta*V) +
+		(T(1.)-eta)*transmission_i(gamma, epsilon, EF + (eta-T(1.))*V);
+}
+
+double conductance_i(double V, double gamma, double epsilon, double eta,
+	double EF) {
+
+	return conductance_i_t(V, gamma, epsilon, eta, EF);
+}
+
+// Single-site, voltage-dependent model
+template <typename T>
+static T transmission_s(T V, T gamma, T epsilon, T E) {
+	return gamma*gamma /
+		((E-epsilon-V)*(E-epsilon-V) + gamma*gamma);
+}
+
+template <typename T>
+static T conductance_s_t(T V, T gamma, T epsilon, T eta, T EF) {
+	return (eta-T(1.))*transmission_s(V, gamma, epsilon, EF + eta*V) +
+		(T(2.)-eta)*transmission_s(V, gamma, epsilon, EF + (eta-T(1.))*V);
+}
+
+double conductance_s(double V, double gamma, double epsilon, double eta,
+	double EF) {
+
+	return conductance_s_t(V, gamma, epsilon, eta, EF);
+}
+
+// Scalar and vector helpers -------------------------------------------------
+// Square roots, logarithms, and arctangents, written once for a scalar or
+// vector type X (with double constants, which GCC broadcasts to every lane),
+// so that the vector code performs the same operations as the scalar code by
+// construction. They are always inlined into the instruction-set specific
+// functions, so GCC's warnings about the vector calling convention do not
+// apply.
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+/**
+ * \brief The integer type of the same width as X, for bit manipulation.
+ */
+template <typename X>
+struct st_bits;
+
+template <>
+struct st_bits<double> {
+	typedef unsigned long long type;
+};
+
+template <>
+struct st_bits<v4d> {
+	typedef unsigned long long type __attribute__((vector_size(32)));
+};
+
+template <>
+struct st_bits<v8d> {
+	typedef unsigned long long type __attribute__((vector_size(64)));
+};
+
+template <>
+struct st_bits<v16d> {
+	typedef unsigned long long type __attribute__((vector_size(128)));
+};
+
+// Generic vectors have no square root, and the intrinsics cannot be inlined
+// into these (untargeted) templates, so vectors take theirs lane by lane.
+static inline __attribute__((always_inline)) double sqrt_x(double x) {
+	return std::sqrt(x);
+}
+
+template <typename X>
+static inline __attribute__((always_inline)) X sqrt_x(const X &x) {
+	X r;
+
+	for (size_t j = 0; j < sizeof(X) / sizeof(double); ++j)
+		r[j] = std::sqrt(x[j]);
+	return r;
+}
+
+template <typename X>
+static inline __attribute__((always_inline)) X abs_x(const X &x) {
+	return (x < 0.) ? -x : x;
+}
+
+/// c0 + c1 y + c2 y^2 + c3 y^3, given y and y^2, in two independent halves.
+template <typename X>
+static inline __attribute__((always_inline)) X poly4_x(const X &y,
+	const X &y2, double c0, double c1, double c2, double c3) {
+
+	return (c0 + c1*y) + y2*(c2 + c3*y);
+}
+
+/// ln(2) with the low 21 bits of its mantissa zero, so that e*ln2_hi is
+/// exact for any exponent e.
+static const double ln2_hi = 6.93147180369123816490e-01;
+
+/// The rest of ln(2).
+static const double ln2_lo = 1.90821492927058770002e-10;
+
+/**
+ * \brief Natural logarithm of a positive, normal number.
+ *
+ * With x = 2^e m and m in [sqrt(1/2), sqrt(2)), ln m = 2 atanh(s) for
+ * s = (m-1)/(m+1), |s| < 0.172; the series is carried to s^21. The
+ * exponent is converted to floating point by adding it to the bits of
+ * 1.5 * 2^52, which needs no 64-bit integer conversion instructions. The
+ * series is summed in powers of s^8 (Estrin's scheme), which shortens the
+ * chain of dependent operations.
+ */
+template <typename X>
+static inline __attribute__((always_inline)) X log_x(const X &x) {
+	typedef typename st_bits<X>::type U;
+	U bits, e;
+	X m, s, s2, s4, s8, ef;
+
+	memcpy(&bits, &x, sizeof(X));
+
+	// the biased exponent, centering the mantissa on 1
+	e = (bits - 0x3FE6A09E667F3BCDULL + 0x3FF0000000000000ULL) >> 52;
+	bits = bits - (e << 52) + 0x3FF0000000000000ULL;
+	memcpy(&m, &bits, sizeof(X));
+	e += 0x4338000000000000ULL;
+	memcpy(&ef, &e, sizeof(X));
+	ef -= 6755399441056767.; // 1.5 * 2^52 + 1023
+
+	s = (m - 1.) / (m + 1.);
+	s2 = s*s;
+	s4 = s2*s2;
+	s8 = s4*s4;
+	return ef*ln2_hi + (ef*ln2_lo + 2.*s*(
+		poly4_x(s2, s4, 1., 1./3., 1./5., 1./7.) +
+		s8*(poly4_x(s2, s4, 1./9., 1./11., 1./13., 1./15.) +
+		s8*((1./17. + (1./19.)*s2) + (1./21.)*s4))));
+}
+
+/**
+ * \brief The argument (angle) of a nonzero complex number u + iv.
+ *
+ * The angle is folded into [0, pi/4] as atan(t) for t <= 1, and then into
+ * [-pi/8, pi/8] with atan(t) = pi/4 + atan((t-1)/(t+1)) for t above
+ * tan(pi/8), which leaves |t| < 0.415; the series is carried to t^39 and
+ * summed, as in log_x(), in powers of t^8.
+ */
+template <typename X>
+static inline __attribute__((always_inline)) X arg_x(const X &u,
+	const X &v) {
+
+	const X au = abs_x(u), av = abs_x(v);
+	const X mn = (av > au) ? au : av, mx = (av > au) ? av : au;
+	X t, t2, t4, t8, t16, a, p;
+
+	// mn / mx or, folded, (mn - mx) / (mn + mx)
+	t = (mn > 0.41421356237309504*mx) ? (mn - mx) / (mn + mx) : mn / mx;
+	p = (mn > 0.41421356237309504*mx) ? 0.25*M_PI : 0.*t;
+	t2 = t*t;
+	t4 = t2*t2;
+	t8 = t4*t4;
+	t16 = t8*t8;
+	a = p + t*((poly4_x(t2, t4, 1., -1./3., 1./5., -1./7.) +
+		t8*poly4_x(t2, t4, 1./9., -1./11., 1./13., -1./15.)) +
+		t16*((poly4_x(t2, t4, 1./17., -1./19., 1./21., -1./23.) +
+		t8*poly4_x(t2, t4, 1./25., -1./27., 1./29., -1./31.)) +
+		t16*poly4_x(t2, t4, 1./33., -1./35., 1./37., -1./39.)));
+
+	a = (av > au) ? 0.5*M_PI - a : a;
+	a = (u < 0.) ? M_PI - a : a;
+	return (v < 0.) ? -a : a;
+}
+
+/**
+ * \brief The double-precision type with the lanes of X.
+ */
+template <typename X>
+struct st_wide;
+
+template <>
+struct st_wide<v4d> {
+	typedef v4d type;
+};
+
+template <>
+struct st_wide<v8d> {
+	typedef v8d type;
+};
+
+template <>
+struct st_wide<v8f> {
+	typedef v8d type;
+};
+
+template <>
+struct st_wide<v16f> {
+	typedef v16d type;
+};
+
+/// Converts the lanes of X to double precision.
+static inline __attribute__((always_inline)) double widen_x(double x) {
+	return x;
+}
+
+template <typename X>
+static inline __attribute__((always_inline)) typename st_wide<X>::type
+	widen_x(const X &x) {
+
+	return __builtin_convertvector(x, typename st_wide<X>::type);
+}
+
+/// Converts double-precision lanes back to the type X.
+template <typename X>
+static inline __attribute__((always_inline)) X narrow_x(double x) {
+	return X(x);
+}
+
+template <typename X>
+static inline __attribute__((always_inline)) X narrow_x(
+	const typename st_wide<X>::type &x) {
+
+	return __builtin_convertvector(x, X);
+}
+
+// Double-site, voltage-dependent model
+//
+// With x = E - epsilon, bv = 4 beta^2 + V^2 and bvg = bv + gamma^2, both
+// transmissions and both ends of the integrated dT/dV depend on the sample
+// only through x; bv and bvg are computed once per sample.
+//
+// Two versions of the integrated dT/dV are implemented, selected by the
+// template parameter exact: model d (exact = false), as the simulator has
+// always computed it, and model x (exact = true), the exact dI/dV.
+//
+// With sb = sqrt(bv), the transmission is 16 gamma^2 beta^2 over
+//    ((2x - sb)^2 + gamma^2) ((2x + sb)^2 + gamma^2),
+// two Lorentzians of width |gamma| at x = +-sb/2. Its partial fractions
+// integrate to the antiderivative
+//    (2 |gamma| beta^2 theta(x) + (gamma^2 beta^2 / sb) lambda(x)) / bvg,
+// where theta(x) = atan2(4 |gamma| x, bvg - 4x^2) is the sum of the two
+// Lorentzians' arctangents and lambda(x) = log(((2x + sb)^2 + gamma^2) /
+// ((2x - sb)^2 + gamma^2)). The transmission depends on V only through sb,
+// so differentiating the antiderivative in V, at fixed x, gives the integral
+// of dT/dV across the bias window: the rational part dtdvint_d() and the
+// arctangent and logarithm terms of dtdvlog_d(), each taken between the two
+// ends. This is model x; it equals the asymmetric model (st_model_da) with
+// gammaL = gammaR. The logarithm and arctangents are evaluated with log_x()
+// and arg_x(), in double precision even for the single-precision functions,
+// so that the scalar and vector code round alike. Both ends' logarithms are
+// taken at once, as the logarithm of a ratio.
+//
+// Model d keeps the rational part but drops the logarithm term, and takes
+// its arctangent as atan2(2x sqrt(bv) / bvg, 2x gamma / bvg), a real number.
+// Its two coordinates share the factor 2x / bvg, so the angle depends on x
+// only through its sign: it is atan2(sqrt(bv), gamma) for x > 0 and pi less
+// for x < 0. The difference between the two ends is therefore pi times the
+// difference of the step functions, and no arctangent needs evaluating
+// unless an end falls exactly on x = 0. Model d therefore agrees with x
+// only at V = 0.
+//
+// Neither model is tabulated. A surrogate would interpolate the functions
+// of both ends in x, V, and gamma, which is 32 table reads a sample for
+// trilinear interpolation. Even with a 0.1 MB table, which fits in L2 but
+// is far too coarse for any useful error bound, that took about 20 ns a
+// sample, against about 4.5 ns for all of model d and 14 ns for model x
+// with AVX-512 or AVX2 (13 and 65 ns in scalar code). The same holds for the
+// polygamma functions of the finite-temperature versions below.
+template <typename T>
+static T transmission_d(T x, T g2, T b2, T bvg) {
+	T temp = T(4.)*x*x - bvg;
+
+	return T(16.)*g2*b2 / (temp*temp + T(16.)*g2*x*x);
+}
+
+template <typename T>
+static T dtdvint_d(T V, T g2, T b2, T bv, T bvg, T x) {
+	return T(8.)*V*g2*b2*x*(T(4.)*x*x + g2 - T(3.)*bv) /
+		(bv*bvg*(T(16.)*x*x*x*x + T(8.)*(g2 - bv)*x*x + bvg*bvg));
+}
+
+template <typename T>
+static T arctan_jump_d(T gamma, T bv, T x1, T x2) {
+	if (x1 != T(0.) && x2 != T(0.))
+		return T(M_PI) * ((x1 > T(0.)) - (x2 > T(0.)));
+
+	return std::atan2(x1*std::sqrt(bv), x1*gamma) -
+		std::atan2(x2*std::sqrt(bv), x2*gamma);
+}
+
+template <typename X>
+static inline __attribute__((always_inline)) X dtdvlog_d(const X &V,
+	const X &gamma, const X &g2, const X &bv, const X &bvg, const X &x1,
+	const X &x2) {
+
+	const double b2 = beta_d*beta_d;
+	const X g = abs_x(gamma), sb = sqrt_x(bv);
+	const X p1 = 2.*x1 + sb, m1 = 2.*x1 - sb;
+	const X p2 = 2.*x2 + sb, m2 = 2.*x2 - sb;
+	X theta, lambda;
+
+	theta = arg_x(bvg - 4.*x1*x1, 4.*g*x1) - arg_x(bvg - 4.*x2*x2, 4.*g*x2);
+	lambda = log_x(((p1*p1 + g2)*(m2*m2 + g2)) /
+		((m1*m1 + g2)*(p2*p2 + g2)));
+
+	return -4.*V*g*b2 / (bvg*bvg) * theta -
+		V*g2*b2*(bvg + 2.*bv) / (bv*sb*bvg*bvg) * lambda;
+}
+
+template <bool exact, typename T>
+static T conductance_d_t(T V, T gamma, T epsilon, T eta, T EF) {
+	const T b2 = T(beta_d)*T(beta_d);
+	const T g2 = gamma*gamma;
+	const T bv = T(4.)*b2 + V*V;
+	const T bvg = bv + g2;
+	const T x1 = EF + eta*V - epsilon;
+	const T x2 = EF + (eta-T(1.))*V - epsilon;
+	const T G = eta*transmission_d(x1, g2, b2, bvg) +
+		(T(1.)-eta)*transmission_d(x2, g2, b2, bvg) +
+		dtdvint_d(V, g2, b2, bv, bvg, x1) -
+		dtdvint_d(V, g2, b2, bv, bvg, x2);
+
+	if (exact)
+		return G + narrow_x<T>(dtdvlog_d(widen_x(V), widen_x(gamma),
+			widen_x(g2), widen_x(bv), widen_x(bvg), widen_x(x1), widen_x(x2)));
+
+	return G - T(8.)*V*gamma*b2 / (bvg*bvg) * arctan_jump_d(gamma, bv, x1, x2);
+}
+
+double conductance_d(double V, double gamma, double epsilon, double eta,
+	double EF) {
+
+	return conductance_d_t<false>(V, gamma, epsilon, eta, EF);
+}
+
+double conductance_x(double V, double gamma, double epsilon, double eta,
+	double EF) {
+
+	return conductance_d_t<true>(V, gamma, epsilon, eta, EF);
+}
+
+// Vector versions -----------------------------------------------------------
+// Each expression mirrors its scalar counterpart above, operation for
+// operation, so that every lane is rounded exactly as the scalar code is.
+// The helpers below are always inlined, as those above are.
+
+template <typename T, typename vec>
+static inline __attribute__((always_inline)) vec load(const T *x) {
+	vec v;
+	memcpy(&v, x, sizeof(vec));
+	return v;
+}
+
+template <typename T, typename vec>
+static inline __attribute__((always_inline)) void store(T *x, const vec &v) {
+	memcpy(x, &v, sizeof(vec));
+}
+
+template <typename vec>
+static inline __attribute__((always_inline)) vec transmission_i_v(const vec &gamma,
+	const vec &epsilon, const vec &E) {
+
+	return gamma*gamma /
+		((E-epsilon)*(E-epsilon) + gamma*gamma);
+}
+
+template <typename vec>
+static inline __attribute__((always_inline)) vec transmission_s_v(const vec &V,
+	const vec &gamma, const vec &epsilon, const vec &E) {
+
+	return gamma*gamma /
+		((E-epsilon-V)*(E-epsilon-V) + gamma*gamma);
+}
+
+template <typename T, typename vec>
+static inline __attribute__((always_inline)) vec transmission_d_v(const vec &x,
+	const vec &g2, T b2, const vec &bvg) {
+
+	vec temp = T(4.)*x*x - bvg;
+
+	return T(16.)*g2*b2 / (temp*temp + T(16.)*g2*x*x);
+}
+
+template <typename T, typename vec>
+static inline __attribute__((always_inline)) vec dtdvint_d_v(const vec &V,
+	const vec &g2, T b2, const vec &bv, const vec &bvg, const vec &x) {
+
+	return T(8.)*V*g2*b2*x*(T(4.)*x*x + g2 - T(3.)*bv) /
+		(bv*bvg*(T(16.)*x*x*x*x + T(8.)*(g2 - bv)*x*x + bvg*bvg));
+}
+
+template <typename T, typename vec>
+static inline __attribute__((always_inline)) void conductance_i_block(
+	const T *V, const T *gamma, const T *epsilon, T eta, T EF, T *out,
+	size_t n) {
+
+	const size_t w = sizeof(vec) / sizeof(T);
+	size_t k;
+	vec v;
+
+	for (k = 0; k + w <= n; k += w) {
+		v = load<T, vec>(V + k);
+		store(out + k,
+			eta*transmission_i_v(load<T, vec>(gamma + k),
+				load<T, vec>(epsilon + k), EF + eta*v) +
+			(T(1.)-eta)*transmission_i_v(load<T, vec>(gamma + k),
+				load<T, vec>(epsilon + k), EF + (eta-T(1.))*v));
+	}
+	for (; k < n; ++k)
+		out[k] = conductance_i_t(V[k], gamma[k], epsilon[k], eta, EF);
+}
+
+template <typename T, typename vec>
+static inline __attribute__((always_inline)) void conductance_s_block(
+	const T *V, const T *gamma, const T *epsilon, T eta, T EF, T *out,
+	size_t n) {
+
+	const size_t w = sizeof(vec) / sizeof(T);
+	size_t k;
+	vec v;
+
+	for (k = 0; k + w <= n; k += w) {
+		v = load<T, vec>(V + k);
+		store(out + k,
+			(eta-T(1.))*transmission_s_v(v, load<T, vec>(gamma + k),
+				load<T, vec>(epsilon + k), EF + eta*v) +
+			(T(2.)-eta)*transmission_s_v(v, load<T, vec>(gamma + k),
+				load<T, vec>(epsilon + k), EF + (eta-T(1.))*v));
+	}
+	for (; k < n; ++k)
+		out[k] = conductance_s_t(V[k], gamma[k], epsilon[k], eta, EF);
+}
+
+template <bool exact, typename T, typename vec>
+static inline __attribute__((always_inline)) void conductance_d_block(
+	const T *V, const T *gamma, const T *epsilon, T eta, T EF, T *out,
+	size_t n) {
+
+	const size_t w = sizeof(vec) / sizeof(T);
+	const T b2 = T(beta_d)*T(beta_d);
+	size_t k, j;
+	vec v, g, e, g2, bv, bvg, x1, x2, G, jump;
+
+	for (k = 0; k + w <= n; k += w) {
+		v = load<T, vec>(V + k);
+		g = load<T, vec>(gamma + k);
+		e = load<T, vec>(epsilon + k);
+		g2 = g*g;
+		bv = T(4.)*b2 + v*v;
+		bvg = bv + g2;
+		x1 = EF + eta*v - e;
+		x2 = EF + (eta-T(1.))*v - e;
+
+		G = eta*transmission_d_v(x1, g2, b2, bvg) +
+			(T(1.)-eta)*transmission_d_v(x2, g2, b2, bvg) +
+			dtdvint_d_v(v, g2, b2, bv, bvg, x1) -
+			dtdvint_d_v(v, g2, b2, bv, bvg, x2);
+
+		if (exact) {
+			store(out + k, G + narrow_x<vec>(dtdvlog_d(widen_x(v), widen_x(g),
+				widen_x(g2), widen_x(bv), widen_x(bvg), widen_x(x1),
+				widen_x(x2))));
+			continue;
+		}
+
+		// the comparisons give -1 (true) or 0 in each lane
+		jump = T(M_PI) * (__builtin_convertvector(-(x1 > T(0.)), vec) -
+			__builtin_convertvector(-(x2 > T(0.)), vec));
+		store(out + k, G - T(8.)*v*g*b2 / (bvg*bvg) * jump);
+
+		// an end exactly at x = 0 needs the arctangents
+		for (j = k; j < k + w; ++j)
+			if (x1[j - k] == T(0.) || x2[j - k] == T(0.))
+				out[j] = conductance_d_t<false>(V[j], gamma[j], epsilon[j],
+					eta, EF);
+	}
+	for (; k < n; ++k)
+		out[k] = conductance_d_t<exact>(V[k], gamma[k], epsilon[k], eta, EF);
+}
+
+// Voltage grids -------------------------------------------------------------
+// Each junction (gamma, epsilon) is evaluated at every voltage of a grid.
+// gamma^2 depends only on the junction, so it is computed once per vector of
+// junctions and stays in a register across the grid; the ends of the bias
+// window depend only on the voltage, so they are scalars broadcast to every
+// lane. What remains per point are the operations of conductance_i_t(), in
+// the same order, so the results equal those of the batch functions.
+template <typename T, typename vec>
+static inline __attribute__((always_inline)) void conductance_i_grid_block(
+	const T *V, size_t nV, const T *gamma, const T *epsilon, T eta, T EF,
+	T *out, size_t n) {
+
+	const size_t w = sizeof(vec) / sizeof(T);
+	size_t j, k;
+	vec g2, e, x1, x2;
+	T E1, E2;
+
+	for (j = 0; j + w <= n; j += w) {
+		g2 = load<T, vec>(gamma + j);
+		g2 = g2*g2;
+		e = load<T, vec>(epsilon + j);
+
+		for (k = 0; k < nV; ++k) {
+			E1 = EF + eta*V[k];
+			E2 = EF + (eta-T(1.))*V[k];
+			x1 = E1 - e;
+			x2 = E2 - e;
+			store(out + k*n + j,
+				eta*(g2 / (x1*x1 + g2)) + (T(1.)-eta)*(g2 / (x2*x2 + g2)));
+		}
+	}
+	for (; j < n; ++j)
+		for (k = 0; k < nV; ++k)
+			out[k*n + j] = conductance_i_t(V[k], gamma[j], epsilon[j], eta, EF);
+}
+
+static void conductance_i_grid_scalar(const double *V, size_t nV,
+	const double *gamma, const double *epsilon, double eta, double EF,
+	double *out, size_t n) {
+
+	for (size_t j = 0; j < n; ++j)
+		for (size_t k = 0; k < nV; ++k)
+			out[k*n + j] = conductance_i_t(V[k], gamma[j], epsilon[j], eta, EF);
+}
+
+__attribute__((target("avx2")))
+static void conductance_i_grid_avx2(const double *V, size_t nV,
+	const double *gamma, const double *epsilon, double eta, double EF,
+	double *out, size_t n) {
+
+	conductance_i_grid_block<double, v4d>(V, nV, gamma, epsilon, eta, EF, out,
+		n);
+}
+
+__attribute__((target("avx512f")))
+static void conductance_i_grid_avx512(const double *V, size_t nV,
+	const double *gamma, const double *epsilon, double eta, double EF,
+	double *out, size_t n) {
+
+	conductance_i_grid_block<double, v8d>(V, nV, gamma, epsilon, eta, EF, out,
+		n);
+}
+
+// The same for the single-site and double-site models. The voltage is
+// broadcast to every lane, so each point is computed as in the batch
+// functions, and the results again equal theirs.
+template <typename T, typename vec>
+static inline __attribute__((always_inline)) void conductance_s_grid_block(
+	const T *V, size_t nV, const T *gamma, const T *epsilon, T eta, T EF,
+	T *out, size_t n) {
+
+	const size_t w = sizeof(vec) / sizeof(T);
+	size_t j, k;
+	vec g, e, v;
+
+	for (j = 0; j + w <= n; j += w) {
+		g = load<T, vec>(gamma + j);
+		e = load<T, vec>(epsilon + j);
+
+		for (k = 0; k < nV; ++k) {
+			v = V[k] - (vec){};
+			store(out + k*n + j,
+				(eta-T(1.))*transmission_s_v(v, g, e, EF + eta*v) +
+				(T(2.)-eta)*transmission_s_v(v, g, e, EF + (eta-T(1.))*v));
+		}
+	}
+	for (; j < n; ++j)
+		for (k = 0; k < nV; ++k)
+			out[k*n + j] = conductance_s_t(V[k], gamma[j], epsilon[j], eta, EF);
+}
+
+template <bool exact, typename T, typename vec>
+static inline __attribute__((always_inline)) void conductance_d_grid_block(
+	const T *V, size_t nV, const T *gamma, const T *epsilon, T eta, T EF,
+	T *out, size_t n) {
+
+	const size_t w = sizeof(vec) / sizeof(T);
+	const T b2 = T(beta_d)*T(beta_d);
+	size_t j, k, l;
+	vec g, e, g2, v, bv, bvg, x1, x2, G, jump;
+
+	for (j = 0; j + w <= n; j += w) {
+		g = load<T, vec>(gamma + j);
+		e = load<T, vec>(epsilon + j);
+		g2 = g*g;
+
+		for (k = 0; k < nV; ++k) {
+			v = V[k] - (vec){};
+			bv = T(4.)*b2 + v*v;
+			bvg = bv + g2;
+			x1 = EF + eta*v - e;
+			x2 = EF + (eta-T(1.))*v - e;
+
+			G = eta*transmission_d_v(x1, g2, b2, bvg) +
+				(T(1.)-eta)*transmission_d_v(x2, g2, b2, bvg) +
+				dtdvint_d_v(v, g2, b2, bv, bvg, x1) -
+				dtdvint_d_v(v, g2, b2, bv, bvg, x2);
+
+			if (exact) {
+				store(out + k*n + j, G + narrow_x<vec>(dtdvlog_d(widen_x(v),
+					widen_x(g), widen_x(g2), widen_x(bv), widen_x(bvg),
+					widen_x(x1), widen_x(x2))));
+				continue;
+			}
+
+			jump = T(M_PI) * (__builtin_convertvector(-(x1 > T(0.)), vec) -
+				__builtin_convertvector(-(x2 > T(0.)), vec));
+			store(out + k*n + j, G - T(8.)*v*g*b2 / (bvg*bvg) * jump);
+
+			for (l = j; l < j + w; ++l)
+				if (x1[l - j] == T(0.) || x2[l - j] == T(0.))
+					out[k*n + l] = conductance_d_t<false>(V[k], gamma[l],
+						epsilon[l], eta, EF);
+		}
+	}
+	for (; j < n; ++j)
+		for (k = 0; k < nV; ++k)
+			out[k*n + j] = conductance_d_t<exact>(V[k], gamma[j], epsilon[j],
+				eta, EF);
+}
+
+static void conductance_s_grid_scalar(const double *V, size_t nV,
+	const double *gamma, const double *epsilon, double eta, double EF,
+	double *out, size_t n) {
+
+	for (size_t j = 0; j < n; ++j)
+		for (size_t k = 0; k < nV; ++k)
+			out[k*n + j] = conductance_s_t(V[k], gamma[j], epsilon[j], eta, EF);
+}
+
+template <bool exact>
+static void conductance_d_grid_scalar(const double *V, size_t nV,
+	const double *gamma, const double *epsilon, double eta, double EF,
+	double *out, size_t n) {
+
+	for (size_t j = 0; j < n; ++j)
+		for (size_t k = 0; k < nV; ++k)
+			out[k*n + j] = conductance_d_t<exact>(V[k], gamma[j], epsilon[j],
+				eta, EF);
+}
+
+__attribute__((target("avx2")))
+static void conductance_s_grid_avx2(const double *V, size_t nV,
+	const double *gamma, const double *epsilon, double eta, double EF,
+	double *out, size_t n) {
+
+	conductance_s_grid_block<double, v4d>(V, nV, gamma, epsilon, eta, EF, out,
+		n);
+}
+
+template <bool exact>
+__attribute__((target("avx2")))
+static void conductance_d_grid_avx2(const double *V, size_t nV,
+	const double *gamma, const double *epsilon, double eta, double EF,
+	double *out, size_t n) {
+
+	conductance_d_grid_block<exact, double, v4d>(V, nV, gamma, epsilon, eta,
+		EF, out, n);
+}
+
+__attribute__((target("avx512f")))
+static void conductance_s_grid_avx512(const double *V, size_t nV,
+	const double *gamma, const double *epsilon, double eta, double EF,
+	double *out, size_t n) {
+
+	conductance_s_grid_block<double, v8d>(V, nV, gamma, epsilon, eta, EF, out,
+		n);
+}
+
+template <bool exact>
+__attribute__((target("avx512f")))
+static void conductance_d_grid_avx512(const double *V, size_t nV,
+	const double *gamma, const double *epsilon, double eta, double EF,
+	double *out, size_t n) {
+
+	conductance_d_grid_block<exact, double, v8d>(V, nV, gamma, epsilon, eta,
+		EF, out, n);
+}
+
+// Currents ------------------------------------------------------------------
+// The current through each junction is the integral of its conductance
+// from V = 0, by the trapezoidal rule over the grid of voltages. The grids
+// above store each voltage's conductances contiguously, one junction per
+// lane, so the running sums go down the voltages a vector of junctions at a
+// time; the step widths are scalars, as the ends of the bias window are
+// above. The cell that holds V = 0 is split there, using the conductances
+// at V = 0, and the sums run outward from it in both directions.
+template <typename X>
+static inline __attribute__((always_inline)) void current_sums(
+	const double *V, size_t nV, size_t c, const double *G, const double *Gz,
+	double *I, size_t n) {
+
+	X s;
+	size_t k;
+
+	if (c < nV) {
+		s = (0.5*V[c]) * (load<double, X>(G + c*n) + load<double, X>(Gz));
+		store(I + c*n, s);
+		for (k = c + 1; k < nV; ++k) {
+			s += (0.5*(V[k] - V[k-1])) *
+				(load<double, X>(G + k*n) + load<double, X>(G + (k-1)*n));
+			store(I + k*n, s);
+		}
+	}
+	if (c > 0) {
+		s = (0.5*V[c-1]) * (load<double, X>(G + (c-1)*n) +
+			load<double, X>(Gz));
+		store(I + (c-1)*n, s);
+		for (k = c - 1; k-- > 0; ) {
+			s += (0.5*(V[k] - V[k+1])) *
+				(load<double, X>(G + k*n) + load<double, X>(G + (k+1)*n));
+			store(I + k*n, s);
+		}
+	}
+}
+
+template <typename vec>
+static inline __attribute__((always_inline)) void conductance_current_block(
+	const double *V, size_t nV, const double *G, const double *Gz, double *I,
+	size_t n) {
+
+	const size_t w = sizeof(vec) / sizeof(double);
+	size_t c, j;
+
+	// the first voltage at or above zero
+	for (c = 0; c < nV && V[c] < 0.; ++c)
+		;
+
+	for (j = 0; j + w <= n; j += w)
+		current_sums<vec>(V, nV, c, G + j, Gz + j, I + j, n);
+	for (; j < n; ++j)
+		current_sums<double>(V, nV, c, G + j, Gz + j, I + j, n);
+}
+
+static void conductance_current_scalar(const double *V, size_t nV,
+	const double *G, const double *Gz, double *I, size_t n) {
+
+	conductance_current_block<double>(V, nV, G, Gz, I, n);
+}
+
+__attribute__((target("avx2")))
+static void conductance_current_avx2(const double *V, size_t nV,
+	const double *G, const double *Gz, double *I, size_t n) {
+
+	conductance_current_block<v4d>(V, nV, G, Gz, I, n);
+}
+
+__attribute__((target("avx512f")))
+static void conductance_current_avx512(const double *V, size_t nV,
+	const double *G, const double *Gz, double *I, size_t n) {
+
+	conductance_current_block<v8d>(V, nV, G, Gz, I, n);
+}
+
+// Asymmetric coupling -------------------------------------------------------
+// The three models with separate couplings gammaL and gammaR to the two
+// electrodes; with gammaL = gammaR = gamma the transmissions reduce to the
+// symmetric ones. Only double precision is implemented. Each function here
+// is written once for a scalar or vector type X, as the helpers above are.
+
+/**
+ * \brief A complex number of scalars or vectors.
+ */
+template <typename X>
+struct st_complex {
+	/// The real and imaginary parts.
+	X re, im;
+};
+
+template <typename X>
+static inline __attribute__((always_inline)) st_complex<X> cmul(
+	const st_complex<X> &a, const st_complex<X> &b) {
+
+	st_complex<X> c = {a.re*b.re - a.im*b.im, a.re*b.im + a.im*b.re};
+	return c;
+}
+
+/// a times the complex conjugate of b.
+template <typename X>
+static inline __attribute__((always_inline)) st_complex<X> cmulc(
+	const st_complex<X> &a, const st_complex<X> &b) {
+
+	st_complex<X> c = {a.re*b.re + a.im*b.im, a.im*b.re - a.re*b.im};
+	return c;
+}
+
+template <typename X>
+static inline __attribute__((always_inline)) X cnorm(const st_complex<X> &a) {
+	return a.re*a.re + a.im*a.im;
+}
+
+/// The principal square root of u + iv.
+template <typename X>
+static inline __attribute__((always_inline)) st_complex<X> csqrt_x(const X &u,
+	const X &v) {
+
+	const X t = sqrt_x(0.5*(sqrt_x(u*u + v*v) + abs_x(u)));
+	const X h = v / (2.*t);
+	st_complex<X> s;
+
+	s.re = (u < 0.) ? abs_x(h) : t;
+	s.im = (u < 0.) ? ((v < 0.) ? -t : t) : h;
+	return s;
+}
+
+/// Voltage-independent model.
+struct st_model_ia {
+	template <typename X>
+	static inline __attribute__((always_inline)) X transmission(const X &gL,
+		const X &gR, const X &epsilon, const X &E) {
+
+		return 4.*gL*gR /
+			(4.*(E-epsilon)*(E-epsilon) + (gL+gR)*(gL+gR));
+	}
+
+	template <typename X>
+	static inline __attribute__((always_inline)) X conductance(const X &V,
+		const X &gL, const X &gR, const X &epsilon, double eta, double EF) {
+
+		return eta*transmission(gL, gR, epsilon, EF + eta*V) +
+			(1.-eta)*transmission(gL, gR, epsilon, EF + (eta-1.)*V);
+	}
+};
+
+/// Single-site, voltage-dependent model.
+struct st_model_sa {
+	template <typename X>
+	static inline __attribute__((always_inline)) X transmission(const X &V,
+		const X &gL, const X &gR, const X &epsilon, const X &E) {
+
+		return 4.*gL*gR /
+			(4.*(E-epsilon-V)*(E-epsilon-V) + (gL+gR)*(gL+gR));
+	}
+
+	template <typename X>
+	static inline __attribute__((always_inline)) X conductance(const X &V,
+		const X &gL, const X &gR, const X &epsilon, double eta, double EF) {
+
+		return (eta-1.)*transmission(V, gL, gR, epsilon, EF + eta*V) +
+			(2.-eta)*transmission(V, gL, gR, epsilon, EF + (eta-1.)*V);
+	}
+};
+
+/**
+ * \brief Double-site, voltage-dependent model.
+ *
+ * With x = E - epsilon, a = (gL+gR)/2, and
+ *    c = -(V^2 + gL gR + 4 beta^2)/4 + i V (gL-gR)/4,
+ * the transmission is T(x) = C / |D(x)|^2 with C = gL gR beta^2 and
+ * D(x) = x^2 + i a x + c. Its partial fractions are
+ *    T(x) = 2 Re sum_k alpha_k / (x - r_k)
+ * over the two roots r_k of D, with alpha_k = C / (D'(r_k) Dc(r_k)) and
+ * Dc(x) = x^2 - i a x + conj(c) (D conjugated for real x). Differentiating
+ * in V (a prime) gives r' = -c' / D'(r) and alpha' = -alpha P' / P for
+ * P = D'(r) Dc(r), so the integral of dT/dV across the bias window is
+ *    2 Re sum_k [alpha'_k log((x1-r_k)/(x2-r_k))
+ *       + alpha_k r'_k V / ((x1-r_k)(x2-r_k))]
+ * in closed form. The roots are distinct unless |gL - gR| >= 4|beta|.
+ *
+ * This is the exact dI/dV. With gL = gR it equals the symmetric model x
+ * (conductance_d_t<true>()), up to rounding; model d keeps only the real
+ * part of its arctangent, so it differs from both for V != 0.
+ */
+struct st_model_da {
+	template <typename X>
+	static inline __attribute__((always_inline)) X conductance(const X &V,
+		const X &gL, const X &gR, const X &epsilon, double eta, double EF) {
+
+		const double b2 = beta_d*beta_d;
+		const X a = 0.5*(gL + gR), C = gL*gR*b2;
+		const X x1 = EF + eta*V - epsilon, x2 = EF + (eta-1.)*V - epsilon;
+		st_complex<X> c, dc, s, r, Dp, Db, P, alpha, dr, dP, w1, w2, z;
+		X G, ns, nP, n1, n2, n12, lr, li;
+		int k;
+
+		c.re = -0.25*(V*V + gL*gR + 4.*b2);
+		c.im = 0.25*V*(gL - gR);
+		dc.re = -0.5*V;
+		dc.im = 0.25*(gL - gR);
+		s = csqrt_x(-a*a - 4.*c.re, -4.*c.im);
+		ns = 1. / cnorm(s);
+
+		G = eta*C / ((x1*x1 + c.re)*(x1*x1 + c.re) +
+				(a*x1 + c.im)*(a*x1 + c.im)) +
+			(1.-eta)*C / ((x2*x2 + c.re)*(x2*x2 + c.re) +
+				(a*x2 + c.im)*(a*x2 + c.im));
+
+		for (k = 0; k < 2; ++k) {
+			// r = (-ia +- s) / 2 and D'(r) = 2r + ia = +-s
+			Dp.re = k ? -s.re : s.re;
+			Dp.im = k ? -s.im : s.im;
+			r.re = 0.5*Dp.re;
+			r.im = 0.5*(Dp.im - a);
+
+			Db.re = r.re*r.re - r.im*r.im + a*r.im + c.re;
+			Db.im = 2.*r.re*r.im - a*r.re - c.im;
+			P = cmul(Dp, Db);
+			nP = 1. / cnorm(P);
+
+			// alpha = C / P and r' = -c' / D'
+			alpha.re = C*nP*P.re;
+			alpha.im = -C*nP*P.im;
+			dr = cmulc(dc, Dp);
+			dr.re = -dr.re*ns;
+			dr.im = -dr.im*ns;
+
+			// P' = (2 Dc(r) + D'(r) (2r - ia)) r' + D'(r) conj(c')
+			z.re = 2.*r.re;
+			z.im = 2.*r.im - a;
+			z = cmul(Dp, z);
+			z.re += 2.*Db.re;
+			z.im += 2.*Db.im;
+			dP = cmul(z, dr);
+			z = cmulc(Dp, dc);
+			dP.re += z.re;
+			dP.im += z.im;
+
+			// alpha' = -alpha P' / P, then times log((x1-r)/(x2-r))
+			z = cmulc(cmul(alpha, dP), P);
+			w1.re = x1 - r.re;
+			w1.im = -r.im;
+			w2.re = x2 - r.re;
+			w2.im = -r.im;
+			n1 = cnorm(w1);
+			n2 = cnorm(w2);
+			n12 = 1. / (n1*n2);
+			lr = 0.5*log_x(n1*n1*n12);
+			w2 = cmulc(w1, w2);
+			li = arg_x(w2.re, w2.im);
+			G -= 2.*nP*(z.re*lr - z.im*li);
+
+			// alpha r' V / ((x1-r)(x2-r))
+			z = cmul(alpha, dr);
+			w2.re = w1.re*(x2 - r.re) - w1.im*w1.im;
+			w2.im = w1.im*(w1.re + x2 - r.re);
+			G += 2.*V*(z.re*w2.re + z.im*w2.im)*n12;
+		}
+
+		return G;
+	}
+};
+
+template <typename Model, typename vec>
+static inline __attribute__((always_inline)) void conductance_a_block(
+	const double *V, const double *gammaL, const double *gammaR,
+	const double *epsilon, double eta, double EF, double *out, size_t n) {
+
+	const size_t w = sizeof(vec) / sizeof(double);
+	size_t k;
+
+	for (k = 0; k + w <= n; k += w)
+		store(out + k, Model::conductance(load<double, vec>(V + k),
+			load<double, vec>(gammaL + k), load<double, vec>(gammaR + k),
+			load<double, vec>(epsilon + k), eta, EF));
+	for (; k < n; ++k)
+		out[k] = Model::conductance(V[k], gammaL[k], gammaR[k], epsilon[k],
+			eta, EF);
+}
+
+template <typename Model>
+static void conductance_a_scalar(const double *V, const double *gammaL,
+	const double *gammaR, const double *epsilon, double eta, double EF,
+	double *out, size_t n) {
+
+	for (size_t k = 0; k < n; ++k)
+		out[k] = Model::conductance(V[k], gammaL[k], gammaR[k], epsilon[k],
+			eta, EF);
+}
+
+template <typename Model>
+__attribute__((target("avx2")))
+static void conductance_a_avx2(const double *V, const double *gammaL,
+	const double *gammaR, const double *epsilon, double eta, double EF,
+	double *out, size_t n) {
+
+	conductance_a_block<Model, v4d>(V, gammaL, gammaR, epsilon, eta, EF, out,
+		n);
+}
+
+template <typename Model>
+__attribute__((target("avx512f")))
+static void conductance_a_avx512(const double *V, const double *gammaL,
+	const double *gammaR, const double *epsilon, double eta, double EF,
+	double *out, size_t n) {
+
+	conductance_a_block<Model, v8d>(V, gammaL, gammaR, epsilon, eta, EF, out,
+		n);
+}
+
+double conductance_ia(double V, double gammaL, double gammaR, double epsilon,
+	double eta, double EF) {
+
+	return st_model_ia::conductance(V, gammaL, gammaR, epsilon, eta, EF);
+}
+
+double conductance_sa(double V, double gammaL, double gammaR, double epsilon,
+	double eta, double EF) {
+
+	return st_model_sa::conductance(V, gammaL, gammaR, epsilon, eta, EF);
+}
+
+double conductance_da(double V, double gammaL, double gammaR, double epsilon,
+	double eta, double EF) {
+
+	return st_model_da::conductance(V, gammaL, gammaR, epsilon, eta, EF);
+}
+
+// Chains --------------------------------------------------------------------
+// A chain of N sites with nearest-neighbor hopping, coupled to the
+// electrodes at its two ends. As in the double-site model, each end has the
+// self-energy -i gamma/2 and the applied bias drops linearly along the chain,
+// from +V/2 at the first site to -V/2 at the last; for N = 2 the
+// transmission is that of the double-site model.
+//
+// The transmission comes from the left-connected Green's functions,
+//    g_k = 1 / z_k,  z_k = E - h_k - beta_{k-1}^2 g_{k-1} (+ i gamma/2 at
+//    the ends),
+// for T = gamma^2 prod beta_k^2 prod |g_k|^2, in O(N). Its derivative in V
+// is carried along the same recursion: with z'_k = -h'_k - beta_{k-1}^2
+// g'_{k-1} and g'_k = -g_k^2 z'_k, T' = 2 T Re sum_k (-g_k z'_k).
+//
+// The integral of dT/dV across the bias window is taken by 8-point
+// Gauss-Legendre quadrature on panels no wider than |gamma| / (2 N), which
+// resolves the resonances (their widths shrink roughly as |gamma| / N) to a
+// relative error below about 1e-4 for N up to 20, and far below for short
+// chains; for N = 2 it agrees with the closed form of conductance_da(). The
+// eight energies of a panel are evaluated together, one per lane, and the
+// quadrature sums are taken in scalar code in a fixed order, so the results
+// do not depend on the instruction set.
+//
+// When that would take more than chain_max_panels uniform panels, the
+// resonances are narrow next to the window and lie close to the levels of
+// the closed chain, which are found by bisection on Sturm counts. The
+// window is cut at those levels, and each piece gets panels that start at
+// |gamma| / (2 N) at both ends and double in width toward its middle. This
+// takes O(N log(|V| / |gamma|)) panels and keeps the accuracy of the
+// uniform panels (to about 1e-10 of conductance_da() for N = 2) as gamma
+// goes to 0.
+
+/// The nodes of 8-point Gauss-Legendre quadrature on [-1, 1].
+static const double gauss8_x[8] = {-0.96028985649753623,
+	-0.79666647741362674, -0.52553240991632899, -0.18343464249564980,
+	0.18343464249564980, 0.52553240991632899, 0.79666647741362674,
+	0.96028985649753623};
+
+/// The weights of 8-point Gauss-Legendre quadrature.
+static const double gauss8_w[8] = {0.10122853629037626, 0.22238103445337447,
+	0.31370664587788729, 0.36268378337836198, 0.36268378337836198,
+	0.31370664587788729, 0.22238103445337447, 0.10122853629037626};
+
+/// The widest quadrature panel, in units of gamma / N.
+static const double chain_panel = 0.5;
+
+/// The most uniform quadrature panels across a bias window.
+static const long chain_max_panels = 1024;
+
+/// The accuracy of the chain's levels, in units of the narrowest panel.
+static const double chain_level_tol = 1e-3;
+
+/**
+ * \brief The transmission of a chain and its derivative in V.
+ *
+ * \param[in] E The energy.
+ * \param[in] h The site energies.
+ * \param[in] u The derivatives of the site energies in V.
+ * \param[in] b2 The squared hoppings; b2[k] joins sites k and k+1.
+ * \param[in] nsites The number of sites (at least 2).
+ * \param[in] gamma The coupling.
+ * \param[out] dT The derivative of the transmission in V.
+ * \return The transmission.
+ */
+template <typename X>
+static inline __attribute__((always_inline)) X chain_transmission(const X &E,
+	const double *h, const double *u, const double *b2, int nsites,
+	double gamma, X *dT) {
+
+	st_complex<X> z, g, dz, dg, q;
+	X T, S, nz;
+	int k;
+
+	T = 0.*E + gamma*gamma;
+	S = 0.*E;
+	g.re = g.im = dg.re = dg.im = 0.*E;
+	for (k = 0; k < nsites; ++k) {
+		z.re = E - h[k];
+		z.im = 0.*E;
+		dz.re = 0.*E - u[k];
+		dz.im = 0.*E;
+		if (k > 0) {
+			z.re -= b2[k-1]*g.re;
+			z.im -= b2[k-1]*g.im;
+			dz.re -= b2[k-1]*dg.re;
+			dz.im -= b2[k-1]*dg.im;
+			T *= b2[k-1];
+		}
+		if (k == 0 || k == nsites - 1)
+			z.im += 0.5*gamma;
+
+		// g = 1/z, q = -g z' = g'/g, and g' = g q
+		nz = 1. / cnorm(z);
+		g.re = z.re*nz;
+		g.im = -z.im*nz;
+		T *= nz;
+		q = cmul(g, dz);
+		q.re = -q.re;
+		q.im = -q.im;
+		dg = cmul(g, q);
+		S += q.re;
+	}
+
+	*dT = 2.*T*S;
+	return T;
+}
+
+/**
+ * \brief The number of levels of the closed chain below an energy.
+ *
+ * This is the number of negative pivots of the LDL^T factorization of
+ * H - x (Sylvester's law of inertia).
+ *
+ * \param[in] h The site energies.
+ * \param[in] b2 The squared hoppings.
+ * \param[in] nsites The number of sites.
+ * \param[in] x The energy.
+ * \return The number of levels below x.
+ */
+static int chain_count(const double *h, const double *b2, int nsites,
+	double x) {
+
+	double q = 1.;
+	int k, count = 0;
+
+	for (k = 0; k < nsites; ++k) {
+		q = h[k] - x - ((k > 0) ? b2[k-1] / q : 0.);
+
+		// a zero pivot is a level at x; count it as just below
+		if (q == 0.)
+			q = -DBL_EPSILON;
+		count += (q < 0.);
+	}
+	return count;
+}
+
+/**
+ * \brief Finds the levels of the closed chain (without the electrodes)
+ *        between two energies, by bisection.
+ *
+ * \param[in] h The site energies.
+ * \param[in] b2 The squared hoppings.
+ * \param[in] nsites The number of sites.
+ * \param[in] lo The lower energy.
+ * \param[in] hi The upper energy.
+ * \param[in] tol The accuracy of the levels.
+ * \param[out] levels The levels, in increasing order (at most nsites).
+ * \return The number of levels.
+ */
+static int chain_levels(const double *h, const double *b2, int nsites,
+	double lo, double hi, double tol, double *levels) {
+
+	double a, b, c;
+	int m, nlo, nhi;
+
+	nlo = chain_count(h, b2, nsites, lo);
+	nhi = chain_count(h, b2, nsites, hi);
+	for (m = nlo; m < nhi; ++m) {
+		// level m (counting from 0) is in [a, b)
+		a = (m > nlo) ? levels[m - nlo - 1] : lo;
+		b = hi;
+		while (b - a > tol) {
+			c = 0.5*(a + b);
+			if (chain_count(h, b2, nsites, c) > m)
+				b = c;
+			else
+				a = c;
+		}
+		levels[m - nlo] = 0.5*(a + b);
+	}
+	return nhi - nlo;
+}
+
+/**
+ * \brief The integral of a chain's dT/dV over one quadrature panel.
+ *
+ * \param[in] mid The middle of the panel.
+ * \param[in] half Half the panel's width.
+ * \param[in] h The site energies.
+ * \param[in] u The derivatives of the site energies in V.
+ * \param[in] b2 The squared hoppings.
+ * \param[in] nsites The number of sites.
+ * \param[in] gamma The coupling.
+ * \return The integral.
+ */
+template <typename vec>
+static inline __attribute__((always_inline)) double chain_panel_integral(
+	double mid, double half, const double *h, const double *u,
+	const double *b2, int nsites, double gamma) {
+
+	const size_t w = sizeof(vec) / sizeof(double);
+	double E[8], dT[8], sum;
+	vec dTv;
+	size_t i;
+
+	for (i = 0; i < 8; ++i)
+		E[i] = mid + half*gauss8_x[i];
+	for (i = 0; i < 8; i += w) {
+		chain_transmission(load<double, vec>(E + i), h, u, b2, nsites, gamma,
+			&dTv);
+		store(dT + i, dTv);
+	}
+
+	sum = 0.;
+	for (i = 0; i < 8; ++i)
+		sum += gauss8_w[i]*dT[i];
+	return half*sum;
+}
+
+template <typename vec>
+static inline __attribute__((always_inline)) void conductance_c_block(
+	const double *V, const double *gamma, const double *const *epsilon,
+	const double *const *beta, int nsites, double eta, double EF,
+	double *out, size_t n) {
+
+	double *h, *u, *b2, *cut;
+	double E1, E2, lo, hi, width, half, h0, x, step, G, unused;
+	long panels, p;
+	size_t j;
+	int k, l, ncut;
+
+	h = (double*)malloc((4*nsites + 2)*sizeof(double));
+	u = h + nsites;
+	b2 = u + nsites;
+	cut = b2 + nsites;
+	for (k = 0; k < nsites; ++k)
+		u[k] = 0.5 - (double)k / (nsites - 1);
+
+	for (j = 0; j < n; ++j) {
+		for (k = 0; k < nsites; ++k)
+			h[k] = epsilon[k][j] + V[j]*u[k];
+		for (k = 0; k + 1 < nsites; ++k)
+			b2[k] = beta[k][j]*beta[k][j];
+
+		E1 = EF + eta*V[j];
+		E2 = EF + (eta-1.)*V[j];
+		G = eta*chain_transmission(E1, h, u, b2, nsites, gamma[j], &unused) +
+			(1.-eta)*chain_transmission(E2, h, u, b2, nsites, gamma[j],
+				&unused);
+
+		// uniform panels from E2 to E1 (backwards for V < 0), unless the
+		// resonances are too narrow for a reasonable number of them
+		if (std::fabs(E1 - E2) * nsites <
+			chain_panel*std::fabs(gamma[j]) * chain_max_panels) {
+
+			panels = (long)std::ceil(std::fabs(E1 - E2) * nsites /
+				(chain_panel*std::fabs(gamma[j])));
+			width = (panels > 0) ? (E1 - E2) / panels : 0.;
+			half = 0.5*width;
+			for (p = 0; p < panels; ++p)
+				G += chain_panel_integral<vec>(E2 + (p + 0.5)*width, half, h,
+					u, b2, nsites, gamma[j]);
+
+			out[j] = G;
+			continue;
+		}
+
+		// otherwise the window is cut at the chain's levels, where the
+		// resonances are, and each piece gets panels that double in width
+		// from |gamma| / (2 N) at its ends toward its middle
+		lo = std::fmin(E1, E2);
+		hi = std::fmax(E1, E2);
+		h0 = std::fmax(chain_panel*std::fabs(gamma[j]) / nsites,
+			DBL_EPSILON*(hi - lo));
+		cut[0] = lo;
+		ncut = 1 + chain_levels(h, b2, nsites, lo, hi, chain_level_tol*h0,
+			cut + 1);
+		cut[ncut++] = hi;
+
+		for (l = 0; l + 1 < ncut; ++l) {
+			half = 0.5*(cut[l+1] - cut[l]);
+			for (x = 0., step = h0; x < half; x += step, step *= 2.) {
+				width = std::fmin(step, half - x);
+				G += ((E1 > E2) ? 1. : -1.) * (
+					chain_panel_integral<vec>(cut[l] + x + 0.5*width,
+						0.5*width, h, u, b2, nsites, gamma[j]) +
+					chain_panel_integral<vec>(cut[l+1] - x - 0.5*width,
+						0.5*width, h, u, b2, nsites, gamma[j]));
+			}
+		}
+
+		out[j] = G;
+	}
+
+	free(h);
+}
+
+static void conductance_c_scalar(const double *V, const double *gamma,
+	const double *const *epsilon, const double *const *beta, int nsites,
+	double eta, double EF, double *out, size_t n) {
+
+	conductance_c_block<double>(V, gamma, epsilon, beta, nsites, eta, EF,
+		out, n);
+}
+
+__attribute__((target("avx2")))
+static void conductance_c_avx2(const double *V, const double *gamma,
+	const double *const *epsilon, const double *const *beta, int nsites,
+	double eta, double EF, double *out, size_t n) {
+
+	conductance_c_block<v4d>(V, gamma, epsilon, beta, nsites, eta, EF, out,
+		n);
+}
+
+__attribute__((target("avx512f")))
+static void conductance_c_avx512(const double *V, const double *gamma,
+	const double *const *epsilon, const double *const *beta, int nsites,
+	double eta, double EF, double *out, size_t n) {
+
+	conductance_c_block<v8d>(V, gamma, epsilon, beta, nsites, eta, EF, out,
+		n);
+}
+
+double conductance_c(double V, double gamma, const double *epsilon,
+	const double *beta, int nsites, double eta, double EF) {
+
+	const double **rows;
+	double G;
+	int k;
+
+	// one sample: row k holds the single value of site (or hopping) k
+	rows = (const double**)malloc(2*nsites*sizeof(const double*));
+	for (k = 0; k < nsites; ++k) {
+		rows[k] = epsilon + k;
+		rows[nsites + k] = beta + k;
+	}
+	conductance_c_scalar(&V, &gamma, rows, rows + nsites, nsites, eta, EF,
+		&G, 1);
+	free(rows);
+	return G;
+}
+
+// Molecules -----------------------------------------------------------------
+// A molecule with an arbitrary Hamiltonian H (see hamiltonian.h), coupled to
+// the electrodes at sites l and r (self-energy -i gamma/2 each). With the
+// spectral decomposition H = sum_k lambda_k u_k u_k^T, the elements of
+// (x - H)^{-1} at the two sites are
+//    a = sum_k u_lk^2 / (x - lambda_k),  b = sum_k u_lk u_rk / (x - lambda_k),
+//    d = sum_k u_rk^2 / (x - lambda_k),
+// and the Dyson equation for this 2 x 2 block gives
+//    T = gamma^2 b^2 / ((1 - gamma^2 (ad - b^2) / 4)^2
+//       + gamma^2 (a + d)^2 / 4),
+// which also holds for l = r (then a = b = d and, for a single site,
+// T = gamma^2 / (x^2 + gamma^2) as in the voltage-independent model).
+//
+// The level energy shifts every on-site energy, and in model hs so does the
+// bias (as for the single site of model s); neither changes the
+// eigenvectors, so x = E - epsilon (- V) and the spectrum is found once per
+// Hamiltonian, not once per energy. Each transmission then costs O(N) in
+// real arithmetic. The models take the bias windows of models i and s.
+//
+// The spectra are per sample (row k of lambda holds eigenvalue k of every
+// sample), so disordered Hamiltonians need no special treatment here.
+
+/**
+ * \brief The transmission of a molecule.
+ *
+ * \param[in] x The energy less the level energy (and, for model hs, V).
+ * \param[in] gamma The coupling.
+ * \param[in] lambda The eigenvalues; lambda[k][j] is eigenvalue k of
+ *            sample j.
+ * \param[in] weight The spectral weights; weight[3k+i][j] is weight i of
+ *            eigenvector k of sample j (see st_hamiltonian).
+ * \param[in] nstates The number of eigenvalues.
+ * \param[in] j The (first) sample.
+ * \return The transmission.
+ */
+template <typename X>
+static inline __attribute__((always_inline)) X molecule_transmission(
+	const X &x, const X &gamma, const double *const *lambda,
+	const double *const *weight, int nstates, size_t j) {
+
+	X a, b, d, r, g2, s;
+	int k;
+
+	a = b = d = 0.*x;
+	for (k = 0; k < nstates; ++k) {
+		r = 1. / (x - load<double, X>(lambda[k] + j));
+		a += load<double, X>(weight[3*k] + j)*r;
+		b += load<double, X>(weight[3*k + 1] + j)*r;
+		d += load<double, X>(weight[3*k + 2] + j)*r;
+	}
+
+	g2 = 0.25*gamma*gamma;
+	s = 1. - g2*(a*d - b*b);
+	return 4.*g2*b*b / (s*s + g2*(a + d)*(a + d));
+}
+
+/// Molecule with the bias window of the voltage-independent model.
+struct st_model_hi {
+	template <typename X>
+	static inline __attribute__((always_inline)) X conductance(const X &V,
+		const X &gamma, const X &epsilon, const double *const *lambda,
+		const double *const *weight, int nstates, size_t j, double eta,
+		double EF) {
+
+		return eta*molecule_transmission((EF + eta*V) - epsilon, gamma,
+				lambda, weight, nstates, j) +
+			(1.-eta)*molecule_transmission((EF + (eta-1.)*V) - epsilon,
+				gamma, lambda, weight, nstates, j);
+	}
+};
+
+/// Molecule with the bias window of the single-site model.
+struct st_model_hs {
+	template <typename X>
+	static inline __attribute__((always_inline)) X conductance(const X &V,
+		const X &gamma, const X &epsilon, const double *const *lambda,
+		const double *const *weight, int nstates, size_t j, double eta,
+		double EF) {
+
+		return (eta-1.)*molecule_transmission((EF + eta*V) - epsilon - V,
+				gamma, lambda, weight, nstates, j) +
+			(2.-eta)*molecule_transmission((EF + (eta-1.)*V) - epsilon - V,
+				gamma, lambda, weight, nstates, j);
+	}
+};
+
+template <typename Model, typename vec>
+static inline __attribute__((always_inline)) void conductance_h_block(
+	const double *V, const double *gamma, const double *epsilon,
+	const double *const *lambda, const double *const *weight, int nstates,
+	double eta, double EF, double *out, size_t n) {
+
+	const size_t w = sizeof(vec) / sizeof(double);
+	size_t k;
+
+	for (k = 0; k + w <= n; k += w)
+		store(out + k, Model::conductance(load<double, vec>(V + k),
+			load<double, vec>(gamma + k), load<double, vec>(epsilon + k),
+			lambda, weight, nstates, k, eta, EF));
+	for (; k < n; ++k)
+		out[k] = Model::conductance(V[k], gamma[k], epsilon[k], lambda,
+			weight, nstates, k, eta, EF);
+}
+
+template <typename Model>
+static void conductance_h_scalar(const double *V, const double *gamma,
+	const double *epsilon, const double *const *lambda,
+	const double *const *weight, int nstates, double eta, double EF,
+	double *out, size_t n) {
+
+	conductance_h_block<Model, double>(V, gamma, epsilon, lambda, weight,
+		nstates, eta, EF, out, n);
+}
+
+template <typename Model>
+__attribute__((target("avx2")))
+static void conductance_h_avx2(const double *V, const double *gamma,
+	const double *epsilon, const double *const *lambda,
+	const double *const *weight, int nstates, double eta, double EF,
+	double *out, size_t n) {
+
+	conductance_h_block<Model, v4d>(V, gamma, epsilon, lambda, weight,
+		nstates, eta, EF, out, n);
+}
+
+template <typename Model>
+__attribute__((target("avx512f")))
+static void conductance_h_avx512(const double *V, const double *gamma,
+	const double *epsilon, const double *const *lambda,
+	const double *const *weight, int nstates, double eta, double EF,
+	double *out, size_t n) {
+
+	conductance_h_block<Model, v8d>(V, gamma, epsilon, lambda, weight,
+		nstates, eta, EF, out, n);
+}
+
+/**
+ * \brief One sample of a molecule model, with its spectrum in flat arrays.
+ */
+template <typename Model>
+static double conductance_h_one(double V, double gamma, double epsilon,
+	const double *lambda, const double *weight, int nstates, double eta,
+	double EF) {
+
+	const double **rows;
+	double G;
+	int k;
+
+	// one sample: row k holds the single value of eigenvalue (or weight) k
+	rows = (const double**)malloc(4*nstates*sizeof(const double*));
+	for (k = 0; k < nstates; ++k)
+		rows[k] = lambda + k;
+	for (k = 0; k < 3*nstates; ++k)
+		rows[nstates + k] = weight + k;
+	conductance_h_scalar<Model>(&V, &gamma, &epsilon, rows, rows + nstates,
+		nstates, eta, EF, &G, 1);
+	free(rows);
+	return G;
+}
+
+double conductance_hi(double V, double gamma, double epsilon,
+	const double *lambda, const double *weight, int nstates, double eta,
+	double EF) {
+
+	return conductance_h_one<st_model_hi>(V, gamma, epsilon, lambda, weight,
+		nstates, eta, EF);
+}
+
+double conductance_hs(double V, double gamma, double epsilon,
+	const double *lambda, const double *weight, int nstates, double eta,
+	double EF) {
+
+	return conductance_h_one<st_model_hs>(V, gamma, epsilon, lambda, weight,
+		nstates, eta, EF);
+}
+
+// Finite temperature --------------------------------------------------------
+// At temperature T the current is the integral of T(E) against
+// f(E - muL) - f(E - muR), with muL = EF + eta V and muR = EF + (eta-1) V,
+// so the conductance of models i and s is that of the zero-temperature
+// models with each transmission at a window edge mu replaced by its average
+// over the Fermi window, the integral of T(E) (-f'(E - mu)). For the double-
+// site model the same holds for the antiderivative of dT/dV (integrate by
+// parts), and the step in the arctangent term of model d becomes a Fermi
+// function.
+//
+// The transmissions, and the rational part of the antiderivative, are sums
+// of simple fractions 2 Re A / (x - r) with r below the real axis. With
+// s = 1 / (2 pi kT),
+//    integral (-f'(E - mu)) / (E - epsilon - r) dE
+//       = conj(i s psi'(1/2 + i s (x - conj(r)))),  x = mu - epsilon,
+// in terms of the trigamma function psi', so each window edge costs one
+// trigamma per pole: one for the Lorentzians of models i and s, two for the
+// double-site model, whose poles are r = (+-sqrt(bv) - i |gamma|) / 2 (see
+// the double-site model above). The arctangent and logarithm terms of the
+// exact (model x) antiderivative are the imaginary and real parts of log(x - r)
+// at its poles, whose average over the window is, up to a constant that
+// cancels between the edges, conj(psi(1/2 + i s (x - conj(r)))) in terms of
+// the digamma function psi: one more per pole and edge. These are exact at
+// any temperature, and tend to the zero-temperature results as kT -> 0.
+//
+// psi'(w) is found from psi'(w) = psi'(w+1) + 1/w^2, shifting each lane
+// (two at a time) until |w| >= 6, and then the asymptotic series through
+// w^-19, good to about 1e-13; psi(w) likewise. Re w >= 1/2 here, so at most
+// three double shifts are needed, and none when |mu - epsilon| or gamma is
+// large next to kT. A lane that is done adds exact zeros while the others
+// shift, so the vector code still rounds as the scalar code does.
+
+/// The smallest |w| at which the asymptotic series of psi'(w) is used.
+static const double trigamma_min = 6.;
+
+/// The Bernoulli numbers B_18, B_16, ..., B_2 of the asymptotic series.
+static const double trigamma_b[9] = {43867./798., -3617./510., 7./6.,
+	-691./2730., 5./66., -1./30., 1./42., -1./30., 1./6.};
+
+/// B_2k / 2k for k = 9, 8, ..., 1, for the asymptotic series of psi(w).
+static const double digamma_b[9] = {43867./14364., -3617./8160., 1./12.,
+	-691./32760., 1./132., -1./240., 1./252., -1./120., 1./12.};
+
+static inline __attribute__((always_inline)) bool any_x(bool m) {
+	return m;
+}
+
+template <typename M>
+static inline __attribute__((always_inline)) bool any_x(const M &m) {
+	for (size_t j = 0; j < sizeof(M) / sizeof(m[0]); ++j)
+		if (m[j])
+			return true;
+	return false;
+}
+
+/**
+ * \brief Exponential of a number in [-700, 700].
+ *
+ * With x = n ln(2) + y, n rounded to the nearest integer (by adding
+ * 1.5 * 2^52, as in log_x()), |y| <= ln(2)/2 and the Taylor series of e^y
+ * is carried to y^13, summed in powers of y^4. 2^n is assembled from its
+ * exponent bits.
+ */
+template <typename X>
+static inline __attribute__((always_inline)) X exp_x(const X &x) {
+	typedef typename st_bits<X>::type U;
+	U bits;
+	X n, y, y2, y4, p;
+
+	n = (x*M_LOG2E + 6755399441055744.) - 6755399441055744.;
+	y = (x - n*ln2_hi) - n*ln2_lo;
+	y2 = y*y;
+	y4 = y2*y2;
+	p = poly4_x(y, y2, 1., 1., 1./2., 1./6.) +
+		y4*(poly4_x(y, y2, 1./24., 1./120., 1./720., 1./5040.) +
+		y4*(poly4_x(y, y2, 1./40320., 1./362880., 1./3628800.,
+			1./39916800.) +
+		y4*(1./479001600. + (1./6227020800.)*y)));
+
+	n += 6755399441056767.; // 1.5 * 2^52 + 1023
+	memcpy(&bits, &n, sizeof(X));
+	bits <<= 52;
+	memcpy(&n, &bits, sizeof(X));
+	return p*n;
+}
+
+/// The Fermi function 1 / (1 + e^-y) (0 or 1 beyond |y| = 700).
+template <typename X>
+static inline __attribute__((always_inline)) X fermi_x(const X &y) {
+	const X c = (y > 700.) ? 700. + 0.*y : ((y < -700.) ? -700. + 0.*y : y);
+
+	return 1. / (1. + exp_x(-c));
+}
+
+
+/**
+ * \brief The sum of c[8-k] z2^k over k = 0, ..., 8.
+ *
+ * The polynomial is evaluated in pairs of terms (Estrin's scheme) to shorten
+ * the chain of complex products.
+ */
+template <typename X>
+static inline __attribute__((always_inline)) st_complex<X> bernoulli_x(
+	const st_complex<X> &z2, const double *c) {
+
+	st_complex<X> z4, z8, a, p, q[4];
+	int i;
+
+	z4 = cmul(z2, z2);
+	z8 = cmul(z4, z4);
+	for (i = 0; i < 4; ++i) {
+		q[i].re = c[8 - 2*i] + c[7 - 2*i]*z2.re;
+		q[i].im = c[7 - 2*i]*z2.im;
+	}
+	a = cmul(z4, q[3]);
+	q[2].re += a.re + c[0]*z8.re;
+	q[2].im += a.im + c[0]*z8.im;
+	a = cmul(z4, q[1]);
+	p.re = q[0].re + a.re;
+	p.im = q[0].im + a.im;
+	a = cmul(z8, q[2]);
+	p.re += a.re;
+	p.im += a.im;
+	return p;
+}
+
+/**
+ * \brief The trigamma function psi'(u + iv), for u >= 1/2.
+ */
+template <typename X>
+static inline __attribute__((always_inline)) st_complex<X> trigamma_x(
+	const X &u0, const X &v) {
+
+	const double w2 = trigamma_min*trigamma_min;
+	st_complex<X> s, a, z, z2, p;
+	X u = u0, nz, m;
+
+	// psi'(w) = 1/w^2 + 1/(w+1)^2 + psi'(w+2), for the lanes with |w| < 6;
+	// the pair is (2a + 1) / a^2 for a = w (w+1), with one division
+	s.re = s.im = 0.*u;
+	while (any_x(u*u + v*v < w2)) {
+		m = (u*u + v*v < w2) ? 1. + 0.*u : 0.*u;
+		a.re = u*u - v*v + u;
+		a.im = (2.*u + 1.)*v;
+		nz = 1. / cnorm(a);
+		z.re = a.re*nz;
+		z.im = -a.im*nz;
+		z2 = cmul(z, z);
+		a.re = 2.*a.re + 1.;
+		a.im = 2.*a.im;
+		z2 = cmul(a, z2);
+		s.re += m*z2.re;
+		s.im += m*z2.im;
+		u += 2.*m;
+	}
+
+	// 1/w + 1/(2w^2) + sum_k B_2k / w^(2k+1)
+	nz = 1. / (u*u + v*v);
+	z.re = u*nz;
+	z.im = -v*nz;
+	z2 = cmul(z, z);
+	p = cmul(cmul(z, z2), bernoulli_x(z2, trigamma_b));
+	s.re += z.re + 0.5*z2.re + p.re;
+	s.im += z.im + 0.5*z2.im + p.im;
+	return s;
+}
+
+/**
+ * \brief The digamma function psi(u + iv), for u >= 1/2.
+ *
+ * As trigamma_x(), shifting with psi(w) = psi(w+2) - 1/w - 1/(w+1).
+ */
+template <typename X>
+static inline __attribute__((always_inline)) st_complex<X> digamma_x(
+	const X &u0, const X &v) {
+
+	const double w2 = trigamma_min*trigamma_min;
+	st_complex<X> s, a, z, z2, p;
+	X u = u0, nz, m;
+
+	// the pair is (2w + 1) / a for a = w (w+1), with one division
+	s.re = s.im = 0.*u;
+	while (any_x(u*u + v*v < w2)) {
+		m = (u*u + v*v < w2) ? 1. + 0.*u : 0.*u;
+		a.re = u*u - v*v + u;
+		a.im = (2.*u + 1.)*v;
+		nz = 1. / cnorm(a);
+		z.re = (2.*u + 1.)*nz;
+		z.im = 2.*v*nz;
+		z = cmulc(z, a);
+		s.re -= m*z.re;
+		s.im -= m*z.im;
+		u += 2.*m;
+	}
+
+	// log w - 1/(2w) - sum_k B_2k / (2k w^2k)
+	nz = 1. / (u*u + v*v);
+	z.re = u*nz;
+	z.im = -v*nz;
+	z2 = cmul(z, z);
+	p = cmul(z2, bernoulli_x(z2, digamma_b));
+	s.re += 0.5*log_x(u*u + v*v) - 0.5*z.re - p.re;
+	s.im += arg_x(u, v) - 0.5*z.im - p.im;
+	return s;
+}
+
+/**
+ * \brief The Lorentzian gamma^2 / (x^2 + gamma^2), averaged over the Fermi
+ *        window.
+ *
+ * \param[in] x The window's center less the level energy.
+ * \param[in] gamma The coupling.
+ * \param[in] s 1 / (2 pi kT).
+ * \return The average.
+ */
+template <typename X>
+static inline __attribute__((always_inline)) X lorentzian_thermal(const X &x,
+	const X &gamma, double s) {
+
+	const X g = abs_x(gamma);
+
+	return g*s*trigamma_x(0.5 + g*s, x*s).re;
+}
+
+/// Voltage-independent model.
+struct st_thermal_i {
+	template <typename X>
+	static inline __attribute__((always_inline)) X conductance(const X &V,
+		const X &gamma, const X &epsilon, double eta, double EF, double kT) {
+
+		const double s = 1. / (2.*M_PI*kT);
+
+		return eta*lorentzian_thermal((EF + eta*V) - epsilon, gamma, s) +
+			(1.-eta)*lorentzian_thermal((EF + (eta-1.)*V) - epsilon, gamma,
+				s);
+	}
+};
+
+/// Single-site, voltage-dependent model.
+struct st_thermal_s {
+	template <typename X>
+	static inline __attribute__((always_inline)) X conductance(const X &V,
+		const X &gamma, const X &epsilon, double eta, double EF, double kT) {
+
+		const double s = 1. / (2.*M_PI*kT);
+
+		return (eta-1.)*lorentzian_thermal((EF + eta*V) - epsilon - V, gamma,
+				s) +
+			(2.-eta)*lorentzian_thermal((EF + (eta-1.)*V) - epsilon - V,
+				gamma, s);
+	}
+};
+
+/**
+ * \brief Double-site, voltage-dependent model.
+ *
+ * With g = |gamma|, transmission_d() is g^2 b2 / |D(x)|^2 for
+ * D(x) = x^2 + i g x - bvg/4 = (x - r+)(x - r-), and dtdvint_d() has the
+ * same denominator. At a root r, D'(r) = +-sqrt(bv) and the conjugate
+ * polynomial is Dc(r) = -i g (+-sqrt(bv) - i g), so the residues are
+ * N(r) / Q with Q = D'(r) Dc(r) = -(+-sqrt(bv) g^2 + i g bv), for the
+ * numerators N of the two functions.
+ *
+ * For model x (exact = true), the arctangent and logarithm terms of
+ * dtdvlog_d() are, up to constants, the sum over the roots of
+ * kA Im log(x - r) +- kL Re log(x - r), with + for the root at +sqrt(bv)/2.
+ * Model d (exact = false) takes the step of its arctangent instead.
+ */
+template <bool exact>
+struct st_thermal_dx {
+	template <typename X>
+	static inline __attribute__((always_inline)) X conductance(const X &V,
+		const X &gamma, const X &epsilon, double eta, double EF, double kT) {
+
+		const double s = 1. / (2.*M_PI*kT);
+		const double b2 = beta_d*beta_d;
+		const X g = abs_x(gamma), g2 = gamma*gamma;
+		const X bv = 4.*b2 + V*V, bvg = bv + g2, sb = sqrt_x(bv);
+		const X x1 = EF + eta*V - epsilon, x2 = EF + (eta-1.)*V - epsilon;
+		const X k = V*g2*b2 / (2.*bv*bvg);
+		const X ka = 4.*V*g*b2 / (bvg*bvg);
+		const X kl = 2.*V*g2*b2*(bvg + 2.*bv) / (bv*sb*bvg*bvg);
+		st_complex<X> r, q, a, b, ps, n;
+		X G, L, nq;
+		int root;
+
+		G = L = 0.*V;
+		for (root = 0; root < 2; ++root) {
+			r.re = (root == 0) ? 0.5*sb : -0.5*sb;
+			r.im = -0.5*g;
+
+			// 1 / Q, then the residues of the transmission (a) and of the
+			// antiderivative of dT/dV (b)
+			q.re = -r.re*2.*g2;
+			q.im = -g*bv;
+			nq = 1. / cnorm(q);
+			q.re *= nq;
+			q.im *= -nq;
+			a.re = g2*b2*q.re;
+			a.im = g2*b2*q.im;
+			n = cmul(r, r);
+			n.re = 4.*n.re + g2 - 3.*bv;
+			n.im = 4.*n.im;
+			n = cmul(r, n);
+			n.re *= k;
+			n.im *= k;
+			b = cmul(n, q);
+
+			// the two edges, with weights eta and 1 - eta on the
+			// transmission and +-1 on the antiderivative
+			ps = trigamma_x(0.5 + 0.5*g*s, (x1 - r.re)*s);
+			G += (eta*a.re + b.re)*ps.im - (eta*a.im + b.im)*ps.re;
+			ps = trigamma_x(0.5 + 0.5*g*s, (x2 - r.re)*s);
+			G += ((1.-eta)*a.re - b.re)*ps.im - ((1.-eta)*a.im - b.im)*ps.re;
+
+			// the averages of log(x - r) at the two edges
+			if (exact) {
+				ps = digamma_x(0.5 + 0.5*g*s, (x1 - r.re)*s);
+				L += ((root == 0) ? kl : -kl)*ps.re - ka*ps.im;
+				ps = digamma_x(0.5 + 0.5*g*s, (x2 - r.re)*s);
+				L -= ((root == 0) ? kl : -kl)*ps.re - ka*ps.im;
+			}
+		}
+
+		if (exact)
+			return -2.*s*G + L;
+
+		// the arctangent's step, as a difference of Fermi functions
+		return -2.*s*G - 8.*V*gamma*b2 / (bvg*bvg) * M_PI *
+			(fermi_x(x1 / kT) - fermi_x(x2 / kT));
+	}
+};
+
+/// The double-site model d at finite temperature.
+typedef st_thermal_dx<false> st_thermal_d;
+
+/// The exact double-site model x at finite temperature.
+typedef st_thermal_dx<true> st_thermal_x;
+
+template <typename Model, typename vec>
+static inline __attribute__((always_inline)) void conductance_t_block(
+	const double *V, const double *gamma, const double *epsilon, double eta,
+	double EF, double kT, double *out, size_t n) {
+
+	const size_t w = sizeof(vec) / sizeof(double);
+	size_t k;
+
+	for (k = 0; k + w <= n; k += w)
+		store(out + k, Model::conductance(load<double, vec>(V + k),
+			load<double, vec>(gamma + k), load<double, vec>(epsilon + k), eta,
+			EF, kT));
+	for (; k < n; ++k)
+		out[k] = Model::conductance(V[k], gamma[k], epsilon[k], eta, EF, kT);
+}
+
+template <typename Model>
+static void conductance_t_scalar(const double *V, const double *gamma,
+	const double *epsilon, double eta, double EF, double kT, double *out,
+	size_t n) {
+
+	for (size_t k = 0; k < n; ++k)
+		out[k] = Model::conductance(V[k], gamma[k], epsilon[k], eta, EF, kT);
+}
+
+template <typename Model>
+__attribute__((target("avx2")))
+static void conductance_t_avx2(const double *V, const double *gamma,
+	const double *epsilon, double eta, double EF, double kT, double *out,
+	size_t n) {
+
+	conductance_t_block<Model, v4d>(V, gamma, epsilon, eta, EF, kT, out, n);
+}
+
+template <typename Model>
+__attribute__((target("avx512f")))
+static void conductance_t_avx512(const double *V, const double *gamma,
+	const double *epsilon, double eta, double EF, double kT, double *out,
+	size_t n) {
+
+	conductance_t_block<Model, v8d>(V, gamma, epsilon, eta, EF, kT, out, n);
+}
+
+double conductance_i_thermal(double V, double gamma, double epsilon,
+	double eta, double EF, double kT) {
+
+	return st_thermal_i::conductance(V, gamma, epsilon, eta, EF, kT);
+}
+
+double conductance_s_thermal(double V, double gamma, double epsilon,
+	double eta, double EF, double kT) {
+
+	return st_thermal_s::conductance(V, gamma, epsilon, eta, EF, kT);
+}
+
+double conductance_d_thermal(double V, double gamma, double epsilon,
+	double eta, double EF, double kT) {
+
+	return st_thermal_d::conductance(V, gamma, epsilon, eta, EF, kT);
+}
+
+double conductance_x_thermal(double V, double gamma, double epsilon,
+	double eta, double EF, double kT) {
+
+	return st_thermal_x::conductance(V, gamma, epsilon, eta, EF, kT);
+}
+
+// Instruction-set specific entry points, for T = double and T = float
+template <typename T>
+static void conductance_i_scalar(const T *V, const T *gamma,
+	const T *epsilon, T eta, T EF, T *out, size_t n) {
+
+	for (size_t k = 0; k < n; ++k)
+		out[k] = conductance_i_t(V[k], gamma[k], epsilon[k], eta, EF);
+}
+
+template <typename T>
+static void conductance_s_scalar(const T *V, const T *gamma,
+	const T *epsilon, T eta, T EF, T *out, size_t n) {
+
+	for (size_t k = 0; k < n; ++k)
+		out[k] = conductance_s_t(V[k], gamma[k], epsilon[k], eta, EF);
+}
+
+template <bool exact, typename T>
+static void conductance_d_scalar(const T *V, const T *gamma,
+	const T *epsilon, T eta, T EF, T *out, size_t n) {
+
+	for (size_t k = 0; k < n; ++k)
+		out[k] = conductance_d_t<exact>(V[k], gamma[k], epsilon[k], eta, EF);
+}
+
+template <typename T>
+__attribute__((target("avx2")))
+static void conductance_i_avx2(const T *V, const T *gamma,
+	const T *epsilon, T eta, T EF, T *out, size_t n) {
+
+	conductance_i_block<T, typename st_vectors<T>::avx2>(V, gamma, epsilon,
+		eta, EF, out, n);
+}
+
+template <typename T>
+__attribute__((target("avx2")))
+static void conductance_s_avx2(const T *V, const T *gamma,
+	const T *epsilon, T eta, T EF, T *out, size_t n) {
+
+	conductance_s_block<T, typename st_vectors<T>::avx2>(V, gamma, epsilon,
+		eta, EF, out, n);
+}
+
+template <bool exact, typename T>
+__attribute__((target("avx2")))
+static void conductance_d_avx2(const T *V, const T *gamma,
+	const T *epsilon, T eta, T EF, T *out, size_t n) {
+
+	conductance_d_block<exact, T, typename st_vectors<T>::avx2>(V, gamma,
+		epsilon, eta, EF, out, n);
+}
+
+template <typename T>
+__attribute__((target("avx512f")))
+static void conductance_i_avx512(const T *V, const T *gamma,
+	const T *epsilon, T eta, T EF, T *out, size_t n) {
+
+	conductance_i_block<T, typename st_vectors<T>::avx512>(V, gamma,
+		epsilon, eta, EF, out, n);
+}
+
+template <typename T>
+__attribute__((target("avx512f")))
+static void conductance_s_avx512(const T *V, const T *gamma,
+	const T *epsilon, T eta, T EF, T *out, size_t n) {
+
+	conductance_s_block<T, typename st_vectors<T>::avx512>(V, gamma,
+		epsilon, eta, EF, out, n);
+}
+
+template <bool exact, typename T>
+__attribute__((target("avx512f")))
+static void conductance_d_avx512(const T *V, const T *gamma,
+	const T *epsilon, T eta, T EF, T *out, size_t n) {
+
+	conductance_d_block<exact, T, typename st_vectors<T>::avx512>(V, gamma,
+		epsilon, eta, EF, out, n);
+}
+
+/**
+ * \brief The batch functions for one instruction set.
+ */
+typedef struct {
+	/// The instruction set's name.
+	const char *isa;
+
+	/// The batch functions for each model.
+	batch_fn i, s, d, x;
+
+	/// The single-precision batch functions for each model.
+	batch_f_fn i_f, s_f, d_f, x_f;
+
+	/// The voltage grid functions for each model.
+	grid_fn i_grid, s_grid, d_grid, x_grid;
+
+	/// The function integrating conductances over a voltage grid.
+	current_fn current;
+
+	/// The batch functions for each model with asymmetric coupling.
+	batch_a_fn ia, sa, da;
+
+	/// The batch function for the chain model.
+	batch_c_fn c;
+
+	/// The batch functions for each molecule model.
+	batch_h_fn hi, hs;
+
+	/// The finite-temperature batch functions for each model.
+	batch_t_fn i_th, s_th, d_th, x_th;
+} st_kernels;
+
+/**
+ * \brief Picks the batch functions for this machine.
+ *
+ * \return The batch functions.
+ */
+static const st_kernels *select_kernels() {
+	static const st_kernels scalar = {"scalar",
+		conductance_i_scalar<double>, conductance_s_scalar<double>,
+		conductance_d_scalar<false, double>, conductance_d_scalar<true, double>,
+		conductance_i_scalar<float>, conductance_s_scalar<float>,
+		conductance_d_scalar<false, float>, conductance_d_scalar<true, float>,
+		conductance_i_grid_scalar, conductance_s_grid_scalar,
+		conductance_d_grid_scalar<false>, conductance_d_grid_scalar<true>,
+		conductance_current_scalar,
+		conductance_a_scalar<st_model_ia>,
+		conductance_a_scalar<st_model_sa>, conductance_a_scalar<st_model_da>,
+		conductance_c_scalar, conductance_h_scalar<st_model_hi>,
+		conductance_h_scalar<st_model_hs>, conductance_t_scalar<st_thermal_i>,
+		conductance_t_scalar<st_thermal_s>, conductance_t_scalar<st_thermal_d>,
+		conductance_t_scalar<st_thermal_x>};
+	static const st_kernels avx2 = {"avx2",
+		conductance_i_avx2<double>, conductance_s_avx2<double>,
+		conductance_d_avx2<false, double>, conductance_d_avx2<true, double>,
+		conductance_i_avx2<float>, conductance_s_avx2<float>,
+		conductance_d_avx2<false, float>, conductance_d_avx2<true, float>,
+		conductance_i_grid_avx2, conductance_s_grid_avx2,
+		conductance_d_grid_avx2<false>, conductance_d_grid_avx2<true>,
+		conductance_current_avx2,
+		conductance_a_avx2<st_model_ia>,
+		conductance_a_avx2<st_model_sa>, conductance_a_avx2<st_model_da>,
+		conductance_c_avx2, conductance_h_avx2<st_model_hi>,
+		conductance_h_avx2<st_model_hs>, conductance_t_avx2<st_thermal_i>,
+		conductance_t_avx2<st_thermal_s>, conductance_t_avx2<st_thermal_d>,
+		conductance_t_avx2<st_thermal_x>};
+	static const st_kernels avx512 = {"avx512",
+		conductance_i_avx512<double>, conductance_s_avx512<double>,
+		conductance_d_avx512<false, double>, conductance_d_avx512<true, double>,
+		conductance_i_avx512<float>, conductance_s_avx512<float>,
+		conductance_d_avx512<false, float>, conductance_d_avx512<true, float>,
+		conductance_i_grid_avx512, conductance_s_grid_avx512,
+		conductance_d_grid_avx512<false>, conductance_d_grid_avx512<true>,
+		conductance_current_avx512,
+		conductance_a_avx512<st_model_ia>,
+		conductance_a_avx512<st_model_sa>, conductance_a_avx512<st_model_da>,
+		conductance_c_avx512, conductance_h_avx512<st_model_hi>,
+		conductance_h_avx512<st_model_hs>, conductance_t_avx512<st_thermal_i>,
+		conductance_t_avx512<st_thermal_s>, conductance_t_avx512<st_thermal_d>,
+		conductance_t_avx512<st_thermal_x>};
+	const char *env = getenv("CONDUCTANCE_ISA");
+	const st_kernels *best;
+
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f"))
+		best = &avx512;
+	else if (__builtin_cpu_supports("avx2"))
+		best = &avx2;
+	else
+		best = &scalar;
+
+	// only allow downgrading from what the machine supports
+	if (env != NULL && strcmp(env, "scalar") == 0)
+		best = &scalar;
+	else if (env != NULL && strcmp(env, "avx2") == 0 && best == &avx512)
+		best = &avx2;
+
+	return best;
+}
+
+/**
+ * \brief Gets the batch functions for this machine, picking them on the
+ *        first call.
+ *
+ * \return The batch functions.
+ */
+static const st_kernels &kernels() {
+	static const st_kernels *chosen = select_kernels();
+
+	return *chosen;
+}
+
+void conductance_i_batch(const double *V, const double *gamma,
+	const double *epsilon, double eta, double EF, double *out, size_t n) {
+
+	kernels().i(V, gamma, epsilon, eta, EF, out, n);
+}
+
+void conductance_s_batch(const double *V, const double *gamma,
+	const double *epsilon, double eta, double EF, double *out, size_t n) {
+
+	kernels().s(V, gamma, epsilon, eta, EF, out, n);
+}
+
+void conductance_d_batch(const double *V, const double *gamma,
+	const double *epsilon, double eta, double EF, double *out, size_t n) {
+
+	kernels().d(V, gamma, epsilon, eta, EF, out, n);
+}
+
+void conductance_x_batch(const double *V, const double *gamma,
+	const double *epsilon, double eta, double EF, double *out, size_t n) {
+
+	kernels().x(V, gamma, epsilon, eta, EF, out, n);
+}
+
+void conductance_i_batch_f(const float *V, const float *gamma,
+	const float *epsilon, float eta, float EF, float *out, size_t n) {
+
+	kernels().i_f(V, gamma, epsilon, eta, EF, out, n);
+}
+
+void conductance_s_batch_f(const float *V, const float *gamma,
+	const float *epsilon, float eta, float EF, float *out, size_t n) {
+
+	kernels().s_f(V, gamma, epsilon, eta, EF, out, n);
+}
+
+void conductance_d_batch_f(const float *V, const float *gamma,
+	const float *epsilon, float eta, float EF, float *out, size_t n) {
+
+	kernels().d_f(V, gamma, epsilon, eta, EF, out, n);
+}
+
+void conductance_x_batch_f(const float *V, const float *gamma,
+	const float *epsilon, float eta, float EF, float *out, size_t n) {
+
+	kernels().x_f(V, gamma, epsilon, eta, EF, out, n);
+}
+
+void conductance_i_grid(const double *V, size_t nV, const double *gamma,
+	const double *epsilon, double eta, double EF, double *out, size_t n) {
+
+	kernels().i_grid(V, nV, gamma, epsilon, eta, EF, out, n);
+}
+
+void conductance_s_grid(const double *V, size_t nV, const double *gamma,
+	const double *epsilon, double eta, double EF, double *out, size_t n) {
+
+	kernels().s_grid(V, nV, gamma, epsilon, eta, EF, out, n);
+}
+
+void conductance_d_grid(const double *V, size_t nV, const double *gamma,
+	const double *epsilon, double eta, double EF, double *out, size_t n) {
+
+	kernels().d_grid(V, nV, gamma, epsilon, eta, EF, out, n);
+}
+
+void conductance_x_grid(const double *V, size_t nV, const double *gamma,
+	const double *epsilon, double eta, double EF, double *out, size_t n) {
+
+	kernels().x_grid(V, nV, gamma, epsilon, eta, EF, out, n);
+}
+
+void conductance_current(const double *V, size_t nV, const double *G,
+	const double *Gz, double *I, size_t n) {
+
+	kernels().current(V, nV, G, Gz, I, n);
+}
+
+void conductance_ia_batch(const double *V, const double *gammaL,
+	const double *gammaR, const double *epsilon, double eta, double EF,
+	double *out, size_t n) {
+
+	kernels().ia(V, gammaL, gammaR, epsilon, eta, EF, out, n);
+}
+
+void conductance_sa_batch(const double *V, const double *gammaL,
+	const double *gammaR, const double *epsilon, double eta, double EF,
+	double *out, size_t n) {
+
+	kernels().sa(V, gammaL, gammaR, epsilon, eta, EF, out, n);
+}
+
+void conductance_da_batch(const double *V, const double *gammaL,
+	const double *gammaR, const double *epsilon, double eta, double EF,
+	double *out, size_t n) {
+
+	kernels().da(V, gammaL, gammaR, epsilon, eta, EF, out, n);
+}
+
+void conductance_c_batch(const double *V, const double *gamma,
+	const double *const *epsilon, const double *const *beta, int nsites,
+	double eta, double EF, double *out, size_t n) {
+
+	kernels().c(V, gamma, epsilon, beta, nsites, eta, EF, out, n);
+}
+
+void conductance_hi_batch(const double *V, const double *gamma,
+	const double *epsilon, const double *const *lambda,
+	const double *const *weight, int nstates, double eta, double EF,
+	double *out, size_t n) {
+
+	kernels().hi(V, gamma, epsilon, lambda, weight, nstates, eta, EF, out, n);
+}
+
+void conductance_hs_batch(const double *V, const double *gamma,
+	const double *epsilon, const double *const *lambda,
+	const double *const *weight, int nstates, double eta, double EF,
+	double *out, size_t n) {
+
+	kernels().hs(V, gamma, epsilon, lambda, weight, nstates, eta, EF, out, n);
+}
+
+void conductance_i_thermal_batch(const double *V, const double *gamma,
+	const double *epsilon, double eta, double EF, double kT, double *out,
+	size_t n) {
+
+	kernels().i_th(V, gamma, epsilon, eta, EF, kT, out, n);
+}
+
+void conductance_s_thermal_batch(const double *V, const double *gamma,
+	const double *epsilon, double eta, double EF, double kT, double *out,
+	size_t n) {
+
+	kernels().s_th(V, gamma, epsilon, eta, EF, kT, out, n);
+}
+
+void conductance_d_thermal_batch(const double *V, const double *gamma,
+	const double *epsilon, double eta, double EF, double kT, double *out,
+	size_t n) {
+
+	kernels().d_th(V, gamma, epsilon, eta, EF, kT, out, n);
+}
+
+void conductance_x_thermal_batch(const double *V, const double *gamma,
+	const double *epsilon, double eta, double EF, double kT, double *out,
+	size_t n) {
+
+	kernels().x_th(V, gamma, epsilon, eta, EF, kT, out, n);
+}
+
+const char *conductance_isa() {
+	return kernels().isa;
+}
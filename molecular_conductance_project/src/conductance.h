@@ -0,0 +1,706 @@
+/*
+This work is licensed under the Creative Commons Attribution 3.0 United States
+License. To view a copy of this license, visit
+http://creativecommons.org/licenses/by/3.0/us/ or send a letter to Creative
+Commons, 444 Castro Street, Suite 900, Mountain View, California, 94041, USA.
+
+Copyright (C) 2013 Oak Ridge National Laboratory
+*/
+/**
+ * \file conductance.h
+ * \brief Prototypes for the Landauer conductance of the voltage-dependent
+ *        models, both one sample at a time and in batches.
+ *
+ * Five models are implemented with symmetric coupling:
+ *    - `i' The voltage-independent model.
+ *    - `s' The single-site voltage-dependent model.
+ *    - `d' The double-site voltage-dependent model.
+ *    - `x' The double-site model with the exact dI/dV; d drops a term of
+ *      its integrated dT/dV (see conductance.cc), so the two agree only
+ *      for V = 0.
+ *    - `c' The chain model: N sites, each with its own level energy and
+ *      hopping to the next (double precision only).
+ *
+ * Two more take a molecule with an arbitrary Hamiltonian, given by its
+ * spectral decomposition (see hamiltonian.h), in place of the single site
+ * of models i and s: `hi' and `hs' (double precision only).
+ *
+ * Models i, s, d, and x also have finite-temperature versions (suffix
+ * _thermal; double precision only), which average over the Fermi windows
+ * of the electrodes instead of taking the transmissions at the window
+ * edges. They are exact in closed form, and reduce to the zero-temperature
+ * models as kT -> 0.
+ *
+ * The first three also have versions with asymmetric coupling (suffix a;
+ * double precision only), where the couplings gammaL and gammaR to the two
+ * electrodes are separate. With gammaL = gammaR, ia, sa, and da give the
+ * same conductances as i, s, and x, up to rounding.
+ *
+ * The batch functions evaluate n samples at once using the widest vector
+ * instructions available on the machine (AVX-512, AVX2, or plain scalar
+ * code), which is detected at runtime. The choice can be overridden by
+ * setting the environment variable CONDUCTANCE_ISA to `avx512', `avx2', or
+ * `scalar'. The vector code performs the same operations in the same order
+ * as the scalar code, so the results do not depend on the choice.
+ *
+ * Single-precision versions of the batch functions (suffix _f) evaluate
+ * twice as many samples per vector instruction. They are opt-in: the
+ * accuracy-f32 program reports how far histograms built from them stray
+ * from the double-precision ones.
+ *
+ * \author Gaibo Zhang and Matthew G.\ Reuter
+ * \date August 2013; October 2026
+ */
+
+#ifndef __conductance_h__
+#define __conductance_h__
+
+#include <cstddef>
+
+/**
+ * \brief Landauer conductance for the voltage-independent model; symmetric
+ *        coupling.
+ *
+ * \param[in] V The applied voltage.
+ * \param[in] gamma The channel-lead coupling.
+ * \param[in] epsilon The channel's level energy.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \return The conductance, in units of G0.
+ */
+double conductance_i(double V, double gamma, double epsilon, double eta,
+	double EF);
+
+/**
+ * \brief Landauer conductance for the single-site voltage-dependent model;
+ *        symmetric coupling.
+ *
+ * \param[in] V The applied voltage.
+ * \param[in] gamma The channel-lead coupling.
+ * \param[in] epsilon The channel's level energy.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \return The conductance, in units of G0.
+ */
+double conductance_s(double V, double gamma, double epsilon, double eta,
+	double EF);
+
+/**
+ * \brief Landauer conductance for the double-site voltage-dependent model;
+ *        symmetric coupling.
+ *
+ * \param[in] V The applied voltage.
+ * \param[in] gamma The channel-lead coupling.
+ * \param[in] epsilon The channel's level energy.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \return The conductance, in units of G0.
+ */
+double conductance_d(double V, double gamma, double epsilon, double eta,
+	double EF);
+
+/**
+ * \brief Landauer conductance for the double-site voltage-dependent model
+ *        with the exact dI/dV; symmetric coupling.
+ *
+ * \param[in] V The applied voltage.
+ * \param[in] gamma The channel-lead coupling.
+ * \param[in] epsilon The channel's level energy.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \return The conductance, in units of G0.
+ */
+double conductance_x(double V, double gamma, double epsilon, double eta,
+	double EF);
+
+/**
+ * \brief Landauer conductance for a batch of samples; voltage-independent
+ *        model.
+ *
+ * \param[in] V The applied voltages.
+ * \param[in] gamma The channel-lead couplings.
+ * \param[in] epsilon The channel level energies.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \param[out] out The conductances, in units of G0.
+ * \param[in] n The number of samples.
+ */
+void conductance_i_batch(const double *V, const double *gamma,
+	const double *epsilon, double eta, double EF, double *out, size_t n);
+
+/**
+ * \brief Landauer conductance for a batch of samples; single-site
+ *        voltage-dependent model.
+ *
+ * \param[in] V The applied voltages.
+ * \param[in] gamma The channel-lead couplings.
+ * \param[in] epsilon The channel level energies.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \param[out] out The conductances, in units of G0.
+ * \param[in] n The number of samples.
+ */
+void conductance_s_batch(const double *V, const double *gamma,
+	const double *epsilon, double eta, double EF, double *out, size_t n);
+
+/**
+ * \brief Landauer conductance for a batch of samples; double-site
+ *        voltage-dependent model.
+ *
+ * \param[in] V The applied voltages.
+ * \param[in] gamma The channel-lead couplings.
+ * \param[in] epsilon The channel level energies.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \param[out] out The conductances, in units of G0.
+ * \param[in] n The number of samples.
+ */
+void conductance_d_batch(const double *V, const double *gamma,
+	const double *epsilon, double eta, double EF, double *out, size_t n);
+
+/**
+ * \brief Landauer conductance for a batch of samples; double-site
+ *        voltage-dependent model with the exact dI/dV.
+ *
+ * \param[in] V The applied voltages.
+ * \param[in] gamma The channel-lead couplings.
+ * \param[in] epsilon The channel level energies.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \param[out] out The conductances, in units of G0.
+ * \param[in] n The number of samples.
+ */
+void conductance_x_batch(const double *V, const double *gamma,
+	const double *epsilon, double eta, double EF, double *out, size_t n);
+
+/**
+ * \brief Single-precision version of conductance_i_batch().
+ *
+ * \param[in] V The applied voltages.
+ * \param[in] gamma The channel-lead couplings.
+ * \param[in] epsilon The channel level energies.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \param[out] out The conductances, in units of G0.
+ * \param[in] n The number of samples.
+ */
+void conductance_i_batch_f(const float *V, const float *gamma,
+	const float *epsilon, float eta, float EF, float *out, size_t n);
+
+/**
+ * \brief Single-precision version of conductance_s_batch().
+ *
+ * \param[in] V The applied voltages.
+ * \param[in] gamma The channel-lead couplings.
+ * \param[in] epsilon The channel level energies.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \param[out] out The conductances, in units of G0.
+ * \param[in] n The number of samples.
+ */
+void conductance_s_batch_f(const float *V, const float *gamma,
+	const float *epsilon, float eta, float EF, float *out, size_t n);
+
+/**
+ * \brief Single-precision version of conductance_d_batch().
+ *
+ * \param[in] V The applied voltages.
+ * \param[in] gamma The channel-lead couplings.
+ * \param[in] epsilon The channel level energies.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \param[out] out The conductances, in units of G0.
+ * \param[in] n The number of samples.
+ */
+void conductance_d_batch_f(const float *V, const float *gamma,
+	const float *epsilon, float eta, float EF, float *out, size_t n);
+
+/**
+ * \brief Single-precision version of conductance_x_batch().
+ *
+ * \param[in] V The applied voltages.
+ * \param[in] gamma The channel-lead couplings.
+ * \param[in] epsilon The channel level energies.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \param[out] out The conductances, in units of G0.
+ * \param[in] n The number of samples.
+ */
+void conductance_x_batch_f(const float *V, const float *gamma,
+	const float *epsilon, float eta, float EF, float *out, size_t n);
+
+/**
+ * \brief Landauer conductance for junctions evaluated across a grid of
+ *        voltages; voltage-independent model.
+ *
+ * Each junction is evaluated at every voltage, and the result for voltage k
+ * and junction j is the same as conductance_i_batch() gives for that pair.
+ * The terms that depend on only one of the two are computed once for it.
+ *
+ * \param[in] V The applied voltages.
+ * \param[in] nV The number of voltages.
+ * \param[in] gamma The channel-lead couplings of the junctions.
+ * \param[in] epsilon The channel level energies of the junctions.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \param[out] out The conductances, in units of G0; out[k*n + j] is junction
+ *             j at voltage k.
+ * \param[in] n The number of junctions.
+ */
+void conductance_i_grid(const double *V, size_t nV, const double *gamma,
+	const double *epsilon, double eta, double EF, double *out, size_t n);
+
+/**
+ * \brief Landauer conductance for junctions evaluated across a grid of
+ *        voltages; single-site model.
+ *
+ * As conductance_i_grid(); the results equal conductance_s_batch()'s.
+ *
+ * \param[in] V The applied voltages.
+ * \param[in] nV The number of voltages.
+ * \param[in] gamma The channel-lead couplings of the junctions.
+ * \param[in] epsilon The channel level energies of the junctions.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \param[out] out The conductances, in units of G0; out[k*n + j] is junction
+ *             j at voltage k.
+ * \param[in] n The number of junctions.
+ */
+void conductance_s_grid(const double *V, size_t nV, const double *gamma,
+	const double *epsilon, double eta, double EF, double *out, size_t n);
+
+/**
+ * \brief Landauer conductance for junctions evaluated across a grid of
+ *        voltages; double-site model.
+ *
+ * As conductance_i_grid(); the results equal conductance_d_batch()'s.
+ *
+ * \param[in] V The applied voltages.
+ * \param[in] nV The number of voltages.
+ * \param[in] gamma The channel-lead couplings of the junctions.
+ * \param[in] epsilon The channel level energies of the junctions.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \param[out] out The conductances, in units of G0; out[k*n + j] is junction
+ *             j at voltage k.
+ * \param[in] n The number of junctions.
+ */
+void conductance_d_grid(const double *V, size_t nV, const double *gamma,
+	const double *epsilon, double eta, double EF, double *out, size_t n);
+
+/**
+ * \brief Landauer conductance for junctions evaluated across a grid of
+ *        voltages; double-site model with the exact dI/dV.
+ *
+ * As conductance_i_grid(); the results equal conductance_x_batch()'s.
+ *
+ * \param[in] V The applied voltages.
+ * \param[in] nV The number of voltages.
+ * \param[in] gamma The channel-lead couplings of the junctions.
+ * \param[in] epsilon The channel level energies of the junctions.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \param[out] out The conductances, in units of G0; out[k*n + j] is junction
+ *             j at voltage k.
+ * \param[in] n The number of junctions.
+ */
+void conductance_x_grid(const double *V, size_t nV, const double *gamma,
+	const double *epsilon, double eta, double EF, double *out, size_t n);
+
+/**
+ * \brief Currents through junctions from their conductances across a grid
+ *        of voltages.
+ *
+ * The conductance of the models is the derivative dI/dV of the current, so
+ * the current at each voltage is the integral of the conductance from
+ * V = 0, found by the trapezoidal rule over the grid. The cell holding
+ * V = 0 is split there, using the conductances at V = 0. The grid need not
+ * be evenly spaced, and the results do not depend on the instruction set.
+ *
+ * \param[in] V The applied voltages, in increasing order.
+ * \param[in] nV The number of voltages.
+ * \param[in] G The conductances, laid out as from conductance_i_grid().
+ * \param[in] Gz The conductance of each junction at V = 0.
+ * \param[out] I The currents, in units of G0 V (77.48 microamperes), laid
+ *             out as G.
+ * \param[in] n The number of junctions.
+ */
+void conductance_current(const double *V, size_t nV, const double *G,
+	const double *Gz, double *I, size_t n);
+
+/**
+ * \brief Landauer conductance for the voltage-independent model; asymmetric
+ *        coupling.
+ *
+ * \param[in] V The applied voltage.
+ * \param[in] gammaL The coupling to one electrode.
+ * \param[in] gammaR The coupling to the other electrode.
+ * \param[in] epsilon The channel's level energy.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \return The conductance, in units of G0.
+ */
+double conductance_ia(double V, double gammaL, double gammaR,
+	double epsilon, double eta, double EF);
+
+/**
+ * \brief Landauer conductance for the single-site voltage-dependent
+ *        model; asymmetric coupling.
+ *
+ * \param[in] V The applied voltage.
+ * \param[in] gammaL The coupling to one electrode.
+ * \param[in] gammaR The coupling to the other electrode.
+ * \param[in] epsilon The channel's level energy.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \return The conductance, in units of G0.
+ */
+double conductance_sa(double V, double gammaL, double gammaR,
+	double epsilon, double eta, double EF);
+
+/**
+ * \brief Landauer conductance for the double-site voltage-dependent
+ *        model; asymmetric coupling.
+ *
+ * \param[in] V The applied voltage.
+ * \param[in] gammaL The coupling to one electrode.
+ * \param[in] gammaR The coupling to the other electrode.
+ * \param[in] epsilon The channel's level energy.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \return The conductance, in units of G0.
+ */
+double conductance_da(double V, double gammaL, double gammaR,
+	double epsilon, double eta, double EF);
+
+/**
+ * \brief Landauer conductance for a batch of samples; voltage-independent
+ *        model with asymmetric coupling.
+ *
+ * \param[in] V The applied voltages.
+ * \param[in] gammaL The couplings to one electrode.
+ * \param[in] gammaR The couplings to the other electrode.
+ * \param[in] epsilon The channel level energies.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \param[out] out The conductances, in units of G0.
+ * \param[in] n The number of samples.
+ */
+void conductance_ia_batch(const double *V, const double *gammaL,
+	const double *gammaR, const double *epsilon, double eta, double EF,
+	double *out, size_t n);
+
+/**
+ * \brief Landauer conductance for a batch of samples; single-site
+ *        voltage-dependent model with asymmetric coupling.
+ *
+ * \param[in] V The applied voltages.
+ * \param[in] gammaL The couplings to one electrode.
+ * \param[in] gammaR The couplings to the other electrode.
+ * \param[in] epsilon The channel level energies.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \param[out] out The conductances, in units of G0.
+ * \param[in] n The number of samples.
+ */
+void conductance_sa_batch(const double *V, const double *gammaL,
+	const double *gammaR, const double *epsilon, double eta, double EF,
+	double *out, size_t n);
+
+/**
+ * \brief Landauer conductance for a batch of samples; double-site
+ *        voltage-dependent model with asymmetric coupling.
+ *
+ * \param[in] V The applied voltages.
+ * \param[in] gammaL The couplings to one electrode.
+ * \param[in] gammaR The couplings to the other electrode.
+ * \param[in] epsilon The channel level energies.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \param[out] out The conductances, in units of G0.
+ * \param[in] n The number of samples.
+ */
+void conductance_da_batch(const double *V, const double *gammaL,
+	const double *gammaR, const double *epsilon, double eta, double EF,
+	double *out, size_t n);
+
+/**
+ * \brief Landauer conductance for the chain model; symmetric coupling.
+ *
+ * The chain's ends are coupled to the electrodes (self-energy -i gamma/2
+ * each), and the bias drops linearly along it, from +V/2 at site 0 to -V/2
+ * at site N-1. The transmission is found in O(N) by recursive Green's
+ * functions, and the integral of its derivative in V across the bias window
+ * by Gauss-Legendre quadrature (see conductance.cc). For N = 2 and equal
+ * level energies this is the exact dI/dV of the double-site model, the same
+ * as conductance_da() with gammaL = gammaR.
+ *
+ * \param[in] V The applied voltage.
+ * \param[in] gamma The channel-lead coupling.
+ * \param[in] epsilon The level energies of the N sites.
+ * \param[in] beta The hoppings; beta[k] joins sites k and k+1 (N-1 of them).
+ * \param[in] nsites The number of sites, N (at least 2).
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \return The conductance, in units of G0.
+ */
+double conductance_c(double V, double gamma, const double *epsilon,
+	const double *beta, int nsites, double eta, double EF);
+
+/**
+ * \brief Landauer conductance for a batch of samples; chain model.
+ *
+ * Each sample's transmission at the energies of a quadrature panel is
+ * evaluated with the widest vector instructions available, one energy per
+ * lane.
+ *
+ * \param[in] V The applied voltages.
+ * \param[in] gamma The channel-lead couplings.
+ * \param[in] epsilon The level energies; epsilon[k][j] is site k of sample
+ *            j.
+ * \param[in] beta The hoppings; beta[k][j] joins sites k and k+1 of sample
+ *            j.
+ * \param[in] nsites The number of sites (at least 2).
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \param[out] out The conductances, in units of G0.
+ * \param[in] n The number of samples.
+ */
+void conductance_c_batch(const double *V, const double *gamma,
+	const double *const *epsilon, const double *const *beta, int nsites,
+	double eta, double EF, double *out, size_t n);
+
+/**
+ * \brief Landauer conductance for the molecule model with the bias window of
+ *        the voltage-independent model; symmetric coupling.
+ *
+ * The molecule's Hamiltonian, shifted by the level energy, is coupled to
+ * the electrodes at two of its sites (self-energy -i gamma/2 each). Given
+ * its eigenvalues and the components of its eigenvectors at those sites,
+ * each transmission costs O(N) (see conductance.cc). For a single site this
+ * is the voltage-independent model.
+ *
+ * \param[in] V The applied voltage.
+ * \param[in] gamma The channel-lead coupling.
+ * \param[in] epsilon The level energy, added to every on-site energy.
+ * \param[in] lambda The eigenvalues of the Hamiltonian (N of them).
+ * \param[in] weight The spectral weights, three per eigenvector (see
+ *            st_hamiltonian).
+ * \param[in] nstates The number of eigenvalues, N.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \return The conductance, in units of G0.
+ */
+double conductance_hi(double V, double gamma, double epsilon,
+	const double *lambda, const double *weight, int nstates, double eta,
+	double EF);
+
+/**
+ * \brief Landauer conductance for the molecule model with the bias window of
+ *        the single-site model; symmetric coupling.
+ *
+ * As conductance_hi(), except that the bias shifts every on-site energy, as
+ * it does the single site of model s. For a single site this is model s.
+ *
+ * \param[in] V The applied voltage.
+ * \param[in] gamma The channel-lead coupling.
+ * \param[in] epsilon The level energy, added to every on-site energy.
+ * \param[in] lambda The eigenvalues of the Hamiltonian (N of them).
+ * \param[in] weight The spectral weights, three per eigenvector (see
+ *            st_hamiltonian).
+ * \param[in] nstates The number of eigenvalues, N.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \return The conductance, in units of G0.
+ */
+double conductance_hs(double V, double gamma, double epsilon,
+	const double *lambda, const double *weight, int nstates, double eta,
+	double EF);
+
+/**
+ * \brief Landauer conductance for a batch of samples; molecule model with
+ *        the bias window of the voltage-independent model.
+ *
+ * Each sample has its own spectrum, so a disordered Hamiltonian can be
+ * decomposed once per sample; without disorder, every row simply repeats
+ * the same numbers.
+ *
+ * \param[in] V The applied voltages.
+ * \param[in] gamma The channel-lead couplings.
+ * \param[in] epsilon The level energies.
+ * \param[in] lambda The eigenvalues; lambda[k][j] is eigenvalue k of sample
+ *            j.
+ * \param[in] weight The spectral weights; weight[3k+i][j] is weight i of
+ *            eigenvector k of sample j.
+ * \param[in] nstates The number of eigenvalues.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \param[out] out The conductances, in units of G0.
+ * \param[in] n The number of samples.
+ */
+void conductance_hi_batch(const double *V, const double *gamma,
+	const double *epsilon, const double *const *lambda,
+	const double *const *weight, int nstates, double eta, double EF,
+	double *out, size_t n);
+
+/**
+ * \brief Landauer conductance for a batch of samples; molecule model with
+ *        the bias window of the single-site model.
+ *
+ * \param[in] V The applied voltages.
+ * \param[in] gamma The channel-lead couplings.
+ * \param[in] epsilon The level energies.
+ * \param[in] lambda The eigenvalues; lambda[k][j] is eigenvalue k of sample
+ *            j.
+ * \param[in] weight The spectral weights; weight[3k+i][j] is weight i of
+ *            eigenvector k of sample j.
+ * \param[in] nstates The number of eigenvalues.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \param[out] out The conductances, in units of G0.
+ * \param[in] n The number of samples.
+ */
+void conductance_hs_batch(const double *V, const double *gamma,
+	const double *epsilon, const double *const *lambda,
+	const double *const *weight, int nstates, double eta, double EF,
+	double *out, size_t n);
+
+/**
+ * \brief Landauer conductance for the voltage-independent model at finite
+ *        temperature; symmetric coupling.
+ *
+ * \param[in] V The applied voltage.
+ * \param[in] gamma The channel-lead coupling.
+ * \param[in] epsilon The channel's level energy.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \param[in] kT The thermal energy (eV; positive).
+ * \return The conductance, in units of G0.
+ */
+double conductance_i_thermal(double V, double gamma, double epsilon,
+	double eta, double EF, double kT);
+
+/**
+ * \brief Landauer conductance for the single-site voltage-dependent model at
+ *        finite temperature; symmetric coupling.
+ *
+ * \param[in] V The applied voltage.
+ * \param[in] gamma The channel-lead coupling.
+ * \param[in] epsilon The channel's level energy.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \param[in] kT The thermal energy (eV; positive).
+ * \return The conductance, in units of G0.
+ */
+double conductance_s_thermal(double V, double gamma, double epsilon,
+	double eta, double EF, double kT);
+
+/**
+ * \brief Landauer conductance for the double-site voltage-dependent model at
+ *        finite temperature; symmetric coupling.
+ *
+ * Like conductance_d(), this integrates dT/dV without the term that model
+ * drops.
+ *
+ * \param[in] V The applied voltage.
+ * \param[in] gamma The channel-lead coupling.
+ * \param[in] epsilon The channel's level energy.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \param[in] kT The thermal energy (eV; positive).
+ * \return The conductance, in units of G0.
+ */
+double conductance_d_thermal(double V, double gamma, double epsilon,
+	double eta, double EF, double kT);
+
+/**
+ * \brief Landauer conductance for the double-site voltage-dependent model
+ *        with the exact dI/dV at finite temperature; symmetric coupling.
+ *
+ * \param[in] V The applied voltage.
+ * \param[in] gamma The channel-lead coupling.
+ * \param[in] epsilon The channel's level energy.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \param[in] kT The thermal energy (eV; positive).
+ * \return The conductance, in units of G0.
+ */
+double conductance_x_thermal(double V, double gamma, double epsilon,
+	double eta, double EF, double kT);
+
+/**
+ * \brief Landauer conductance for a batch of samples; voltage-independent
+ *        model at finite temperature.
+ *
+ * \param[in] V The applied voltages.
+ * \param[in] gamma The channel-lead couplings.
+ * \param[in] epsilon The channel's level energies.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \param[in] kT The thermal energy (eV; positive).
+ * \param[out] out The conductances, in units of G0.
+ * \param[in] n The number of samples.
+ */
+void conductance_i_thermal_batch(const double *V, const double *gamma,
+	const double *epsilon, double eta, double EF, double kT, double *out,
+	size_t n);
+
+/**
+ * \brief Landauer conductance for a batch of samples; single-site
+ *        voltage-dependent model at finite temperature.
+ *
+ * \param[in] V The applied voltages.
+ * \param[in] gamma The channel-lead couplings.
+ * \param[in] epsilon The channel's level energies.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \param[in] kT The thermal energy (eV; positive).
+ * \param[out] out The conductances, in units of G0.
+ * \param[in] n The number of samples.
+ */
+void conductance_s_thermal_batch(const double *V, const double *gamma,
+	const double *epsilon, double eta, double EF, double kT, double *out,
+	size_t n);
+
+/**
+ * \brief Landauer conductance for a batch of samples; double-site
+ *        voltage-dependent model at finite temperature.
+ *
+ * \param[in] V The applied voltages.
+ * \param[in] gamma The channel-lead couplings.
+ * \param[in] epsilon The channel's level energies.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \param[in] kT The thermal energy (eV; positive).
+ * \param[out] out The conductances, in units of G0.
+ * \param[in] n The number of samples.
+ */
+void conductance_d_thermal_batch(const double *V, const double *gamma,
+	const double *epsilon, double eta, double EF, double kT, double *out,
+	size_t n);
+
+/**
+ * \brief Landauer conductance for a batch of samples; double-site
+ *        voltage-dependent model with the exact dI/dV at finite temperature.
+ *
+ * \param[in] V The applied voltages.
+ * \param[in] gamma The channel-lead couplings.
+ * \param[in] epsilon The channel's level energies.
+ * \param[in] eta The relative voltage drop between the two electrodes.
+ * \param[in] EF The Fermi energy.
+ * \param[in] kT The thermal energy (eV; positive).
+ * \param[out] out The conductances, in units of G0.
+ * \param[in] n The number of samples.
+ */
+void conductance_x_thermal_batch(const double *V, const double *gamma,
+	const double *epsilon, double eta, double EF, double kT, double *out,
+	size_t n);
+
+/**
+ * \brief Gets the name of the instruction set used by the batch functions.
+ *
+ * \return `avx512', `avx2', or `scalar'.
+ */
+const char *conductance_isa();
+
+#endif
@@ -0,0 +1,117 @@
+/*
+This work is licensed under the Creative Commons Attribution 3.0 United States
+License. To view a copy of this license, visit
+http://creativecommons.org/licenses/by/3.0/us/ or send a letter to Creative
+Commons, 444 Castro Street, Suite 900, Mountain View, California, 94041, USA.
+
+Copyright (C) 2013 Oak Ridge National Laboratory
+*/
+/**
+ * \file density.cc
+ * \brief Implementation of the column-by-column histogram integration.
+ *
+ * \author agent
+ * \date October 2026
+ */
+
+#include "density.h"
+#include <cmath>
+#include <cfloat>
+
+void density_column(long col, int slot, void *params) {
+	st_density *d = (st_density*)params;
+	double *V = d->V[slot], *gamma = d->gamma[slot];
+	double *epsilon = d->epsilon[slot], *logg = d->logg[slot];
+	double *row = d->prob + col*d->nbin;
+	double width, v, g, w, lo, hi;
+	int a, b, k;
+
+	width = (d->Vmax - d->Vmin) / d->nbin;
+	w = 1.0 / ((double)d->nv * d->ng * d->ne);
+	lo = DBL_MAX;
+	hi = -DBL_MAX;
+
+	for (k = 0; k < d->ne; ++k)
+		epsilon[k] = d->epsilon0 + d->depsilon*d->eq[k];
+
+	for (a = 0; a < d->nv; ++a) {
+		v = d->Vmin + width*(col + (a + 0.5) / d->nv);
+
+		for (b = 0; b < d->ng; ++b) {
+			g = d->gamma0 + d->dgamma*d->gq[b];
+			for (k = 0; k < d->ne; ++k) {
+				V[k] = v;
+				gamma[k] = g;
+			}
+
+			// a conductance that is not positive has no log10; like the
+			// sampled histogram, leave it out (as NaN)
+			d->cond(V, gamma, epsilon, d->eta, d->EF, logg, d->ne);
+			for (k = 0; k < d->ne; ++k)
+				logg[k] = (logg[k] > 0.0) ? log10(logg[k]) : NAN;
+
+			if (d->range) {
+				for (k = 0; k < d->ne; ++k) {
+					if (logg[k] < lo)
+						lo = logg[k];
+					if (logg[k] > hi)
+						hi = logg[k];
+				}
+				continue;
+			}
+
+			// half a node's probability lies beyond each end node; the rest
+			// is between consecutive nodes, and where one of the two is left
+			// out, the half next to the other stays at that node
+			if (!std::isnan(logg[0]))
+				deposit(row, d, logg[0], logg[0], 0.5*w);
+			if (!std::isnan(logg[d->ne - 1]))
+				deposit(row, d, logg[d->ne - 1], logg[d->ne - 1], 0.5*w);
+			for (k = 1; k < d->ne; ++k) {
+				if (!std::isnan(logg[k - 1]) && !std::isnan(logg[k]))
+					deposit(row, d, logg[k - 1], logg[k], w);
+				else if (!std::isnan(logg[k - 1]))
+					deposit(row, d, logg[k - 1], logg[k - 1], 0.5*w);
+				else if (!std::isnan(logg[k]))
+					deposit(row, d, logg[k], logg[k], 0.5*w);
+			}
+		}
+	}
+
+	if (d->range) {
+		d->colmin[col] = lo;
+		d->colmax[col] = hi;
+	}
+}
+
+void deposit(double *row, const st_density *d, double a, double b, double w) {
+	double t, dg, left;
+	long j, jmin, jmax;
+
+	if (a > b) {
+		t = a;
+		a = b;
+		b = t;
+	}
+
+	dg = (d->gmax - d->gmin) / d->nbin;
+	jmin = (long)floor((a - d->gmin) / dg);
+	jmax = (long)floor((b - d->gmin) / dg);
+
+	if (jmin == jmax || b - a < 1.0e-12*dg) {
+		// all in one bin
+		j = (long)floor((0.5*(a + b) - d->gmin) / dg);
+		if (j >= 0 && j < d->nbin)
+			row[j] += w;
+		return;
+	}
+
+	if (jmin < 0)
+		jmin = 0;
+	if (jmax >= d->nbin)
+		jmax = d->nbin - 1;
+	for (j = jmin; j <= jmax; ++j) {
+		left = d->gmin + j*dg;
+		row[j] += w * (fmin(b, left + dg) - fmax(a, left)) / (b - a);
+	}
+}
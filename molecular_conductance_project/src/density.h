@@ -0,0 +1,83 @@
+/*
+This work is licensed under the Creative Commons Attribution 3.0 United States
+License. To view a copy of this license, visit
+http://creativecommons.org/licenses/by/3.0/us/ or send a letter to Creative
+Commons, 444 Castro Street, Suite 900, Mountain View, California, 94041, USA.
+
+Copyright (C) 2013 Oak Ridge National Laboratory
+*/
+/**
+ * \file density.h
+ * \brief Prototypes for integrating voltage-dependent conductance
+ *        histograms column by column (see main-density.cc).
+ *
+ * \author agent
+ * \date October 2026
+ */
+
+#ifndef __density_h__
+#define __density_h__
+
+#include "simulation.h"
+
+/**
+ * \brief Struct for passing the integration to the column functions.
+ *
+ * Each "block" handed to run_blocks() is one voltage column.
+ */
+typedef struct {
+	/// The conductance model (batch version).
+	conductance_batch_fn cond;
+
+	/// The physical parameters (see the command-line arguments).
+	double EF, depsilon, epsilon0, dgamma, gamma0, Vmin, Vmax, eta;
+
+	/// The number of bins in each direction.
+	int nbin;
+
+	/// The number of nodes per voltage bin, for the coupling, and for the
+	/// site level energy.
+	int nv, ng, ne;
+
+	/// The standard normal quantiles of the coupling and site level energy
+	/// nodes.
+	double *gq, *eq;
+
+	/// The log10 conductance range.
+	double gmin, gmax;
+
+	/// Whether this pass finds the range (true) or the probabilities.
+	bool range;
+
+	/// The smallest and largest log10 conductance in each column.
+	double *colmin, *colmax;
+
+	/// The probability of each bin, column by column.
+	double *prob;
+
+	/// One set of node arrays per slot.
+	double **V, **gamma, **epsilon, **logg;
+} st_density;
+
+/**
+ * \brief Integrates one voltage column (or finds its conductance range).
+ *
+ * \param[in] col The voltage column.
+ * \param[in] slot The slot (thread) workspace to use.
+ * \param[in] params The st_density.
+ */
+void density_column(long col, int slot, void *params);
+
+/**
+ * \brief Adds probability spread uniformly over a log10 conductance
+ *        interval to a column.
+ *
+ * \param[in,out] row The column's bin probabilities.
+ * \param[in] d The integration (for the range and bins).
+ * \param[in] a One end of the interval.
+ * \param[in] b The other end of the interval.
+ * \param[in] w The probability.
+ */
+void deposit(double *row, const st_density *d, double a, double b, double w);
+
+#endif
@@ -0,0 +1,399 @@
+/*
+This work is licensed under the Creative Commons Attribution 3.0 United States
+License. To view a copy of this license, visit
+http://creativecommons.org/licenses/by/3.0/us/ or send a letter to Creative
+Commons, 444 Castro Street, Suite 900, Mountain View, California, 94041, USA.
+
+Copyright (C) 2013 Oak Ridge National Laboratory
+*/
+/**
+ * \file distributions.cc
+ * \brief Implementation of the tabulated distributions.
+ *
+ * \author agent
+ * \date October 2026
+ */
+
+#include "distributions.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <cfloat>
+
+/// The number of points scanned to find where a beta density is negligible.
+#define BETA_SCAN 65536
+
+/// Where the density falls below exp(-#BETA_CUTOFF) of its largest value, it
+/// is treated as zero.
+#define BETA_CUTOFF 40.0
+
+/**
+ * \brief The logarithm of the unnormalized beta density.
+ *
+ * \param[in] x The point, in [0, 1].
+ * \param[in] alpha The first shape parameter.
+ * \param[in] beta The second shape parameter.
+ * \return log(x^(alpha-1) (1-x)^(beta-1)); -infinity where the density is 0.
+ */
+static double beta_log_density(double x, double alpha, double beta) {
+	double l = 0.0;
+
+	// a zero exponent contributes nothing, even at x = 0 or 1
+	if (alpha != 1.0)
+		l += (alpha - 1.0) * log(x);
+	if (beta != 1.0)
+		l += (beta - 1.0) * log1p(-x);
+	return l;
+}
+
+/**
+ * \brief Inverts the cumulative distribution within one cell of a table.
+ *
+ * The density is linear across the cell, so the cumulative distribution is
+ * quadratic; F0 + a t^2 + b t = u is solved for t in [0, 1], in the form
+ * that does not cancel.
+ *
+ * \param[in] c u minus the cumulative distribution at the cell's start.
+ * \param[in] f0 The density at the cell's start.
+ * \param[in] f1 The density at the cell's end.
+ * \param[in] h The width of the cell.
+ * \return The position within the cell, t.
+ */
+static inline double invert_cell(double c, double f0, double f1, double h) {
+	double a, b, root, t;
+
+	a = 0.5 * h * (f1 - f0);
+	b = h * f0;
+	root = b + sqrt(fmax(b*b + 4.0*a*c, 0.0));
+	t = (root > 0.0) ? 2.0*c / root : 0.0;
+	return (t > 1.0) ? 1.0 : t;
+}
+
+st_beta_dist *beta_dist_alloc(double alpha, double beta) {
+	st_beta_dist *d;
+	double lmax, l, hi, total;
+	long k, first, last;
+	int i;
+
+	if (!(alpha >= 1.0 && beta >= 1.0))
+		return NULL;
+
+	// find the range where the density is not negligible
+	lmax = -HUGE_VAL;
+	for (k = 0; k <= BETA_SCAN; ++k) {
+		l = beta_log_density((double)k / BETA_SCAN, alpha, beta);
+		if (l > lmax)
+			lmax = l;
+	}
+	first = BETA_SCAN;
+	last = 0;
+	for (k = 0; k <= BETA_SCAN; ++k) {
+		if (beta_log_density((double)k / BETA_SCAN, alpha, beta) >
+			lmax - BETA_CUTOFF) {
+
+			if (k < first)
+				first = k;
+			last = k;
+		}
+	}
+
+	d = (st_beta_dist*)malloc(sizeof(st_beta_dist));
+	d->lo = (first > 0) ? (double)(first - 1) / BETA_SCAN : 0.0;
+	hi = (last < BETA_SCAN) ? (double)(last + 1) / BETA_SCAN : 1.0;
+	d->h = (hi - d->lo) / BETA_CELLS;
+
+	// the density at the cell edges, and its integral by the trapezoid rule
+	// (which is exact for the interpolant)
+	for (i = 0; i <= BETA_CELLS; ++i)
+		d->f[i] = exp(beta_log_density(d->lo + i * d->h, alpha, beta) - lmax);
+	d->F[0] = 0.0;
+	for (i = 0; i < BETA_CELLS; ++i)
+		d->F[i+1] = d->F[i] + 0.5 * d->h * (d->f[i] + d->f[i+1]);
+	total = d->F[BETA_CELLS];
+	for (i = 0; i <= BETA_CELLS; ++i) {
+		d->f[i] /= total;
+		d->F[i] /= total;
+	}
+
+	// the guide table: cell guide[k] contains probability k / BETA_CELLS
+	i = 0;
+	for (k = 0; k < BETA_CELLS; ++k) {
+		while (i < BETA_CELLS - 1 && d->F[i+1] <= (double)k / BETA_CELLS)
+			++i;
+		d->guide[k] = i;
+	}
+
+	return d;
+}
+
+void beta_dist_free(st_beta_dist *d) {
+	free(d);
+}
+
+void beta_dist_quantile(const st_beta_dist *d, const double *u, double *x,
+	size_t n) {
+
+	size_t j;
+	int i;
+
+	for (j = 0; j < n; ++j) {
+		// the guide table leaves a cell or two to search
+		i = d->guide[(int)(u[j] * BETA_CELLS)];
+		while (i < BETA_CELLS - 1 && d->F[i+1] <= u[j])
+			++i;
+
+		x[j] = d->lo + d->h * (i + invert_cell(u[j] - d->F[i], d->f[i],
+			d->f[i+1], d->h));
+	}
+}
+
+void beta_dist_sample(const st_beta_dist *d, st_sampler *s, double *x,
+	size_t n) {
+
+	sampler_uniform(s, x, n);
+	beta_dist_quantile(d, x, x, n);
+}
+
+st_empirical_dist *empirical_dist_alloc(const double *x, const double *f,
+	int npoints) {
+
+	st_empirical_dist *d;
+	double total;
+	int i, k, ncells;
+
+	if (npoints < 2)
+		return NULL;
+	for (i = 0; i < npoints; ++i) {
+		if (!(f[i] >= 0.0) || (i > 0 && !(x[i] > x[i-1])))
+			return NULL;
+	}
+
+	// one allocation for the structure and its tables
+	ncells = npoints - 1;
+	d = (st_empirical_dist*)malloc(sizeof(st_empirical_dist) +
+		3*npoints*sizeof(double) + ncells*sizeof(int));
+	d->npoints = npoints;
+	d->x = (double*)(d + 1);
+	d->f = d->x + npoints;
+	d->F = d->f + npoints;
+	d->guide = (int*)(d->F + npoints);
+
+	// the trapezoid rule is exact for the interpolant
+	d->F[0] = 0.0;
+	for (i = 0; i < npoints; ++i) {
+		d->x[i] = x[i];
+		d->f[i] = f[i];
+		if (i > 0)
+			d->F[i] = d->F[i-1] + 0.5 * (x[i] - x[i-1]) * (f[i-1] + f[i]);
+	}
+	total = d->F[ncells];
+	if (!(total > 0.0)) {
+		free(d);
+		return NULL;
+	}
+	for (i = 0; i < npoints; ++i) {
+		d->f[i] /= total;
+		d->F[i] /= total;
+	}
+
+	// the guide table: cell guide[k] contains probability k / ncells
+	i = 0;
+	for (k = 0; k < ncells; ++k) {
+		while (i < ncells - 1 && d->F[i+1] <= (double)k / ncells)
+			++i;
+		d->guide[k] = i;
+	}
+
+	return d;
+}
+
+st_empirical_dist *empirical_dist_read(const char *filename) {
+	st_empirical_dist *d;
+	FILE *f;
+	char line[256];
+	double *x, *p, xk, pk;
+	int n, capacity;
+
+	f = fopen(filename, "r");
+	if (f == NULL)
+		return NULL;
+
+	n = 0;
+	capacity = 64;
+	x = (double*)malloc(capacity*sizeof(double));
+	p = (double*)malloc(capacity*sizeof(double));
+	while (fgets(line, sizeof(line), f) != NULL) {
+		if (line[strspn(line, " \t\r\n")] == '\0' || line[0] == '#')
+			continue;
+
+		if (sscanf(line, "%lf %lf", &xk, &pk) != 2) {
+			n = 0;
+			break;
+		}
+		if (n == capacity) {
+			capacity *= 2;
+			x = (double*)realloc(x, capacity*sizeof(double));
+			p = (double*)realloc(p, capacity*sizeof(double));
+		}
+		x[n] = xk;
+		p[n] = pk;
+		++n;
+	}
+	fclose(f);
+
+	d = empirical_dist_alloc(x, p, n);
+	free(x);
+	free(p);
+	return d;
+}
+
+void empirical_dist_free(st_empirical_dist *d) {
+	free(d);
+}
+
+void empirical_dist_quantile(const st_empirical_dist *d, const double *u,
+	double *x, size_t n) {
+
+	const int ncells = d->npoints - 1;
+	size_t j;
+	int i;
+
+	for (j = 0; j < n; ++j) {
+		i = d->guide[(int)(u[j] * ncells)];
+		while (i < ncells - 1 && d->F[i+1] <= u[j])
+			++i;
+
+		x[j] = d->x[i] + (d->x[i+1] - d->x[i]) * invert_cell(u[j] - d->F[i],
+			d->f[i], d->f[i+1], d->x[i+1] - d->x[i]);
+	}
+}
+
+void empirical_dist_sample(const st_empirical_dist *d, st_sampler *s,
+	double *x, size_t n) {
+
+	sampler_uniform(s, x, n);
+	empirical_dist_quantile(d, x, x, n);
+}
+
+void normal_truncate(double mean, double stdev, double *x, size_t n) {
+	const double a = -mean / stdev;
+	const double Phia = 0.5 * erfc(-a / M_SQRT2);
+	const double Qa = 0.5 * erfc(a / M_SQRT2);
+	double u;
+	size_t k;
+
+	if (!(stdev > 0.0))
+		return;
+
+	for (k = 0; k < n; ++k) {
+		if (x[k] > 0.0)
+			continue;
+
+		// uniform in (0, 1), then the upper tail beyond a: Phi^-1(1 - uQ(a))
+		u = 0.5 * erfc(-(x[k] - mean) / (stdev * M_SQRT2)) / Phia;
+		x[k] = mean - stdev * normal_quantile(u * Qa);
+		if (!(x[k] > 0.0))
+			x[k] = DBL_MIN;
+	}
+}
+
+void normal_to_lognormal(double mean, double stdev, double *x, size_t n) {
+	// the parameters of the underlying normal distribution
+	const double s2 = log1p((stdev / mean) * (stdev / mean));
+	const double s = sqrt(s2);
+	const double mu = log(mean) - 0.5 * s2;
+	size_t k;
+
+	if (!(stdev > 0.0))
+		return;
+
+	for (k = 0; k < n; ++k)
+		x[k] = exp(mu + s * ((x[k] - mean) / stdev));
+}
+
+int mvnormal_init(st_mvnormal *d, int dims, const double *mean,
+	const double *cov) {
+
+	double sum;
+	int i, j, k;
+
+	if (dims < 1 || dims > MVNORMAL_MAX_DIMS)
+		return -1;
+
+	d->dims = dims;
+	for (i = 0; i < MVNORMAL_MAX_DIMS; ++i)
+		for (j = 0; j < MVNORMAL_MAX_DIMS; ++j)
+			d->L[i][j] = 0.0;
+
+	// Cholesky-Banachiewicz, row by row
+	for (i = 0; i < dims; ++i) {
+		d->mean[i] = mean[i];
+		for (j = 0; j <= i; ++j) {
+			sum = cov[i*dims + j];
+			for (k = 0; k < j; ++k)
+				sum -= d->L[i][k] * d->L[j][k];
+
+			if (j < i)
+				d->L[i][j] = sum / d->L[j][j];
+			else if (sum > 0.0)
+				d->L[i][i] = sqrt(sum);
+			else
+				return -1;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * \brief mvnormal_transform() for a fixed number of variables.
+ *
+ * The variables are computed from the last to the first, so each reads
+ * only standard normal numbers that are not yet overwritten. With D fixed,
+ * the loops over the variables unroll and the loop over the samples
+ * vectorizes.
+ */
+template <int D>
+static void mvnormal_transform_d(const st_mvnormal *d, double *const *z,
+	size_t n) {
+
+	double x;
+	size_t k;
+	int i, j;
+
+	for (k = 0; k < n; ++k) {
+		for (i = D - 1; i >= 0; --i) {
+			x = d->mean[i];
+			for (j = 0; j <= i; ++j)
+				x += d->L[i][j] * z[j][k];
+			z[i][k] = x;
+		}
+	}
+}
+
+double mvnormal_stdev(const st_mvnormal *d, int i) {
+	double var = 0.0;
+	int j;
+
+	for (j = 0; j <= i; ++j)
+		var += d->L[i][j] * d->L[i][j];
+	return sqrt(var);
+}
+
+void mvnormal_transform(const st_mvnormal *d, double *const *z, size_t n) {
+	switch (d->dims) {
+	case 1:
+		mvnormal_transform_d<1>(d, z, n);
+		break;
+	case 2:
+		mvnormal_transform_d<2>(d, z, n);
+		break;
+	case 3:
+		mvnormal_transform_d<3>(d, z, n);
+		break;
+	default:
+		mvnormal_transform_d<MVNORMAL_MAX_DIMS>(d, z, n);
+		break;
+	}
+}
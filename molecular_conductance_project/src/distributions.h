@@ -0,0 +1,278 @@
+/*
+This work is licensed under the Creative Commons Attribution 3.0 United States
+License. To view a copy of this license, visit
+http://creativecommons.org/licenses/by/3.0/us/ or send a letter to Creative
+Commons, 444 Castro Street, Suite 900, Mountain View, California, 94041, USA.
+
+Copyright (C) 2013 Oak Ridge National Laboratory
+*/
+/**
+ * \file distributions.h
+ * \brief Prototypes for drawing from tabulated distributions in bulk.
+ *
+ * The sampler (see sampler.h) provides uniform and normal variates. The
+ * distributions here are set up once, as tables, and then map uniform
+ * variates to their own through the tables, a batch at a time. Each can be
+ * drawn from a sampler or applied to given uniform numbers (for example,
+ * Sobol points). Besides the beta distribution, a table can be read from a
+ * file of measured densities (an empirical distribution), so that any
+ * parameter can follow data instead of a normal distribution.
+ *
+ * Correlated normal variates are made the same way: the covariance matrix
+ * is factored once, and batches of independent standard normal numbers are
+ * then mapped through the factor. Normal numbers can also be mapped to
+ * positive distributions with the same average and spread (a truncated
+ * normal or a log-normal distribution), at a bounded cost per number.
+ *
+ * \author agent
+ * \date October 2026
+ */
+
+#ifndef __distributions_h__
+#define __distributions_h__
+
+#include <cstddef>
+#include "sampler.h"
+
+/// The number of cells in the table of a beta distribution.
+#define BETA_CELLS 1024
+
+/// The largest number of variables in a multivariate normal distribution.
+#define MVNORMAL_MAX_DIMS 4
+
+/**
+ * \brief A tabulated beta distribution.
+ *
+ * The density is tabulated at the edges of #BETA_CELLS equal cells, covering
+ * the range where it is not negligible, and interpolated linearly within
+ * each cell. The cumulative distribution of the interpolant is then
+ * quadratic in each cell and is inverted exactly, so the numbers drawn
+ * follow the interpolated density; it differs from the beta density by
+ * O(h^2) for cells of width h. The exception is an end where alpha or beta
+ * is below 2: the density's slope is infinite there, and the quantiles in
+ * the first (or last) cell are off by up to about 2e-4.
+ */
+typedef struct {
+	/// The start and width of the cells.
+	double lo, h;
+
+	/// The density at the cell edges (normalized over the cells).
+	double f[BETA_CELLS + 1];
+
+	/// The cumulative distribution at the cell edges.
+	double F[BETA_CELLS + 1];
+
+	/// For each of #BETA_CELLS equal ranges of the cumulative distribution,
+	/// the cell where it starts.
+	int guide[BETA_CELLS];
+} st_beta_dist;
+
+/**
+ * \brief Tabulates a beta distribution.
+ *
+ * The density must be bounded, so both parameters must be at least 1.
+ *
+ * \param[in] alpha The first shape parameter.
+ * \param[in] beta The second shape parameter.
+ * \return The distribution, or NULL if alpha < 1 or beta < 1.
+ */
+st_beta_dist *beta_dist_alloc(double alpha, double beta);
+
+/**
+ * \brief Frees a beta distribution.
+ *
+ * \param[in,out] d The distribution.
+ */
+void beta_dist_free(st_beta_dist *d);
+
+/**
+ * \brief Maps uniform numbers to the beta distribution (its quantile
+ *        function).
+ *
+ * \param[in] d The distribution.
+ * \param[in] u The uniform numbers, in [0, 1).
+ * \param[out] x The beta-distributed numbers (may be u).
+ * \param[in] n The number of numbers.
+ */
+void beta_dist_quantile(const st_beta_dist *d, const double *u, double *x,
+	size_t n);
+
+/**
+ * \brief Draws n beta-distributed numbers.
+ *
+ * \param[in] d The distribution.
+ * \param[in,out] s The sampler.
+ * \param[out] x The numbers.
+ * \param[in] n The number of numbers.
+ */
+void beta_dist_sample(const st_beta_dist *d, st_sampler *s, double *x,
+	size_t n);
+
+/**
+ * \brief A tabulated empirical distribution.
+ *
+ * The density is given at increasing points (not necessarily equally
+ * spaced) and interpolated linearly between them; it is zero outside. As
+ * with st_beta_dist, the cumulative distribution is inverted exactly in each
+ * cell, and a guide table finds the cell in O(1) on average.
+ */
+typedef struct {
+	/// The number of points (at least 2).
+	int npoints;
+
+	/// The points.
+	double *x;
+
+	/// The density at the points (normalized).
+	double *f;
+
+	/// The cumulative distribution at the points.
+	double *F;
+
+	/// For each of npoints - 1 equal ranges of the cumulative distribution,
+	/// the cell where it starts.
+	int *guide;
+} st_empirical_dist;
+
+/**
+ * \brief Tabulates an empirical distribution.
+ *
+ * \param[in] x The points, strictly increasing.
+ * \param[in] f The density at the points (need not be normalized).
+ * \param[in] npoints The number of points.
+ * \return The distribution, or NULL if there are fewer than 2 points, the
+ *         points do not increase, or the density is negative or zero
+ *         everywhere.
+ */
+st_empirical_dist *empirical_dist_alloc(const double *x, const double *f,
+	int npoints);
+
+/**
+ * \brief Reads an empirical distribution from a file.
+ *
+ * Each line holds a point and the density there, separated by white space;
+ * blank lines and lines starting with `#' are skipped. For a histogram, list
+ * the bin centers and the counts.
+ *
+ * \param[in] filename The file.
+ * \return The distribution, or NULL if the file cannot be read or does not
+ *         describe a distribution (see empirical_dist_alloc()).
+ */
+st_empirical_dist *empirical_dist_read(const char *filename);
+
+/**
+ * \brief Frees an empirical distribution.
+ *
+ * \param[in,out] d The distribution (may be NULL).
+ */
+void empirical_dist_free(st_empirical_dist *d);
+
+/**
+ * \brief Maps uniform numbers to the empirical distribution (its quantile
+ *        function).
+ *
+ * \param[in] d The distribution.
+ * \param[in] u The uniform numbers, in [0, 1).
+ * \param[out] x The numbers (may be u).
+ * \param[in] n The number of numbers.
+ */
+void empirical_dist_quantile(const st_empirical_dist *d, const double *u,
+	double *x, size_t n);
+
+/**
+ * \brief Draws n numbers from the empirical distribution.
+ *
+ * \param[in] d The distribution.
+ * \param[in,out] s The sampler.
+ * \param[out] x The numbers.
+ * \param[in] n The number of numbers.
+ */
+void empirical_dist_sample(const st_empirical_dist *d, st_sampler *s,
+	double *x, size_t n);
+
+/**
+ * \brief Maps normal numbers to the normal distribution truncated to
+ *        positive numbers.
+ *
+ * Positive numbers are kept. For each other number x, u = Phi(z) / Phi(a)
+ * is uniform in (0, 1), where z = (x - mean) / stdev, a = -mean / stdev,
+ * and Phi is the standard normal distribution function; it is mapped
+ * through the inverse distribution function of the truncated normal. The
+ * result is exactly the truncated normal distribution, with no numbers
+ * drawn or rejected, so the cost is bounded and the random number streams
+ * are unchanged. Nothing is done if stdev is 0.
+ *
+ * \param[in] mean The average of the normal distribution.
+ * \param[in] stdev Its standard deviation.
+ * \param[in,out] x The numbers.
+ * \param[in] n The number of numbers.
+ */
+void normal_truncate(double mean, double stdev, double *x, size_t n);
+
+/**
+ * \brief Maps normal numbers to the log-normal distribution with the same
+ *        average and standard deviation.
+ *
+ * The numbers are standardized and passed through exp() with the log-normal
+ * parameters s^2 = log(1 + (stdev/mean)^2) and mu = log(mean) - s^2/2.
+ * Nothing is done if stdev is 0.
+ *
+ * \param[in] mean The average of the distributions (positive).
+ * \param[in] stdev Their standard deviation.
+ * \param[in,out] x The numbers.
+ * \param[in] n The number of numbers.
+ */
+void normal_to_lognormal(double mean, double stdev, double *x, size_t n);
+
+/**
+ * \brief A multivariate normal distribution, with its covariance matrix
+ *        factored as L L^T (Cholesky).
+ */
+typedef struct {
+	/// The number of variables.
+	int dims;
+
+	/// The averages.
+	double mean[MVNORMAL_MAX_DIMS];
+
+	/// The lower-triangular factor of the covariance matrix.
+	double L[MVNORMAL_MAX_DIMS][MVNORMAL_MAX_DIMS];
+} st_mvnormal;
+
+/**
+ * \brief Sets up a multivariate normal distribution.
+ *
+ * \param[out] d The distribution.
+ * \param[in] dims The number of variables (1 to #MVNORMAL_MAX_DIMS).
+ * \param[in] mean The averages.
+ * \param[in] cov The covariance matrix, dims x dims in row-major order
+ *            (only the lower triangle is read).
+ * \return 0 on success; -1 if the matrix is not positive definite.
+ */
+int mvnormal_init(st_mvnormal *d, int dims, const double *mean,
+	const double *cov);
+
+/**
+ * \brief Maps independent standard normal numbers to the distribution.
+ *
+ * Variable i of sample k is mean[i] + sum_j L[i][j] z[j][k], computed in
+ * place.
+ *
+ * \param[in] d The distribution.
+ * \param[in,out] z One array per variable: the standard normal numbers on
+ *                  input; the variables on output.
+ * \param[in] n The number of samples.
+ */
+void mvnormal_transform(const st_mvnormal *d, double *const *z, size_t n);
+
+/**
+ * \brief Gets the standard deviation of one variable of a multivariate
+ *        normal distribution.
+ *
+ * \param[in] d The distribution.
+ * \param[in] i The variable.
+ * \return The standard deviation.
+ */
+double mvnormal_stdev(const st_mvnormal *d, int i);
+
+#endif
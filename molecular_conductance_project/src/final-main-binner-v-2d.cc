@@ -27,17 +27,30 @@ Copyright (C) 2013 Oak Ridge National Laboratory
  * only a few) counts are suppressed. The actual number of bins used is
  * output to standard error.
  *
+ * The input may be text (voltage and conductance on each line) or a binary
+ * sample stream (see sample-stream.h) with `V' and `G' columns; binary input
+ * is detected automatically.
+ *
+ * Optional arguments may be given before or after the required ones:
+ *    - `--format F' selects the output format: `text' (default), or `f64' /
+ *      `f32' for a binary stream with columns `V', `logG', and `count'. Each
+ *      frame holds one voltage bin. The header carries the input's model and
+ *      parameters, along with `nbin'.
+ *
  * \todo Add options to turn on/off bin suppression.
  *
  * \author Matthew G.\ Reuter
- * \date July 2012, May 2013
+ * \date July 2012, May 2013, October 2026
  */
 
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
 #include <cfloat>
+#include <cstring>
 #include <gsl/gsl_histogram2d.h>
+#include "sample-stream.h"
+#include "text-format.h"
 
 /**
  * \brief Main function for binning.
@@ -49,16 +62,42 @@ Copyright (C) 2013 Oak Ridge National Laboratory
  * \return Exit status; 0 for normal.
  */
 int main(int argc, char **argv) {
-	int nbin, ntrials, i, j, usedbin;
-	double t, mint, maxt, *logt, minv, maxv, *v;
+	int nbin, ntrials, i, j, usedbin, nargs, which[2];
+	double t, mint, maxt, *logt, minv, maxv, *v, *binv, *bint, *binc;
+	double *data[2], row[3];
+	const double *cols[3];
+	char *args[3];
+	bool binary;
+	en_format format;
+	st_stream_header in, out;
+	st_text_output *text;
 	gsl_histogram2d *h;
 
+	// pull out the optional arguments
+	format = FORMAT_TEXT;
+	nargs = 0;
+	for(i = 0; i < argc; ++i) {
+		if(strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+			if(stream_parse_format(argv[++i], &format)) {
+				fprintf(stderr, "Error: Unknown format: '%s'.\n", argv[i]);
+				return 0;
+			}
+		}
+		else if(nargs < 3)
+			args[nargs++] = argv[i];
+		else
+			++nargs;
+	}
+	argc = nargs;
+	argv = args;
+
 	// get the command-line arguments
 	if(argc != 3) {
 		fprintf(stderr, "Usage: ./final-v-2d-binner nbin ntrials\n" \
 			"   ntrials is the number of trials in the input data\n" \
 			"   nbin is the number of bins to use\n" \
-			"NOTE: The data is expected through stdin\n");
+			"   --format F is 'text' (default), 'f64', or 'f32'\n" \
+			"NOTE: The data is expected through stdin (text or binary)\n");
 		return 0;
 	}
 
@@ -77,12 +116,48 @@ int main(int argc, char **argv) {
 	// get the min and max values, store the logarithms
 	logt = (double*)malloc(ntrials*sizeof(double));
 	v = (double*)malloc(ntrials*sizeof(double));
+	binary = stream_is_binary(stdin);
+	if(binary) {
+		if(stream_read_header(stdin, &in)) {
+			fprintf(stderr, "Error: Malformed binary input.\n");
+			free(v);
+			free(logt);
+			return 0;
+		}
+
+		which[0] = stream_header_find(&in, "V");
+		which[1] = stream_header_find(&in, "G");
+		if(which[0] < 0 || which[1] < 0) {
+			fprintf(stderr, "Error: The input needs 'V' and 'G' columns.\n");
+			free(v);
+			free(logt);
+			return 0;
+		}
+
+		// read the conductances straight into logt; the logarithms are
+		// taken below
+		data[0] = v;
+		data[1] = logt;
+		if(stream_read_columns(stdin, &in, which, 2, data, ntrials) != ntrials) {
+			fprintf(stderr, "Error: The input has fewer than %d trials.\n",
+				ntrials);
+			free(v);
+			free(logt);
+			return 0;
+		}
+	}
+	else
+		stream_header_init(&in, "", 1);
+
 	mint = 1.0;
 	maxt = 0.0;
 	minv = DBL_MAX;
 	maxv = -DBL_MAX;
 	for(i = 0; i < ntrials; ++i) {
-		scanf("%le %le", v + i, &t);
+		if(binary)
+			t = logt[i];
+		else
+			scanf("%le %le", v + i, &t);
 
 		if(v[i] < minv)
 			minv = v[i];
@@ -109,6 +184,24 @@ int main(int argc, char **argv) {
 	// scale the bins so that the biggest bin value is 1
 	gsl_histogram2d_scale(h, 1.0 / gsl_histogram2d_max_val(h));
 
+	if(format != FORMAT_TEXT) {
+		out = in;
+		out.frame_rows = nbin;
+		out.ncols = 0;
+		stream_header_param(&out, "nbin", nbin);
+		stream_header_column(&out, "V", format);
+		stream_header_column(&out, "logG", format);
+		stream_header_column(&out, "count", format);
+		stream_write_header(stdout, &out);
+	}
+	binv = (double*)malloc(nbin*sizeof(double));
+	bint = (double*)malloc(nbin*sizeof(double));
+	binc = (double*)malloc(nbin*sizeof(double));
+	cols[0] = binv;
+	cols[1] = bint;
+	cols[2] = binc;
+	text = text_output_alloc(stdout);
+
 	// print it out
 	// count the number of bins with meaningful population
 	usedbin = 0;
@@ -134,15 +227,36 @@ int main(int argc, char **argv) {
 
 			// also have to scale the histogram count by the width of the bin and
 			// the total number of trials
-			printf("%.6e %.6e %.6e\n", 0.5*(maxv + minv), 0.5*(maxt + mint), t);
+			binv[j] = 0.5*(maxv + minv);
+			bint[j] = 0.5*(maxt + mint);
+			binc[j] = t;
+			if(format == FORMAT_TEXT) {
+				row[0] = binv[j];
+				row[1] = bint[j];
+				row[2] = binc[j];
+				text_output_row(text, row, 3, true);
+			}
+		}
+
+		if(format != FORMAT_TEXT) {
+			stream_write_frame(stdout, &out, cols, nbin);
+			continue;
 		}
 
 		// need a newline for plotting with gnuplot
-		printf("\n");
+		text_output_newline(text);
 	}
+	text_output_free(text);
+
+	if(format != FORMAT_TEXT)
+		stream_write_end(stdout);
 
 	// clean up
 	gsl_histogram2d_free(h);
+	free(binc);
+	free(bint);
+	free(binv);
+	free(v);
 	free(logt);
 	fprintf(stderr, "%d\n", usedbin);
 
@@ -14,84 +14,285 @@ Copyright (C) 2013 Oak Ridge National Laboratory
  * on the command-line and used to simulate conductance data. This data can
  * subsequently be binned into a histogram to test the fitting procedures.
  *
- * Two models are presently implemented:
+ * Two kinds of models are presently implemented:
  *    - Symmetric couplings (same coupling used for the left and right leads).
- *    - Asymmetric couplings (different couplings for the two leads).
+ *    - Asymmetric couplings (different couplings for the two leads), drawn
+ *      independently with the same standard deviation.
  *
- * There are seven required command-line arguments:
+ * There are ten required command-line arguments (eleven with asymmetric
+ * couplings):
  *    -# The model to use
  *       - `i' for the voltage-independent model
  *       - `s' for the single-site voltage-dependent model
  *       - `d' for the double-site voltage-dependent model
+ *       - `x' for the double-site model with the exact dI/dV (see
+ *         conductance.h)
+ *       - `ia', `sa', or `da' for the same with asymmetric couplings (see
+ *         conductance.h; double precision only)
+ *       - `c' for a chain of sites (see `--chain'; double precision only)
+ *       - `hi' or `hs' for a molecule in place of the single site of `i' or
+ *         `s' (see `--molecule'; double precision only)
  *    -# The number of conductance data points to simulate.
  *    -# The Fermi level of the system (eV)
  *    -# The standard deviation in site level energy (eV)
  *    -# The average site level energy (eV)
  *    -# The standard deviation in electrode-channel coupling (eV)
- *    -# The average coupling to both electrodes, in eV.
+ *    -# The average coupling to both electrodes, in eV; with asymmetric
+ *       couplings, the average coupling to one electrode followed by that to
+ *       the other.
+ *    -# The range of the applied bias, Vmin and Vmax (V).
+ *    -# The relative voltage drop for one electrode, eta.
+ *
+ * Optional arguments may be given before or after the required ones:
+ *    - `--threads N' splits the trials across N threads (default 1). Each
+ *      block of trials draws from its own random number stream (see
+ *      parallel.h), so the output is identical for any N.
+ *    - `--format F' selects the output format: `text' (default) for lines of
+ *      voltage and conductance, or `f64' / `f32' for a binary sample stream
+ *      (see sample-stream.h) with columns `V' and `G', one frame per block.
+ *    - `--histogram NBIN' bins the trials as they are simulated instead of
+ *      outputting them, and outputs an NBIN x NBIN histogram in voltage and
+ *      log10 conductance, in the same layout as final-binner-v-2d (the largest
+ *      bin is scaled to 1). Only the histogram is kept in memory. The voltage
+ *      range is [Vmin, Vmax]. The conductance range is the extent of the
+ *      simulated data, which takes an extra (output-free) pass over the
+ *      trials to find, unless it is given by
+ *    - `--grange LO HI', the range of log10 conductance to bin.
+ *    - `--sampler S' is `pseudo' (default) for pseudo-random parameters or
+ *      `sobol' for scrambled Sobol points (see sobol.h), which fill the
+ *      parameter space more evenly so histograms converge faster. Block b
+ *      uses its own stretch of the sequence, so the output still does not
+ *      depend on the number of threads. At most 2^32 trials.
+ *    - `--replica R' selects the Sobol scrambling (default 0). Runs with
+ *      different R are independent, and the spread of their results
+ *      estimates the error. Only with `--sampler sobol'.
+ *    - `--stratify NV' divides [Vmin, Vmax] into NV equal strata and gives
+ *      each exactly n / NV trials (give or take one), placed at random within
+ *      the stratum. When NV is a multiple of the number of voltage bins (NBIN
+ *      for `--histogram', or the binner's), every voltage column gets the
+ *      same number of trials, so the noise is even across the columns.
+ *    - `--rng NAME' selects the pseudo-random generator: `xoshiro'
+ *      (default), `pcg64', `philox', or `gsl:NAME' for a GSL generator such
+ *      as `gsl:mt19937' (see sampler.h). A GSL generator only supplies the
+ *      raw words, so its trials are not those of the original program; for
+ *      those, use
+ *    - `--legacy', which draws each trial's voltage, coupling, and level
+ *      energy in turn with gsl_rng_uniform() and gsl_ran_gaussian() from one
+ *      stream of GSL's default generator (set by GSL_RNG_TYPE), seeded with
+ *      0xFEEDFACE, as the original program did. The stream runs through the
+ *      blocks in order, so only one thread is allowed, and `--sampler
+ *      sobol', `--stratify', `--cov', and `--pdf' cannot be given.
+ *    - `--precision P' is `double' (default) or `single'. In single
+ *      precision the parameters are drawn, the conductances evaluated, and
+ *      (with `--histogram') the trials binned in single-precision
+ *      arithmetic, which handles twice as many trials per vector
+ *      instruction. The histograms differ from the double-precision ones by
+ *      the few trials that land near bin edges; accuracy-f32 measures this.
+ *    - `--cov LIST' draws the couplings and the level energy from a joint
+ *      normal distribution instead of independently. LIST is the upper
+ *      triangle of their covariance matrix (eV^2), row by row and separated
+ *      by commas, for the variables (gamma, epsilon), or (gammaL, gammaR,
+ *      epsilon) with asymmetric coupling; for example `0.0025,0.001,0.09'.
+ *      The averages are still gamma0 [gammaR0] and epsilon0, but dgamma and
+ *      depsilon are not used. The matrix is factored once (see
+ *      distributions.h).
+ *    - `--coupling D' is the distribution of the couplings: `normal'
+ *      (default), `truncated' (the normal distribution restricted to
+ *      positive couplings), or `lognormal' (with average gamma0 [gammaR0]
+ *      and standard deviation dgamma). Either keeps the couplings positive
+ *      when gamma0 / dgamma is small. With `--cov', the couplings' averages
+ *      and standard deviations come from the matrix, and the correlations
+ *      apply to the normal numbers before they are mapped.
+ *    - `--pdf NAME FILE' draws the parameter NAME (`gamma', `gammaR', or
+ *      `epsilon') from the measured distribution in FILE instead of a normal
+ *      distribution: lines of a value and the density there (for example,
+ *      bin centers and counts), interpolated linearly in between (see
+ *      distributions.h). The parameter's average and standard deviation
+ *      arguments are then not used, and `--cov' cannot be given. The option
+ *      may be repeated for different parameters.
+ *    - `--chain N BETA DBETA DSITE' sets up the chain model `c': N sites
+ *      (default 2) with normally distributed hoppings of average BETA (default
+ *      -3 eV, as in the double-site model) and standard deviation DBETA
+ *      (default 0). Each site's level energy is the trial's level energy
+ *      plus a normal offset with standard deviation DSITE (default 0). These
+ *      are drawn pseudo-randomly, even with `--sampler sobol'.
+ *    - `--molecule FILE DSITE DHOP' sets up the molecule models `hi' and
+ *      `hs': the Hamiltonian and the sites coupled to the electrodes are read
+ *      from FILE (see hamiltonian.h), and the trial's level energy is added
+ *      to every on-site energy. The Hamiltonian is decomposed once, unless
+ *      DSITE or DHOP is positive; then each trial's on-site energies and
+ *      nonzero hoppings get normal offsets with these standard deviations
+ *      (drawn pseudo-randomly, even with `--sampler sobol'), and each
+ *      trial's Hamiltonian is decomposed once.
+ *    - `--temperature TK' evaluates models `i', `s', `d', and `x' at TK
+ *      kelvin (default 0) instead of zero temperature: each transmission is
+ *      averaged over the Fermi window of the electrodes (see conductance.h;
+ *      double precision only). The trials are drawn as at zero temperature.
+ *    - `--trace NV' outputs the current-voltage trace of each junction
+ *      instead of a conductance at one voltage: the junction (gamma,
+ *      epsilon) of each trial is evaluated at NV evenly spaced voltages from
+ *      Vmin to Vmax, and its drawn voltage is not used. The conductance
+ *      dI/dV comes from the model, and the current I (in units of G0 V) is
+ *      its integral from V = 0 (see conductance_current()). In text, each
+ *      junction is NV lines of voltage, current, and conductance, followed
+ *      by a blank line; in a binary format, each junction is one frame of NV
+ *      rows with columns `I' and `G', and the voltages are given by the
+ *      header parameters `nV', `Vmin', and `Vmax'. The junctions are
+ *      simulated in blocks of #TRACES_PER_BLOCK (see simulate_traces()),
+ *      and each thread holds the traces of one block, 16 NV bytes per
+ *      junction. Models `i', `s', `d', and `x' only, at zero temperature
+ *      and in double precision, and not with `--histogram'.
  *
  * \author Gaibo Zhang and Matthew G.\ Reuter
- * \date August 2013; March 2014
+ * \date August 2013; March 2014; October 2026
  */
 
-#include <iostream>
 #include <cstdio>
 #include <cstdlib>
-#include <gsl/gsl_rng.h>
-#include <gsl/gsl_randist.h>
-#include <complex>
+#include <cstring>
+#include <cfloat>
+#include <gsl/gsl_histogram2d.h>
+#include "parallel.h"
+#include "sampler.h"
+#include "sample-stream.h"
+#include "simulation.h"
+#include "text-format.h"
+
+/**
+ * \brief What to do with the simulated trials.
+ */
+typedef enum {
+	/// Output every trial.
+	OUTPUT_SAMPLES,
 
+	/// Find the range of the (log10) conductances.
+	OUTPUT_RANGE,
+
+	/// Bin the trials.
+	OUTPUT_HISTOGRAM,
+
+	/// Output the trace of every trial's junction.
+	OUTPUT_TRACES
+} en_output;
 
 /**
- * \brief Samples from a normal distribution with the given mean and standard
- *        deviation.
+ * \brief Struct for passing the simulation parameters to the block
+ *        functions.
+ */
+typedef struct {
+	/// The trial parameters (see the command-line arguments).
+	st_trials trials;
+
+	/// One random number sampler per slot.
+	st_sampler **r;
+
+	/// What to do with the trials.
+	en_output output;
+
+	/// The output format.
+	en_format format;
+
+	/// The header of the binary stream (binary formats only).
+	st_stream_header header;
+
+	/// One text buffer per slot (text format only, except with
+	/// OUTPUT_TRACES).
+	char **buf;
+
+	/// The size of each slot's text buffer, which grows as needed.
+	size_t *cap;
+
+	/// The amount of output in each slot: bytes of text, or binary rows
+	/// (traces with OUTPUT_TRACES).
+	size_t *len;
+
+	/// The text output of the traces (text format with OUTPUT_TRACES only).
+	st_text_output *text;
+
+	/// One pair of voltage and conductance arrays per slot (binary formats
+	/// only); with OUTPUT_TRACES, the currents and conductances of each
+	/// trace in turn (any format).
+	double **V, **GV;
+
+	/// The voltages of the traces (OUTPUT_TRACES only).
+	double *Vtrace;
+
+	/// The number of voltages in each trace.
+	long nV;
+
+	/// The voltage grid version of the model (OUTPUT_TRACES only).
+	conductance_grid_fn grid;
+
+	/// The smallest and largest log10 conductance seen by each slot
+	/// (OUTPUT_RANGE only).
+	double *gmin, *gmax;
+
+	/// One histogram per slot (OUTPUT_HISTOGRAM only).
+	gsl_histogram2d **hist;
+} st_sim;
+
+/**
+ * \brief Simulates one block of trials into the slot's output buffers.
  *
- * \param[in] mean The distribution's average.
- * \param[in] stdev The distribution's standard deviation.
- * \param[in] r The internal workspace for GSL's random number generation.
- * \return The random number.
+ * \param[in] block The block index.
+ * \param[in] slot The slot (thread) workspace to use.
+ * \param[in] params The st_sim parameters.
  */
-double normal_random_variable(double mean, double stdev, gsl_rng *r);
+void simulate_block(long block, int slot, void *params);
 
 /**
- * \brief Landauer conductance for the voltage-independent model; symmetric
- *        coupling.
- * 
- * \param[in] V The applied voltage.
- * \param[in] gamma The channel-lead coupling.
- * \param[in] epsilon The channel's level energy.
- * \param[in] eta The relative voltage drop between the two electrodes.
- * \param[in] EF The Fermi energy.
- * \return The conductance, in units of G0.
+ * \brief Writes a simulated block to standard out.
+ *
+ * \param[in] block The block index.
+ * \param[in] slot The slot (thread) workspace holding the block.
+ * \param[in] params The st_sim parameters.
  */
-double conductance_i(double V, double gamma, double epsilon, double eta,
-	double EF);
+void write_block(long block, int slot, void *params);
 
 /**
- * \brief Landauer conductance for the single-site voltage-dependent model;
- *        symmetric coupling.
- * 
- * \param[in] V The applied voltage.
- * \param[in] gamma The channel-lead coupling.
- * \param[in] epsilon The channel's level energy.
- * \param[in] EF The Fermi energy.
- * \return The conductance, in units of G0.
+ * \brief Struct identifying the slot that store_batch() writes into.
  */
-double conductance_s(double V, double gamma, double epsilon, double eta,
-	double EF);
+typedef struct {
+	/// The simulation.
+	st_sim *sim;
+
+	/// The slot.
+	int slot;
+} st_slot_output;
 
 /**
- * \brief Landauer conductance for the double-site voltage-dependent model;
- *        symmetric coupling.
- * 
- * \param[in] V The applied voltage.
- * \param[in] gamma The channel-lead coupling.
- * \param[in] epsilon The channel's level energy.
- * \param[in] EF The Fermi energy.
- * \return The conductance, in units of G0.
+ * \brief Stores a batch of trials in a slot's output buffers.
+ *
+ * \param[in] V The voltages.
+ * \param[in] G The conductances.
+ * \param[in] offset The batch's offset within the block.
+ * \param[in] m The number of trials in the batch.
+ * \param[in] ctx The st_slot_output.
  */
-double conductance_d(double V, double gamma, double epsilon, double eta,
-	double EF);
+void store_batch(const double *V, const double *G, long offset, long m,
+	void *ctx);
+
+/**
+ * \brief Stores a block of traces in a slot's output arrays.
+ *
+ * \param[in] I The currents; I[k*m + j] is junction j at voltage k.
+ * \param[in] G The conductances, laid out as I.
+ * \param[in] m The number of junctions in the block.
+ * \param[in] ctx The st_slot_output.
+ */
+void store_traces(const double *I, const double *G, long m, void *ctx);
+
+/**
+ * \brief Records a `--cov' matrix in a stream header.
+ *
+ * Each entry of the upper triangle becomes a parameter named after its two
+ * variables, such as `cov_g_eps' (or `cov_gL_gR' with asymmetric coupling).
+ *
+ * \param[in,out] h The header.
+ * \param[in] asym Whether the coupling is asymmetric.
+ * \param[in] cov The covariance matrix, in row-major order.
+ */
+void header_covariance(st_stream_header *h, bool asym, const double *cov);
 
 /**
  * \brief Main function for simulating a histogram.
@@ -104,69 +305,330 @@ double conductance_d(double V, double gamma, double epsilon, double eta,
  * \return Exit status; 0 for normal.
  */
 int main(int argc, char **argv) {
-	const gsl_rng_type *T;
-	gsl_rng *r;
-     
-	int i, n;
+	long i, n, nblocks, ntrace, nV;
+	int nthreads, nargs, nbin;
+	en_format format;
+	en_sampling sampling;
+	en_coupling coupling;
+	unsigned long replica;
+	st_rng rng;
+	long nstrata;
+	bool single;
+	bool grange;
+	bool legacy, replica_given;
+	const char *covarg;
+	double covmat[9], mean[3];
+	st_mvnormal cov;
+	st_empirical_dist *pdf_gamma, *pdf_gammaR, *pdf_epsilon;
+	st_empirical_dist **pdf;
+	double gmin, gmax;
+	char *args[12];
 	double EF;
 	double depsilon;
 	double epsilon0;
 	double dgamma;
-	double gamma0;
+	double gamma0, gammaR0;
 	double Vmin, Vmax;
 	double eta;
-	double gamma, epsilon, V, GV;
-	double (*cond)(double, double, double, double, double);
+	bool asym, chain_model, chained;
+	st_chain chain;
+	st_hamiltonian *hamiltonian;
+	st_molecule molecule;
+	double temperature;
+	conductance_batch_fn cond;
+	conductance_batch_a_fn cond_a;
+	conductance_batch_h_fn cond_h;
+	st_sim sim;
+	st_blocks blocks;
+
+	// pull out the optional arguments
+	nthreads = 1;
+	format = FORMAT_TEXT;
+	sampling = SAMPLING_PSEUDO;
+	coupling = COUPLING_NORMAL;
+	replica = 0;
+	parse_rng("xoshiro", &rng);
+	nstrata = 0;
+	single = false;
+	legacy = false;
+	replica_given = false;
+	covarg = NULL;
+	pdf_gamma = pdf_gammaR = pdf_epsilon = NULL;
+	chained = false;
+	chain.nsites = 2;
+	chain.beta = -3.0;
+	chain.dbeta = 0.0;
+	chain.dsite = 0.0;
+	hamiltonian = NULL;
+	molecule.dsite = molecule.dhop = 0.0;
+	temperature = 0.0;
+	nV = 0;
+	nbin = 0;
+	grange = false;
+	gmin = gmax = 0.0;
+	nargs = 0;
+	for (i = 0; i < argc; ++i) {
+		if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+			nthreads = atoi(argv[++i]);
+			if (nthreads < 1) {
+				fprintf(stderr, "Error: Use at least one thread.\n");
+				return 0;
+			}
+		}
+		else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+			if (stream_parse_format(argv[++i], &format)) {
+				fprintf(stderr, "Error: Unknown format: '%s'.\n", argv[i]);
+				return 0;
+			}
+		}
+		else if (strcmp(argv[i], "--sampler") == 0 && i + 1 < argc) {
+			if (parse_sampling(argv[++i], &sampling)) {
+				fprintf(stderr, "Error: Unknown sampler: '%s'.\n", argv[i]);
+				return 0;
+			}
+		}
+		else if (strcmp(argv[i], "--replica") == 0 && i + 1 < argc) {
+			replica = strtoul(argv[++i], NULL, 10);
+			replica_given = true;
+		}
+		else if (strcmp(argv[i], "--rng") == 0 && i + 1 < argc) {
+			if (parse_rng(argv[++i], &rng)) {
+				fprintf(stderr, "Error: Unknown generator: '%s'.\n", argv[i]);
+				return 0;
+			}
+		}
+		else if (strcmp(argv[i], "--legacy") == 0)
+			legacy = true;
+		else if (strcmp(argv[i], "--stratify") == 0 && i + 1 < argc) {
+			nstrata = atol(argv[++i]);
+			if (nstrata < 1) {
+				fprintf(stderr, "Error: Use at least one voltage stratum.\n");
+				return 0;
+			}
+		}
+		else if (strcmp(argv[i], "--precision") == 0 && i + 1 < argc) {
+			if (parse_precision(argv[++i], &single)) {
+				fprintf(stderr, "Error: Unknown precision: '%s'.\n", argv[i]);
+				return 0;
+			}
+		}
+		else if (strcmp(argv[i], "--cov") == 0 && i + 1 < argc)
+			covarg = argv[++i];
+		else if (strcmp(argv[i], "--pdf") == 0 && i + 2 < argc) {
+			if (strcmp(argv[++i], "gamma") == 0)
+				pdf = &pdf_gamma;
+			else if (strcmp(argv[i], "gammaR") == 0)
+				pdf = &pdf_gammaR;
+			else if (strcmp(argv[i], "epsilon") == 0)
+				pdf = &pdf_epsilon;
+			else {
+				fprintf(stderr, "Error: Unknown parameter: '%s'.\n", argv[i]);
+				return 0;
+			}
+			empirical_dist_free(*pdf);
+			*pdf = empirical_dist_read(argv[++i]);
+			if (*pdf == NULL) {
+				fprintf(stderr, "Error: Cannot read a distribution from " \
+					"'%s'.\n", argv[i]);
+				return 0;
+			}
+		}
+		else if (strcmp(argv[i], "--chain") == 0 && i + 4 < argc) {
+			chain.nsites = atoi(argv[++i]);
+			chain.beta = atof(argv[++i]);
+			chain.dbeta = atof(argv[++i]);
+			chain.dsite = atof(argv[++i]);
+			chained = true;
+			if (chain.nsites < 2 || chain.dbeta < 0.0 || chain.dsite < 0.0) {
+				fprintf(stderr, "Error: The chain needs at least two sites " \
+					"and nonnegative standard deviations.\n");
+				return 0;
+			}
+		}
+		else if (strcmp(argv[i], "--molecule") == 0 && i + 3 < argc) {
+			hamiltonian_free(hamiltonian);
+			hamiltonian = hamiltonian_read(argv[++i]);
+			if (hamiltonian == NULL) {
+				fprintf(stderr, "Error: Cannot read a Hamiltonian from " \
+					"'%s'.\n", argv[i]);
+				return 0;
+			}
+			molecule.dsite = atof(argv[++i]);
+			molecule.dhop = atof(argv[++i]);
+			if (molecule.dsite < 0.0 || molecule.dhop < 0.0) {
+				fprintf(stderr, "Error: The molecule's standard deviations " \
+					"must be nonnegative.\n");
+				return 0;
+			}
+		}
+		else if (strcmp(argv[i], "--temperature") == 0 && i + 1 < argc) {
+			temperature = atof(argv[++i]);
+			if (temperature < 0.0) {
+				fprintf(stderr, "Error: The temperature must be " \
+					"nonnegative.\n");
+				return 0;
+			}
+		}
+		else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+			nV = atol(argv[++i]);
+			if (nV < 2) {
+				fprintf(stderr, "Error: A trace needs at least two " \
+					"voltages.\n");
+				return 0;
+			}
+		}
+		else if (strcmp(argv[i], "--coupling") == 0 && i + 1 < argc) {
+			if (parse_coupling(argv[++i], &coupling)) {
+				fprintf(stderr, "Error: Unknown coupling distribution: " \
+					"'%s'.\n", argv[i]);
+				return 0;
+			}
+		}
+		else if (strcmp(argv[i], "--histogram") == 0 && i + 1 < argc) {
+			nbin = atoi(argv[++i]);
+			if (nbin < 1) {
+				fprintf(stderr, "Error: Use at least one bin.\n");
+				return 0;
+			}
+		}
+		else if (strcmp(argv[i], "--grange") == 0 && i + 2 < argc) {
+			gmin = atof(argv[++i]);
+			gmax = atof(argv[++i]);
+			grange = true;
+			if (gmin >= gmax) {
+				fprintf(stderr, "Error: The conductance range must have LO < " \
+					"HI.\n");
+				return 0;
+			}
+		}
+		else if (nargs < 12)
+			args[nargs++] = argv[i];
+		else
+			++nargs;
+	}
+	argc = nargs;
+	argv = args;
 
-	if (argc != 11) {
+	// an 'a' after the model selects asymmetric coupling, which takes an
+	// extra argument
+	asym = argc > 1 && argv[1][0] != '\0' && strcmp(argv[1] + 1, "a") == 0;
+
+	if (argc != (asym ? 12 : 11)) {
 		fprintf(stderr, "Usage error: ./final-sim-v-2d model n EF depsilon " \
-			"epsilon0 dgamma gamma0 Vmin Vmax eta\n" \
-			"   model is the model to use: 'i', 's', or 'd'\n" \
+			"epsilon0 dgamma gamma0 [gammaR0] Vmin Vmax eta\n" \
+			"   model is the model to use: 'i', 's', or 'd'; 'x' for 'd' " \
+				"with the exact dI/dV; 'ia', 'sa', or 'da' for asymmetric " \
+				"coupling; 'c' for a chain; 'hi' or 'hs' for a molecule\n" \
 			"   n is the number of trials\n" \
 			"   EF is the Fermi level (eV)\n" \
 			"   depsilon is the standard deviation in site level energy (eV)\n" \
 			"   epsilon0 is the average site level energy (eV)\n" \
 			"   dgamma is the standard deviation in the coupling (eV)\n" \
 			"   gamma0 is the average coupling for one electrode (eV)\n" \
+			"   gammaR0 is the average coupling for the other electrode " \
+				"(eV; asymmetric models only)\n" \
 			"   Vmin is the lower bound of the applied bias range (V)\n" \
 			"   Vmax is the upper bound of the applied bias range (V)\n" \
 			"   eta is the relative voltage drop for one electrode\n" \
-			"\n   NOTE: symmetric coupling is assumed.\n");
+			"\n   Options:\n" \
+			"   --threads N splits the trials across N threads\n" \
+			"   --format F is 'text' (default), 'f64', or 'f32'\n" \
+			"   --histogram NBIN outputs an NBIN x NBIN histogram instead of " \
+				"the trials\n" \
+			"   --grange LO HI is the log10 conductance range for --histogram\n" \
+			"   --sampler S is 'pseudo' (default) or 'sobol'\n" \
+			"   --replica R selects the Sobol scrambling\n" \
+			"   --rng NAME is 'xoshiro' (default), 'pcg64', 'philox', or " \
+				"'gsl:NAME'\n" \
+			"      ('gsl:NAME' is not bit-compatible with the original " \
+				"output)\n" \
+			"   --legacy draws the trials as the original program did " \
+				"(one thread)\n" \
+			"   --stratify NV gives each of NV voltage strata the same number " \
+				"of trials\n" \
+			"   --precision P is 'double' (default) or 'single'\n" \
+			"   --cov LIST is the covariance of (gamma[L], [gammaR,] " \
+				"epsilon), upper triangle\n" \
+			"   --coupling D is 'normal' (default), 'truncated', or " \
+				"'lognormal'\n" \
+			"   --pdf NAME FILE draws gamma, gammaR, or epsilon from a " \
+				"measured distribution\n" \
+			"   --chain N BETA DBETA DSITE sets the sites of model 'c'\n" \
+			"   --molecule FILE DSITE DHOP sets the molecule of models 'hi' " \
+				"and 'hs'\n" \
+			"   --temperature TK evaluates models 'i', 's', 'd', and 'x' at " \
+				"TK kelvin\n" \
+			"   --trace NV outputs each junction's current and conductance " \
+				"at NV voltages\n" \
+			"\n   NOTE: symmetric coupling is assumed unless the model ends " \
+				"in 'a'.\n");
 		return 0;
 	}
 
 	// model
-	switch(*argv[1]) {
-	case 'i':
-		cond = conductance_i;
-		break;
-	case 's':
-		cond = conductance_s;
-		break;
-	case 'd':
-		cond = conductance_d;
-		break;
-	default:
-		fprintf(stderr, "Error: Unknown model: '%c'.\n", *argv[1]);
+	chain_model = strcmp(argv[1], "c") == 0;
+	cond_h = NULL;
+	if (argv[1][0] == 'h' && argv[1][1] != '\0' && argv[1][2] == '\0')
+		cond_h = select_model_h(argv[1][1]);
+	cond = (chain_model || cond_h != NULL) ? NULL : select_model(*argv[1]);
+	cond_a = asym ? select_model_a(*argv[1]) : NULL;
+	if ((cond == NULL && !chain_model && cond_h == NULL) ||
+		(asym && cond_a == NULL) ||
+		(!asym && cond_h == NULL && argv[1][1] != '\0')) {
+
+		fprintf(stderr, "Error: Unknown model: '%s'.\n", argv[1]);
+		return 0;
+	}
+	if ((asym || chain_model || cond_h != NULL) && single) {
+		fprintf(stderr, "Error: The %s only implemented in double " \
+			"precision.\n", asym ? "asymmetric models are" :
+			(chain_model ? "chain model is" : "molecule models are"));
 		return 0;
 	}
-	n = atoi(argv[2]);
+	if (chained && !chain_model) {
+		fprintf(stderr, "Error: --chain needs model 'c'.\n");
+		return 0;
+	}
+	if ((hamiltonian != NULL) != (cond_h != NULL)) {
+		fprintf(stderr, "Error: --molecule goes with models 'hi' and " \
+			"'hs', which need it.\n");
+		return 0;
+	}
+	if (temperature > 0.0 && (asym || chain_model || cond_h != NULL ||
+		single)) {
+
+		fprintf(stderr, "Error: --temperature goes with models 'i', 's', " \
+			"'d', and 'x' in double precision.\n");
+		return 0;
+	}
+	if (nV > 0 && (asym || chain_model || cond_h != NULL || single ||
+		temperature > 0.0 || nbin > 0)) {
+
+		fprintf(stderr, "Error: --trace goes with models 'i', 's', 'd', and " \
+			"'x' at zero temperature in double precision, without " \
+			"--histogram.\n");
+		return 0;
+	}
+	molecule.h = hamiltonian;
+	n = atol(argv[2]);
 	EF = atof(argv[3]);
 	depsilon = atof(argv[4]);
 	epsilon0 = atof(argv[5]);
 	dgamma = atof(argv[6]);
 	gamma0 = atof(argv[7]);
-	Vmin = atof(argv[8]);
-	Vmax = atof(argv[9]);
-	eta = atof(argv[10]);
+	gammaR0 = asym ? atof(argv[8]) : gamma0;
+	Vmin = atof(argv[asym ? 9 : 8]);
+	Vmax = atof(argv[asym ? 10 : 9]);
+	eta = atof(argv[asym ? 11 : 10]);
 
 	if (depsilon <= 0.0 || dgamma <= 0.0) {
 		fprintf(stderr, "Error: standard deviations must be positive.\n");
 		return 0;
 	}
 
-	if (gamma0 <= 0.0) {
-		fprintf(stderr, "Error: gamma0 must be positive.\n");
+	if (gamma0 <= 0.0 || gammaR0 <= 0.0) {
+		fprintf(stderr, "Error: %s must be positive.\n",
+			asym ? "gamma0 and gammaR0" : "gamma0");
 		return 0;
 	}
 
@@ -175,9 +637,11 @@ int main(int argc, char **argv) {
 		return 0;
 	}
 
-	if (gamma0 / dgamma < 4.0) {
+	if (coupling == COUPLING_NORMAL && pdf_gamma == NULL &&
+		(gamma0 / dgamma < 4.0 || gammaR0 / dgamma < 4.0)) {
+
 		fprintf(stderr, "Warning: The model assumes gamma0 / dgamma >> 0; " \
-			"bigger than 4, in practice.\n");
+			"bigger than 4, in practice (or use --coupling).\n");
 	}
 	
 	if (Vmin > Vmax) {
@@ -186,100 +650,427 @@ int main(int argc, char **argv) {
 		return 0;
 	}
 
+	if (replica_given && sampling != SAMPLING_SOBOL) {
+		fprintf(stderr, "Error: --replica goes with --sampler sobol.\n");
+		return 0;
+	}
+
+	if (sampling == SAMPLING_SOBOL && n > 4294967296L) {
+		fprintf(stderr, "Error: Sobol sampling supports at most 2^32 " \
+			"trials.\n");
+		return 0;
+	}
+
+	if (nstrata > 0 && nbin > 0 && nstrata % nbin != 0) {
+		fprintf(stderr, "Warning: NV is not a multiple of NBIN; the voltage " \
+			"columns will not get equal numbers of trials.\n");
+	}
+
+	if (pdf_gammaR != NULL && !asym) {
+		fprintf(stderr, "Error: gammaR needs an asymmetric model.\n");
+		return 0;
+	}
+
+	if (covarg != NULL && (pdf_gamma != NULL || pdf_gammaR != NULL ||
+		pdf_epsilon != NULL)) {
+
+		fprintf(stderr, "Error: --cov cannot be combined with --pdf.\n");
+		return 0;
+	}
+
+	if (covarg != NULL) {
+		mean[0] = gamma0;
+		mean[1] = asym ? gammaR0 : epsilon0;
+		mean[2] = epsilon0;
+		if (parse_covariance(covarg, asym ? 3 : 2, covmat)) {
+			fprintf(stderr, "Error: --cov needs %d comma-separated numbers.\n",
+				asym ? 6 : 3);
+			return 0;
+		}
+		if (mvnormal_init(&cov, asym ? 3 : 2, mean, covmat)) {
+			fprintf(stderr, "Error: The covariance matrix must be positive " \
+				"definite.\n");
+			return 0;
+		}
+	}
+
 	if (eta > 1.0 || eta < 0.0) {
 		fprintf(stderr, "Error: eta is a relative voltage drop on one side; " \
 			"0 <= eta <= 1.\n");
 		return 0;
 	}
 
-	// Setup the GSL random number generator
-	gsl_rng_env_setup();
-	T = gsl_rng_default;
-	r = gsl_rng_alloc(T);
+	if (legacy && (nthreads > 1 || sampling == SAMPLING_SOBOL ||
+		nstrata > 0 || covarg != NULL || pdf_gamma != NULL ||
+		pdf_gammaR != NULL || pdf_epsilon != NULL)) {
+
+		fprintf(stderr, "Error: --legacy uses one thread, and cannot be " \
+			"combined with --sampler sobol, --stratify, --cov, or --pdf.\n");
+		return 0;
+	}
+	if (legacy)
+		sampling = SAMPLING_LEGACY;
+
+	// each block of trials gets its own stream
+	sim.trials.cond = cond;
+	sim.trials.cond_f = single ? select_model_f(*argv[1]) : NULL;
+	sim.trials.cond_a = cond_a;
+	sim.trials.chain = chain_model ? &chain : NULL;
+	sim.trials.cond_h = cond_h;
+	sim.trials.molecule = (cond_h != NULL) ? &molecule : NULL;
+	sim.trials.cond_t = (temperature > 0.0) ? select_model_t(*argv[1]) :
+		NULL;
+	sim.trials.kT = BOLTZMANN*temperature;
+	sim.trials.cov = (covarg != NULL) ? &cov : NULL;
+	sim.trials.coupling = coupling;
+	sim.trials.pdf_gamma = pdf_gamma;
+	sim.trials.pdf_gammaR = pdf_gammaR;
+	sim.trials.pdf_epsilon = pdf_epsilon;
+	sim.trials.n = n;
+	sim.trials.EF = EF;
+	sim.trials.depsilon = depsilon;
+	sim.trials.epsilon0 = epsilon0;
+	sim.trials.dgamma = dgamma;
+	sim.trials.gamma0 = gamma0;
+	sim.trials.gammaR0 = gammaR0;
+	sim.trials.Vmin = Vmin;
+	sim.trials.Vmax = Vmax;
+	sim.trials.eta = eta;
+	sim.trials.sampling = sampling;
+	sim.trials.replica = replica;
+	sim.trials.nstrata = nstrata;
+	sim.trials.legacy = NULL;
+	if (legacy) {
+		gsl_rng_env_setup();
+		sim.trials.legacy = gsl_rng_alloc(gsl_rng_default);
+	}
+	sim.output = (nbin > 0) ? OUTPUT_HISTOGRAM : OUTPUT_SAMPLES;
+	sim.format = format;
+	sim.nV = nV;
+	sim.Vtrace = NULL;
+	sim.grid = NULL;
+	nblocks = count_blocks(n);
+	ntrace = (n < TRACES_PER_BLOCK) ? n : TRACES_PER_BLOCK;
+	if (nV > 0) {
+		sim.output = OUTPUT_TRACES;
+		nblocks = (n + TRACES_PER_BLOCK - 1) / TRACES_PER_BLOCK;
+		sim.grid = select_model_grid(*argv[1]);
+		sim.Vtrace = (double*)malloc(nV*sizeof(double));
+		for (i = 0; i < nV; ++i)
+			sim.Vtrace[i] = Vmin + i*(Vmax - Vmin)/(nV - 1);
+	}
+	sim.r = (st_sampler**)malloc(nthreads*sizeof(st_sampler*));
+	sim.buf = (char**)malloc(nthreads*sizeof(char*));
+	sim.cap = (size_t*)malloc(nthreads*sizeof(size_t));
+	sim.len = (size_t*)malloc(nthreads*sizeof(size_t));
+	sim.text = NULL;
+	if (sim.output == OUTPUT_TRACES && format == FORMAT_TEXT)
+		sim.text = text_output_alloc(stdout);
+	sim.V = (double**)malloc(nthreads*sizeof(double*));
+	sim.GV = (double**)malloc(nthreads*sizeof(double*));
+	sim.gmin = (double*)malloc(nthreads*sizeof(double));
+	sim.gmax = (double*)malloc(nthreads*sizeof(double));
+	sim.hist = (gsl_histogram2d**)malloc(nthreads*sizeof(gsl_histogram2d*));
+	for (i = 0; i < nthreads; ++i) {
+		sim.r[i] = sampler_alloc_rng(&rng);
+		sim.buf[i] = NULL;
+		sim.cap[i] = 0;
+		sim.V[i] = sim.GV[i] = NULL;
+		sim.hist[i] = NULL;
+
+		// the histograms are allocated once the range is known
+		if (sim.output == OUTPUT_TRACES) {
+			sim.V[i] = (double*)malloc(ntrace*nV*sizeof(double));
+			sim.GV[i] = (double*)malloc(ntrace*nV*sizeof(double));
+			if (sim.V[i] == NULL || sim.GV[i] == NULL) {
+				fprintf(stderr, "Error: Not enough memory for %ld traces " \
+					"of %ld voltages per thread.\n", ntrace, nV);
+				return 0;
+			}
+		}
+		else if (sim.output == OUTPUT_SAMPLES && format == FORMAT_TEXT) {
+			// "-x.xxxxxx -x.xxxxxx\n", with room for larger voltages; see
+			// store_batch() for the rest
+			sim.cap[i] = TRIALS_PER_BLOCK*64;
+			sim.buf[i] = (char*)malloc(sim.cap[i]);
+		}
+		else if (sim.output == OUTPUT_SAMPLES) {
+			sim.V[i] = (double*)malloc(TRIALS_PER_BLOCK*sizeof(double));
+			sim.GV[i] = (double*)malloc(TRIALS_PER_BLOCK*sizeof(double));
+		}
+	}
+
+	if (format != FORMAT_TEXT) {
+		stream_header_init(&sim.header, argv[1],
+			(sim.output == OUTPUT_HISTOGRAM) ? nbin :
+			((sim.output == OUTPUT_TRACES) ? nV : TRIALS_PER_BLOCK));
+		stream_header_param(&sim.header, "n", n);
+		stream_header_param(&sim.header, "EF", EF);
+		stream_header_param(&sim.header, "depsilon", depsilon);
+		stream_header_param(&sim.header, "epsilon0", epsilon0);
+		stream_header_param(&sim.header, "dgamma", dgamma);
+		stream_header_param(&sim.header, "gamma0", gamma0);
+		if (asym)
+			stream_header_param(&sim.header, "gammaR0", gammaR0);
+		stream_header_param(&sim.header, "Vmin", Vmin);
+		stream_header_param(&sim.header, "Vmax", Vmax);
+		stream_header_param(&sim.header, "eta", eta);
+		if (sampling == SAMPLING_SOBOL)
+			stream_header_param(&sim.header, "replica", replica);
+		if (nstrata > 0)
+			stream_header_param(&sim.header, "nstrata", nstrata);
+		if (legacy)
+			stream_header_param(&sim.header, "legacy", 1);
+		if (single)
+			stream_header_param(&sim.header, "single", 1);
+		if (covarg != NULL)
+			header_covariance(&sim.header, asym, covmat);
+		if (chain_model) {
+			stream_header_param(&sim.header, "nsites", chain.nsites);
+			stream_header_param(&sim.header, "beta", chain.beta);
+			stream_header_param(&sim.header, "dbeta", chain.dbeta);
+			stream_header_param(&sim.header, "dsite", chain.dsite);
+		}
+		if (cond_h != NULL) {
+			stream_header_param(&sim.header, "nsites", hamiltonian->nsites);
+			stream_header_param(&sim.header, "dsite", molecule.dsite);
+			stream_header_param(&sim.header, "dhop", molecule.dhop);
+		}
+		if (temperature > 0.0)
+			stream_header_param(&sim.header, "T", temperature);
+		if (coupling != COUPLING_NORMAL)
+			stream_header_param(&sim.header, "coupling", coupling);
+		if (pdf_gamma != NULL)
+			stream_header_param(&sim.header, "pdf_gamma", 1);
+		if (pdf_gammaR != NULL)
+			stream_header_param(&sim.header, "pdf_gammaR", 1);
+		if (pdf_epsilon != NULL)
+			stream_header_param(&sim.header, "pdf_epsilon", 1);
+		if (sim.output == OUTPUT_HISTOGRAM) {
+			stream_header_param(&sim.header, "nbin", nbin);
+			stream_header_column(&sim.header, "V", format);
+			stream_header_column(&sim.header, "logG", format);
+			stream_header_column(&sim.header, "count", format);
+		}
+		else if (sim.output == OUTPUT_TRACES) {
+			stream_header_param(&sim.header, "nV", nV);
+			stream_header_column(&sim.header, "I", format);
+			stream_header_column(&sim.header, "G", format);
+			stream_write_header(stdout, &sim.header);
+		}
+		else {
+			stream_header_column(&sim.header, "V", format);
+			stream_header_column(&sim.header, "G", format);
+			stream_write_header(stdout, &sim.header);
+		}
+	}
+
+	blocks.work = simulate_block;
+	blocks.emit = (sim.output == OUTPUT_SAMPLES ||
+		sim.output == OUTPUT_TRACES) ? write_block : NULL;
+	blocks.params = &sim;
 
-	// Seed the generator
-	gsl_rng_set(r, 0xFEEDFACE);
+	if (sim.output == OUTPUT_HISTOGRAM && !grange) {
+		// find the conductance range with a first pass; the trials are
+		// reproducible, so the second pass sees the same ones
+		sim.output = OUTPUT_RANGE;
+		for (i = 0; i < nthreads; ++i) {
+			sim.gmin[i] = DBL_MAX;
+			sim.gmax[i] = -DBL_MAX;
+		}
+		run_blocks(nblocks, nthreads, &blocks);
 
-	// Get the requested number of voltage-transmission sets
-	for (i = 0; i < n; ++i) {
-		V = Vmin + (Vmax - Vmin) * gsl_rng_uniform(r);
-		gamma = normal_random_variable(gamma0, dgamma, r);
-		epsilon = normal_random_variable(epsilon0, depsilon, r);
+		gmin = DBL_MAX;
+		gmax = -DBL_MAX;
+		for (i = 0; i < nthreads; ++i) {
+			if (sim.gmin[i] < gmin)
+				gmin = sim.gmin[i];
+			if (sim.gmax[i] > gmax)
+				gmax = sim.gmax[i];
+		}
+		sim.output = OUTPUT_HISTOGRAM;
+	}
+
+	if (sim.output == OUTPUT_HISTOGRAM) {
+		for (i = 0; i < nthreads; ++i) {
+			sim.hist[i] = gsl_histogram2d_alloc(nbin, nbin);
+			gsl_histogram2d_set_ranges_uniform(sim.hist[i], Vmin, Vmax, gmin,
+				gmax);
+		}
+	}
 
-		GV = cond(V, gamma, epsilon, eta, EF);
+	run_blocks(nblocks, nthreads, &blocks);
 
-		printf("%.6f %.6f\n", V, GV);
+	if (sim.output == OUTPUT_HISTOGRAM) {
+		for (i = 1; i < nthreads; ++i)
+			gsl_histogram2d_add(sim.hist[0], sim.hist[i]);
+		write_histogram(stdout, sim.hist[0], nbin, format, &sim.header);
 	}
+	else if (format != FORMAT_TEXT)
+		stream_write_end(stdout);
 
-	gsl_rng_free(r);
+	for (i = 0; i < nthreads; ++i) {
+		sampler_free(sim.r[i]);
+		free(sim.buf[i]);
+		free(sim.V[i]);
+		free(sim.GV[i]);
+		if (sim.hist[i] != NULL)
+			gsl_histogram2d_free(sim.hist[i]);
+	}
+	free(sim.hist);
+	free(sim.gmin);
+	free(sim.gmax);
+	free(sim.r);
+	free(sim.buf);
+	free(sim.cap);
+	free(sim.len);
+	if (sim.text != NULL)
+		text_output_free(sim.text);
+	free(sim.V);
+	free(sim.GV);
+	free(sim.Vtrace);
+	if (sim.trials.legacy != NULL)
+		gsl_rng_free(sim.trials.legacy);
+	empirical_dist_free(pdf_gamma);
+	empirical_dist_free(pdf_gammaR);
+	empirical_dist_free(pdf_epsilon);
+	hamiltonian_free(hamiltonian);
 	return 0;
 }
 
-double normal_random_variable(double mean, double stdev, gsl_rng *r) {
-	return gsl_ran_gaussian(r, stdev) + mean;
-}
+void simulate_block(long block, int slot, void *params) {
+	st_sim *sim = (st_sim*)params;
+	st_sampler *r = sim->r[slot];
+	st_slot_output out;
 
-// Voltage-independent model
-static double transmission_i(double gamma, double epsilon, double E) {
-	return gamma*gamma / 
-		((E-epsilon)*(E-epsilon) + gamma*gamma);
+	switch(sim->output) {
+	case OUTPUT_RANGE:
+		trials_log_range(&sim->trials, block, r, &sim->gmin[slot],
+			&sim->gmax[slot]);
+		break;
+	case OUTPUT_HISTOGRAM:
+		trials_histogram(&sim->trials, block, r, sim->hist[slot]);
+		break;
+	case OUTPUT_SAMPLES:
+		out.sim = sim;
+		out.slot = slot;
+		sim->len[slot] = 0;
+		simulate_trials(&sim->trials, block, r, store_batch, &out);
+		break;
+	case OUTPUT_TRACES:
+		out.sim = sim;
+		out.slot = slot;
+		simulate_traces(&sim->trials, sim->grid, sim->Vtrace, sim->nV, block,
+			r, store_traces, &out);
+		break;
+	}
 }
 
-double conductance_i(double V, double gamma, double epsilon, double eta,
-	double EF) {
+void store_batch(const double *V, const double *G, long offset, long m,
+	void *ctx) {
 
-	return eta*transmission_i(gamma, epsilon, EF + eta*V) +
-		(1.-eta)*transmission_i(gamma, epsilon, EF + (eta-1.)*V);
-}
+	st_slot_output *out = (st_slot_output*)ctx;
+	st_sim *sim = out->sim;
+	char *buf, *p;
+	size_t need;
+	long j;
 
-// Single-site, voltage-dependent model
-static double transmission_s(double V, double gamma, double epsilon, double E)
-{
-	return gamma*gamma /
-		((E-epsilon-V)*(E-epsilon-V) + gamma*gamma);
-}
+	if (sim->format != FORMAT_TEXT) {
+		memcpy(sim->V[out->slot] + offset, V, m*sizeof(double));
+		memcpy(sim->GV[out->slot] + offset, G, m*sizeof(double));
+		sim->len[out->slot] = offset + m;
+		return;
+	}
 
-double conductance_s(double V, double gamma, double epsilon, double eta,
-	double EF) {
+	// "%.6f %.6f\n" usually takes at most 64 characters, but the voltages
+	// (and conductances) can be larger; make room for the longest rows
+	need = sim->len[out->slot] + m*2*(TEXT_MAX_NUMBER + 1);
+	if (need > sim->cap[out->slot]) {
+		while (sim->cap[out->slot] < need)
+			sim->cap[out->slot] *= 2;
+		sim->buf[out->slot] = (char*)realloc(sim->buf[out->slot],
+			sim->cap[out->slot]);
+	}
 
-	return (eta-1.)*transmission_s(V, gamma, epsilon, EF + eta*V) +
-		(2.-eta)*transmission_s(V, gamma, epsilon, EF + (eta-1.)*V);
+	buf = sim->buf[out->slot];
+	p = buf + sim->len[out->slot];
+	for (j = 0; j < m; ++j) {
+		p = format_fixed(p, p + TEXT_MAX_NUMBER + 1, V[j]);
+		*p++ = ' ';
+		p = format_fixed(p, p + TEXT_MAX_NUMBER + 1, G[j]);
+		*p++ = '\n';
+	}
+	sim->len[out->slot] = p - buf;
 }
 
-// Double-site, voltage-dependent model
-static double transmission_d(double V, double gamma, double epsilon, 
-	double beta, double E) {
-
-	double temp = 4.*(E-epsilon)*(E-epsilon) - 4.*beta*beta - gamma*gamma - V*V;
+void store_traces(const double *I, const double *G, long m, void *ctx) {
+	st_slot_output *out = (st_slot_output*)ctx;
+	st_sim *sim = out->sim;
+	const long nV = sim->nV;
+	double *It = sim->V[out->slot];
+	double *Gt = sim->GV[out->slot];
+	long j, k;
 
-	return 16.*gamma*gamma*beta*beta / (temp*temp +
-		16.*gamma*gamma*(E-epsilon)*(E-epsilon));
+	// one trace after another
+	for (j = 0; j < m; ++j) {
+		for (k = 0; k < nV; ++k) {
+			It[j*nV + k] = I[k*m + j];
+			Gt[j*nV + k] = G[k*m + j];
+		}
+	}
+	sim->len[out->slot] = m;
 }
 
-static double dtdvint_d(double V, double gamma, double beta, double z) {
-	const double bv = 4.*beta*beta + V*V;
-	const double bvg = bv + gamma*gamma;
-//	const std::complex<double> arctan = atan(2.*z / 
-//		std::complex<double>(gamma, -sqrt(bv)));
-	const std::complex<double> arctan = atan2(2.*z * sqrt(bv) / (gamma*gamma + bv), 
-		2.*z * gamma / (gamma*gamma + bv));
+void write_block(long block, int slot, void *params) {
+	st_sim *sim = (st_sim*)params;
+	const long nV = sim->nV;
+	const double *cols[2];
+	double row[3];
+	size_t j;
+	long k;
 
-	return 8.*V*gamma*gamma*beta*beta*z*(4.*z*z + gamma*gamma - 3.*bv) /
-		(bv*bvg*(16.*z*z*z*z + 8.*(gamma*gamma - bv)*z*z + bvg*bvg))
+	if (sim->output == OUTPUT_TRACES) {
+		for (j = 0; j < sim->len[slot]; ++j) {
+			cols[0] = sim->V[slot] + j*nV;
+			cols[1] = sim->GV[slot] + j*nV;
+			if (sim->format != FORMAT_TEXT) {
+				stream_write_frame(stdout, &sim->header, cols, nV);
+				continue;
+			}
 
-		- 8.*V*gamma*beta*beta / (bvg*bvg) * std::real(arctan)
+			for (k = 0; k < nV; ++k) {
+				row[0] = sim->Vtrace[k];
+				row[1] = cols[0][k];
+				row[2] = cols[1][k];
+				text_output_row(sim->text, row, 3, false);
+			}
+			text_output_newline(sim->text);
+		}
+		return;
+	}
 
-		- 4.*V*gamma*gamma*beta*beta*(3.*bv + gamma*gamma) /
-			(bvg*bvg*bv*sqrt(bv)) * std::imag(arctan);
-}
+	if (sim->format == FORMAT_TEXT) {
+		fwrite(sim->buf[slot], 1, sim->len[slot], stdout);
+		return;
+	}
 
-double conductance_d(double V, double gamma, double epsilon, double eta,
-	double EF) {
+	cols[0] = sim->V[slot];
+	cols[1] = sim->GV[slot];
+	stream_write_frame(stdout, &sim->header, cols, sim->len[slot]);
+}
 
-	const double beta = -3.0;
+void header_covariance(st_stream_header *h, bool asym, const double *cov) {
+	static const char *sym[] = {"g", "eps"};
+	static const char *asy[] = {"gL", "gR", "eps"};
+	const char **vars = asym ? asy : sym;
+	const int dims = asym ? 3 : 2;
+	char name[STREAM_NAME_LENGTH];
+	int i, j;
 
-	return eta*transmission_d(V, gamma, epsilon, beta, EF + eta*V) +
-		(1.-eta)*transmission_d(V, gamma, epsilon, beta, EF + (eta-1.)*V) +
-		dtdvint_d(V, gamma, beta, EF - epsilon + eta*V) -
-		dtdvint_d(V, gamma, beta, EF - epsilon + (eta-1.)*V);
+	for (i = 0; i < dims; ++i) {
+		for (j = i; j < dims; ++j) {
+			snprintf(name, sizeof(name), "cov_%s_%s", vars[i], vars[j]);
+			stream_header_param(h, name, cov[i*dims + j]);
+		}
+	}
 }
@@ -0,0 +1,175 @@
+/*
+This work is licensed under the Creative Commons Attribution 3.0 United States
+License. To view a copy of this license, visit
+http://creativecommons.org/licenses/by/3.0/us/ or send a letter to Creative
+Commons, 444 Castro Street, Suite 900, Mountain View, California, 94041, USA.
+
+Copyright (C) 2013 Oak Ridge National Laboratory
+*/
+/**
+ * \file hamiltonian.cc
+ * \brief Implementation of the molecular Hamiltonian functions.
+ *
+ * \author agent
+ * \date October 2026
+ */
+
+#include "hamiltonian.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cctype>
+
+/**
+ * \brief Reads the next number from a file, skipping white space and
+ *        comments.
+ *
+ * \param[in,out] f The file.
+ * \param[out] x The number.
+ * \return 0 if a number was read; -1 otherwise.
+ */
+static int read_number(FILE *f, double *x) {
+	int c;
+
+	while ((c = fgetc(f)) != EOF) {
+		if (c == '#') {
+			while ((c = fgetc(f)) != EOF && c != '\n')
+				;
+		}
+		else if (!isspace(c)) {
+			ungetc(c, f);
+			return (fscanf(f, "%lf", x) == 1) ? 0 : -1;
+		}
+	}
+	return -1;
+}
+
+st_hamiltonian *hamiltonian_read(const char *filename) {
+	st_hamiltonian *h;
+	st_hamiltonian_work *w;
+	FILE *f;
+	double head[3];
+	int n, i, j, p;
+	bool ok;
+
+	f = fopen(filename, "r");
+	if (f == NULL)
+		return NULL;
+
+	for (i = 0; i < 3; ++i) {
+		if (read_number(f, &head[i])) {
+			fclose(f);
+			return NULL;
+		}
+	}
+	n = (int)head[0];
+	if (n < 1 || head[1] < 0.0 || head[1] >= n || head[2] < 0.0 ||
+		head[2] >= n) {
+
+		fclose(f);
+		return NULL;
+	}
+
+	h = (st_hamiltonian*)malloc(sizeof(st_hamiltonian));
+	h->nsites = n;
+	h->left = (int)head[1];
+	h->right = (int)head[2];
+	h->H = (double*)malloc(n*n*sizeof(double));
+	h->hop = (int*)malloc(n*(n-1)*sizeof(int));
+	h->lambda = (double*)malloc(n*sizeof(double));
+	h->weight = (double*)malloc(3*n*sizeof(double));
+
+	ok = true;
+	for (i = 0; i < n*n && ok; ++i)
+		ok = read_number(f, &h->H[i]) == 0;
+	fclose(f);
+
+	h->nhops = 0;
+	for (i = 0; i < n && ok; ++i) {
+		for (j = i + 1; j < n && ok; ++j) {
+			ok = h->H[i*n + j] == h->H[j*n + i];
+			if (h->H[i*n + j] != 0.0) {
+				p = h->nhops++;
+				h->hop[2*p] = i;
+				h->hop[2*p + 1] = j;
+			}
+		}
+	}
+
+	if (!ok) {
+		hamiltonian_free(h);
+		return NULL;
+	}
+
+	w = hamiltonian_work_alloc(n);
+	hamiltonian_spectrum(h, NULL, NULL, w, h->lambda, h->weight);
+	hamiltonian_work_free(w);
+	return h;
+}
+
+void hamiltonian_free(st_hamiltonian *h) {
+	if (h == NULL)
+		return;
+
+	free(h->H);
+	free(h->hop);
+	free(h->lambda);
+	free(h->weight);
+	free(h);
+}
+
+st_hamiltonian_work *hamiltonian_work_alloc(int nsites) {
+	st_hamiltonian_work *w;
+
+	w = (st_hamiltonian_work*)malloc(sizeof(st_hamiltonian_work));
+	w->A = gsl_matrix_alloc(nsites, nsites);
+	w->evec = gsl_matrix_alloc(nsites, nsites);
+	w->eval = gsl_vector_alloc(nsites);
+	w->eigen = gsl_eigen_symmv_alloc(nsites);
+	return w;
+}
+
+void hamiltonian_work_free(st_hamiltonian_work *w) {
+	gsl_eigen_symmv_free(w->eigen);
+	gsl_vector_free(w->eval);
+	gsl_matrix_free(w->evec);
+	gsl_matrix_free(w->A);
+	free(w);
+}
+
+void hamiltonian_spectrum(const st_hamiltonian *h, const double *dsite,
+	const double *dhop, st_hamiltonian_work *w, double *lambda,
+	double *weight) {
+
+	const int n = h->nsites;
+	double ul, ur, x;
+	int i, j, k, p;
+
+	for (i = 0; i < n; ++i)
+		for (j = 0; j < n; ++j)
+			gsl_matrix_set(w->A, i, j, h->H[i*n + j]);
+
+	if (dsite != NULL)
+		for (i = 0; i < n; ++i)
+			gsl_matrix_set(w->A, i, i, h->H[i*n + i] + dsite[i]);
+
+	if (dhop != NULL) {
+		for (p = 0; p < h->nhops; ++p) {
+			i = h->hop[2*p];
+			j = h->hop[2*p + 1];
+			x = h->H[i*n + j] + dhop[p];
+			gsl_matrix_set(w->A, i, j, x);
+			gsl_matrix_set(w->A, j, i, x);
+		}
+	}
+
+	gsl_eigen_symmv(w->A, w->eval, w->evec, w->eigen);
+
+	for (k = 0; k < n; ++k) {
+		lambda[k] = gsl_vector_get(w->eval, k);
+		ul = gsl_matrix_get(w->evec, h->left, k);
+		ur = gsl_matrix_get(w->evec, h->right, k);
+		weight[3*k] = ul*ul;
+		weight[3*k + 1] = ul*ur;
+		weight[3*k + 2] = ur*ur;
+	}
+}
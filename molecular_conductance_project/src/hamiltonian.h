@@ -0,0 +1,137 @@
+/*
+This work is licensed under the Creative Commons Attribution 3.0 United States
+License. To view a copy of this license, visit
+http://creativecommons.org/licenses/by/3.0/us/ or send a letter to Creative
+Commons, 444 Castro Street, Suite 900, Mountain View, California, 94041, USA.
+
+Copyright (C) 2013 Oak Ridge National Laboratory
+*/
+/**
+ * \file hamiltonian.h
+ * \brief Prototypes for reading a molecular Hamiltonian and finding the
+ *        spectral decomposition used by the molecule models.
+ *
+ * A molecule is a real symmetric Hamiltonian H on N sites (the on-site
+ * energies on the diagonal, the hoppings off it) with one site coupled to
+ * each electrode. The molecule models (see conductance.h) need only the
+ * eigenvalues of H and, for each eigenvector, its components at the two
+ * coupled sites. These are found once by GSL's symmetric eigensolver and
+ * reused for every energy and voltage; a disordered Hamiltonian is
+ * decomposed once per realization.
+ *
+ * \author agent
+ * \date October 2026
+ */
+
+#ifndef __hamiltonian_h__
+#define __hamiltonian_h__
+
+#include <gsl/gsl_eigen.h>
+
+/**
+ * \brief A molecular Hamiltonian and its spectral decomposition.
+ */
+typedef struct {
+	/// The number of sites, N.
+	int nsites;
+
+	/// The sites coupled to the two electrodes (counting from 0; they may
+	/// be the same site).
+	int left, right;
+
+	/// The Hamiltonian (eV), N x N in row-major order.
+	double *H;
+
+	/// The number of nonzero hoppings (above the diagonal).
+	int nhops;
+
+	/// The sites joined by each hopping; hop[2p] < hop[2p+1].
+	int *hop;
+
+	/// The eigenvalues of H (eV).
+	double *lambda;
+
+	/// The spectral weights of each eigenvector u_k: weight[3k], weight[3k+1],
+	/// and weight[3k+2] are u_lk^2, u_lk u_rk, and u_rk^2 for the left and
+	/// right sites l and r.
+	double *weight;
+} st_hamiltonian;
+
+/**
+ * \brief Workspace for decomposing Hamiltonians of one size.
+ */
+typedef struct {
+	/// The Hamiltonian being decomposed (overwritten by the solver).
+	gsl_matrix *A;
+
+	/// The eigenvectors, one per column.
+	gsl_matrix *evec;
+
+	/// The eigenvalues.
+	gsl_vector *eval;
+
+	/// The solver's workspace.
+	gsl_eigen_symmv_workspace *eigen;
+} st_hamiltonian_work;
+
+/**
+ * \brief Reads a Hamiltonian from a file and decomposes it.
+ *
+ * The file holds N and the left and right sites (counting from 0), followed
+ * by the N x N Hamiltonian row by row, all separated by white space; text
+ * from a `#' to the end of the line is skipped. For example, the
+ * double-site model is
+ * \verbatim
+   2 0 1
+   0 -3
+   -3 0
+   \endverbatim
+ * The level energy of each trial is added to every on-site energy, so the
+ * diagonal holds the sites' energies relative to it.
+ *
+ * \param[in] filename The file.
+ * \return The Hamiltonian, or NULL if the file cannot be read, N is not
+ *         positive, a site is out of range, or the matrix is not symmetric.
+ */
+st_hamiltonian *hamiltonian_read(const char *filename);
+
+/**
+ * \brief Frees a Hamiltonian.
+ *
+ * \param[in,out] h The Hamiltonian (may be NULL).
+ */
+void hamiltonian_free(st_hamiltonian *h);
+
+/**
+ * \brief Allocates a workspace for decomposing N x N Hamiltonians.
+ *
+ * \param[in] nsites The number of sites, N.
+ * \return The workspace.
+ */
+st_hamiltonian_work *hamiltonian_work_alloc(int nsites);
+
+/**
+ * \brief Frees a workspace.
+ *
+ * \param[in,out] w The workspace.
+ */
+void hamiltonian_work_free(st_hamiltonian_work *w);
+
+/**
+ * \brief Decomposes a disordered realization of a Hamiltonian.
+ *
+ * The realization is h->H with dsite[i] added to on-site energy i and
+ * dhop[p] added to hopping p (on both sides of the diagonal).
+ *
+ * \param[in] h The Hamiltonian.
+ * \param[in] dsite The offsets of the on-site energies, or NULL for none.
+ * \param[in] dhop The offsets of the hoppings, or NULL for none.
+ * \param[in,out] w A workspace for h->nsites sites.
+ * \param[out] lambda The eigenvalues (N of them).
+ * \param[out] weight The spectral weights, as in st_hamiltonian (3N).
+ */
+void hamiltonian_spectrum(const st_hamiltonian *h, const double *dsite,
+	const double *dhop, st_hamiltonian_work *w, double *lambda,
+	double *weight);
+
+#endif
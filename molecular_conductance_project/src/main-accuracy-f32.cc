@@ -0,0 +1,404 @@
+/*
+This work is licensed under the Creative Commons Attribution 3.0 United States
+License. To view a copy of this license, visit
+http://creativecommons.org/licenses/by/3.0/us/ or send a letter to Creative
+Commons, 444 Castro Street, Suite 900, Mountain View, California, 94041, USA.
+
+Copyright (C) 2013 Oak Ridge National Laboratory
+*/
+/**
+ * \file main-accuracy-f32.cc
+ * \brief Main function for checking the single-precision histograms against
+ *        the double-precision ones.
+ *
+ * For each of the 81 reference parameter sets (the default grid of sweep:
+ * models `i', `s', `d'; epsilon0 = -3, -6.5, -10; gamma0 = 0.5, 0.75, 1.0;
+ * eta = 0.3, 0.4, 0.5), the trials are binned exactly as
+ * `final-sim-v-2d --histogram' does, once in double precision and once with
+ * `--precision single'. Both use Sobol sampling, so that they see the same
+ * trials (rounded to single precision in the latter), and both histograms
+ * use the conductance range found by the double-precision pass. Any
+ * difference between them therefore comes from rounding alone: from the
+ * conductance kernels, the logarithms, and the bin arithmetic.
+ *
+ * One line is written per parameter set: the model, epsilon0, gamma0, eta,
+ * the largest difference in any bin's count, the largest count, the number
+ * of trials that changed bins, and the difference in the log10 conductance
+ * range found by the two range passes. A summary per model follows.
+ *
+ * First, the single-precision sampler is checked at the end of its word
+ * buffer: a request for an odd number of numbers whose last one needs a
+ * fresh buffer (as the level energies of 1365 + 4096k single-precision
+ * trials do) must give the same numbers as the same request split in two.
+ * One line reports the result.
+ *
+ * There are seven required command-line arguments:
+ *    -# The number of trials for each parameter set.
+ *    -# The Fermi level of the system (eV).
+ *    -# The standard deviation in site level energy (eV).
+ *    -# The standard deviation in electrode-channel coupling (eV).
+ *    -# The lower bound of the applied bias range (V).
+ *    -# The upper bound of the applied bias range (V).
+ *    -# The number of bins in each direction.
+ *
+ * Optional arguments:
+ *    - `--threads N' checks N parameter sets at a time (default 1).
+ *
+ * \author agent
+ * \date October 2026
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cfloat>
+#include <cmath>
+#include <gsl/gsl_histogram2d.h>
+#include "parallel.h"
+#include "sampler.h"
+#include "simulation.h"
+
+/// The number of reference parameter sets.
+#define ACCURACY_POINTS 81
+
+/**
+ * \brief The comparison of the two histograms for one parameter set.
+ */
+typedef struct {
+	/// The largest difference in a bin's count.
+	double maxdiff;
+
+	/// The largest count in the double-precision histogram.
+	double maxcount;
+
+	/// The number of trials in different bins.
+	double moved;
+
+	/// The largest difference between the ends of the log10 conductance
+	/// ranges.
+	double drange;
+} st_comparison;
+
+/**
+ * \brief Struct for passing the check to the block functions.
+ *
+ * Each "block" handed to run_blocks() is one parameter set.
+ */
+typedef struct {
+	/// The trial parameters shared by all parameter sets.
+	st_trials common;
+
+	/// The number of bins in each direction.
+	int nbin;
+
+	/// One random number sampler per slot (unused by Sobol sampling, but
+	/// required by the simulation functions).
+	st_sampler **r;
+
+	/// The comparison for each parameter set.
+	st_comparison *result;
+} st_accuracy;
+
+/**
+ * \brief Gets the model and parameters of a reference parameter set.
+ *
+ * \param[in] point The parameter set, in [0, #ACCURACY_POINTS).
+ * \param[out] model The model.
+ * \param[out] epsilon0 The average site level energy.
+ * \param[out] gamma0 The average coupling.
+ * \param[out] eta The relative voltage drop.
+ */
+void reference_point(long point, char *model, double *epsilon0,
+	double *gamma0, double *eta);
+
+/**
+ * \brief Simulates both histograms for one parameter set and compares them.
+ *
+ * \param[in] point The parameter set.
+ * \param[in] slot The slot (thread) workspace to use.
+ * \param[in] params The st_accuracy.
+ */
+void check_point(long point, int slot, void *params);
+
+/**
+ * \brief Writes the comparison for one parameter set to standard out.
+ *
+ * \param[in] point The parameter set.
+ * \param[in] slot The slot (thread) workspace that checked it.
+ * \param[in] params The st_accuracy.
+ */
+void report_point(long point, int slot, void *params);
+
+/**
+ * \brief Checks the single-precision sampler across the end of its word
+ *        buffer.
+ *
+ * \param[in] gaussian Whether to check sampler_gaussian_f() (otherwise
+ *                     sampler_uniform_f()).
+ * \return 0 if the numbers agree; -1 otherwise.
+ */
+int check_buffer_end(bool gaussian);
+
+/**
+ * \brief Main function for the accuracy check.
+ *
+ * \param[in] argc The number of command-line arguments.
+ * \param[in] argv The command-line arguments.
+ * \return Exit status; 0 for normal.
+ */
+int main(int argc, char **argv) {
+	long i, point;
+	int nthreads, nargs, nbin;
+	char *args[8];
+	char model;
+	double epsilon0, gamma0, eta;
+	double maxdiff, maxcount, moved, drange;
+	st_accuracy acc;
+	st_blocks blocks;
+
+	// pull out the optional arguments
+	nthreads = 1;
+	nargs = 0;
+	for (i = 0; i < argc; ++i) {
+		if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+			nthreads = atoi(argv[++i]);
+			if (nthreads < 1) {
+				fprintf(stderr, "Error: Use at least one thread.\n");
+				return 0;
+			}
+		}
+		else if (nargs < 8)
+			args[nargs++] = argv[i];
+		else
+			++nargs;
+	}
+	argc = nargs;
+	argv = args;
+
+	if (argc != 8) {
+		fprintf(stderr, "Usage error: ./accuracy-f32 n EF depsilon dgamma " \
+			"Vmin Vmax nbin\n" \
+			"   n is the number of trials for each parameter set\n" \
+			"   EF is the Fermi level (eV)\n" \
+			"   depsilon is the standard deviation in site level energy (eV)\n" \
+			"   dgamma is the standard deviation in the coupling (eV)\n" \
+			"   Vmin is the lower bound of the applied bias range (V)\n" \
+			"   Vmax is the upper bound of the applied bias range (V)\n" \
+			"   nbin is the number of bins in each direction\n" \
+			"\n   Options:\n" \
+			"   --threads N checks N parameter sets at a time\n");
+		return 0;
+	}
+
+	acc.common.cond = NULL;
+	acc.common.cond_f = NULL;
+	acc.common.cond_a = NULL;
+	acc.common.chain = NULL;
+	acc.common.cond_h = NULL;
+	acc.common.molecule = NULL;
+	acc.common.cond_t = NULL;
+	acc.common.kT = 0.0;
+	acc.common.n = atol(argv[1]);
+	acc.common.EF = atof(argv[2]);
+	acc.common.depsilon = atof(argv[3]);
+	acc.common.epsilon0 = 0.0;
+	acc.common.dgamma = atof(argv[4]);
+	acc.common.gamma0 = 0.0;
+	acc.common.gammaR0 = 0.0;
+	acc.common.cov = NULL;
+	acc.common.coupling = COUPLING_NORMAL;
+	acc.common.pdf_gamma = NULL;
+	acc.common.pdf_gammaR = NULL;
+	acc.common.pdf_epsilon = NULL;
+	acc.common.Vmin = atof(argv[5]);
+	acc.common.Vmax = atof(argv[6]);
+	acc.common.eta = 0.0;
+	acc.common.sampling = SAMPLING_SOBOL;
+	acc.common.replica = 0;
+	acc.common.nstrata = 0;
+	acc.common.legacy = NULL;
+	nbin = atoi(argv[7]);
+
+	if (acc.common.depsilon <= 0.0 || acc.common.dgamma <= 0.0) {
+		fprintf(stderr, "Error: standard deviations must be positive.\n");
+		return 0;
+	}
+
+	if (acc.common.n <= 0 || acc.common.n > 4294967296L) {
+		fprintf(stderr, "Error: Use between one and 2^32 trials.\n");
+		return 0;
+	}
+
+	if (acc.common.Vmin > acc.common.Vmax) {
+		fprintf(stderr, "Error: Vmin is lower bound, Vmax is upper bound; " \
+			"Vmax > Vmin.\n");
+		return 0;
+	}
+
+	if (nbin < 1) {
+		fprintf(stderr, "Error: Use at least one bin.\n");
+		return 0;
+	}
+
+	acc.nbin = nbin;
+	acc.r = (st_sampler**)malloc(nthreads*sizeof(st_sampler*));
+	acc.result = (st_comparison*)malloc(ACCURACY_POINTS*sizeof(st_comparison));
+	for (i = 0; i < nthreads; ++i)
+		acc.r[i] = sampler_alloc();
+
+	printf("# odd request at the end of the sampler buffer: uniform %s, " \
+		"normal %s\n", check_buffer_end(false) ? "FAILED" : "ok",
+		check_buffer_end(true) ? "FAILED" : "ok");
+
+	printf("# model epsilon0 gamma0 eta max_bin_diff max_bin moved " \
+		"range_diff\n");
+	blocks.work = check_point;
+	blocks.emit = report_point;
+	blocks.params = &acc;
+	run_blocks(ACCURACY_POINTS, nthreads, &blocks);
+
+	// the summary, one model (27 points) at a time
+	for (point = 0; point < ACCURACY_POINTS; point += ACCURACY_POINTS / 3) {
+		reference_point(point, &model, &epsilon0, &gamma0, &eta);
+		maxdiff = maxcount = moved = drange = 0.0;
+		for (i = point; i < point + ACCURACY_POINTS / 3; ++i) {
+			if (acc.result[i].maxdiff > maxdiff) {
+				maxdiff = acc.result[i].maxdiff;
+				maxcount = acc.result[i].maxcount;
+			}
+			if (acc.result[i].moved > moved)
+				moved = acc.result[i].moved;
+			if (acc.result[i].drange > drange)
+				drange = acc.result[i].drange;
+		}
+		printf("# model %c: max bin difference %.0f (largest bin %.0f), " \
+			"at most %.0f trials (%.2g%%) moved, range differs by %.2g\n",
+			model, maxdiff, maxcount, moved,
+			100.0 * moved / acc.common.n, drange);
+	}
+
+	for (i = 0; i < nthreads; ++i)
+		sampler_free(acc.r[i]);
+	free(acc.r);
+	free(acc.result);
+	return 0;
+}
+
+void reference_point(long point, char *model, double *epsilon0,
+	double *gamma0, double *eta) {
+
+	static const char models[3] = {'i', 's', 'd'};
+	static const double epslist[3] = {-3.0, -6.5, -10.0};
+	static const double gamlist[3] = {0.5, 0.75, 1.0};
+	static const double etalist[3] = {0.3, 0.4, 0.5};
+
+	// in the order of sweep's grid
+	*model = models[point / 27];
+	*epsilon0 = epslist[point / 9 % 3];
+	*gamma0 = gamlist[point / 3 % 3];
+	*eta = etalist[point % 3];
+}
+
+void check_point(long point, int slot, void *params) {
+	st_accuracy *acc = (st_accuracy*)params;
+	st_sampler *r = acc->r[slot];
+	st_trials t = acc->common;
+	st_comparison *c = &acc->result[point];
+	gsl_histogram2d *hd, *hf;
+	char model;
+	double gmin, gmax, gmin_f, gmax_f, diff, count;
+	long block, nblocks;
+	int i, j;
+
+	reference_point(point, &model, &t.epsilon0, &t.gamma0, &t.eta);
+	t.cond = select_model(model);
+	nblocks = count_blocks(t.n);
+
+	// the range passes, in each precision
+	gmin = gmin_f = DBL_MAX;
+	gmax = gmax_f = -DBL_MAX;
+	for (block = 0; block < nblocks; ++block)
+		trials_log_range(&t, block, r, &gmin, &gmax);
+	t.cond_f = select_model_f(model);
+	for (block = 0; block < nblocks; ++block)
+		trials_log_range(&t, block, r, &gmin_f, &gmax_f);
+
+	// the histograms, on the same bins
+	hd = gsl_histogram2d_alloc(acc->nbin, acc->nbin);
+	hf = gsl_histogram2d_alloc(acc->nbin, acc->nbin);
+	gsl_histogram2d_set_ranges_uniform(hd, t.Vmin, t.Vmax, gmin, gmax);
+	gsl_histogram2d_set_ranges_uniform(hf, t.Vmin, t.Vmax, gmin, gmax);
+	for (block = 0; block < nblocks; ++block)
+		trials_histogram(&t, block, r, hf);
+	t.cond_f = NULL;
+	for (block = 0; block < nblocks; ++block)
+		trials_histogram(&t, block, r, hd);
+
+	c->maxdiff = c->maxcount = c->moved = 0.0;
+	for (i = 0; i < acc->nbin; ++i)
+		for (j = 0; j < acc->nbin; ++j) {
+			count = gsl_histogram2d_get(hd, i, j);
+			diff = fabs(gsl_histogram2d_get(hf, i, j) - count);
+			if (diff > c->maxdiff)
+				c->maxdiff = diff;
+			if (count > c->maxcount)
+				c->maxcount = count;
+			c->moved += diff;
+		}
+
+	// a trial that moves leaves one bin and enters another
+	c->moved *= 0.5;
+	c->drange = fmax(fabs(gmin_f - gmin), fabs(gmax_f - gmax));
+
+	gsl_histogram2d_free(hf);
+	gsl_histogram2d_free(hd);
+}
+
+void report_point(long point, int slot, void *params) {
+	st_accuracy *acc = (st_accuracy*)params;
+	const st_comparison *c = &acc->result[point];
+	char model;
+	double epsilon0, gamma0, eta;
+
+	reference_point(point, &model, &epsilon0, &gamma0, &eta);
+	printf("%c %g %g %g %.0f %.0f %.0f %.3g\n", model, epsilon0, gamma0, eta,
+		c->maxdiff, c->maxcount, c->moved, c->drange);
+}
+
+int check_buffer_end(bool gaussian) {
+	const size_t n = 2*SAMPLER_BUFFER - 2;
+	st_sampler *a, *b;
+	float *x, *y;
+	int err;
+
+	a = sampler_alloc();
+	b = sampler_alloc();
+	x = (float*)malloc((n + 3)*sizeof(float));
+	y = (float*)malloc((n + 3)*sizeof(float));
+
+	// two numbers per word: the request for three takes the buffer's last
+	// word and then the low half of a fresh buffer's first
+	if (gaussian) {
+		sampler_gaussian_f(a, 0.0f, 1.0f, x, n);
+		sampler_gaussian_f(a, 0.0f, 1.0f, x + n, 3);
+		sampler_gaussian_f(b, 0.0f, 1.0f, y, n);
+		sampler_gaussian_f(b, 0.0f, 1.0f, y + n, 2);
+		sampler_gaussian_f(b, 0.0f, 1.0f, y + n + 2, 1);
+	}
+	else {
+		sampler_uniform_f(a, x, n);
+		sampler_uniform_f(a, x + n, 3);
+		sampler_uniform_f(b, y, n);
+		sampler_uniform_f(b, y + n, 2);
+		sampler_uniform_f(b, y + n + 2, 1);
+	}
+
+	err = (memcmp(x, y, (n + 3)*sizeof(float)) == 0 && a->pos == b->pos) ?
+		0 : -1;
+
+	free(x);
+	free(y);
+	sampler_free(a);
+	sampler_free(b);
+	return err;
+}
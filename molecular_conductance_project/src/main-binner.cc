@@ -26,16 +26,28 @@ Copyright (C) 2013 Oak Ridge National Laboratory
  * only a few) counts are suppressed. The actual number of bins used is
  * output to standard error.
  *
+ * The input may be text (one conductance per line) or a binary sample stream
+ * (see sample-stream.h); binary input is detected automatically, and its `G'
+ * column (or its only column) is binned.
+ *
+ * Optional arguments may be given before or after the required ones:
+ *    - `--format F' selects the output format: `text' (default), or `f64' /
+ *      `f32' for a binary stream with columns `g' and `pdf' in one frame. The
+ *      header carries the input's model and parameters, along with `nbin'.
+ *
  * \todo Add options to turn on/off bin suppression.
  *
  * \author Matthew G.\ Reuter
- * \date July 2012, May 2013
+ * \date July 2012, May 2013, October 2026
  */
 
 #include <cstdio>
 #include <cstdlib>
 #include <cmath>
+#include <cstring>
 #include <gsl/gsl_histogram.h>
+#include "sample-stream.h"
+#include "text-format.h"
 
 /**
  * \brief Main function for binning.
@@ -47,16 +59,41 @@ Copyright (C) 2013 Oak Ridge National Laboratory
  * \return Exit status; 0 for normal.
  */
 int main(int argc, char **argv) {
-	int nbin, ntrials, i, usedbin;
-	double t, mint, maxt, *logt;
+	int nbin, ntrials, i, usedbin, nargs, col;
+	double t, mint, maxt, *logt, *bing, *binpdf, row[2];
+	const double *cols[2];
+	char *args[3];
+	bool binary;
+	en_format format;
+	st_stream_header in, out;
+	st_text_output *text;
 	gsl_histogram *h;
 
+	// pull out the optional arguments
+	format = FORMAT_TEXT;
+	nargs = 0;
+	for(i = 0; i < argc; ++i) {
+		if(strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+			if(stream_parse_format(argv[++i], &format)) {
+				fprintf(stderr, "Error: Unknown format: '%s'.\n", argv[i]);
+				return 0;
+			}
+		}
+		else if(nargs < 3)
+			args[nargs++] = argv[i];
+		else
+			++nargs;
+	}
+	argc = nargs;
+	argv = args;
+
 	// get the command-line arguments
 	if(argc != 3) {
 		fprintf(stderr, "Usage: ./binner nbin ntrials\n" \
 			"   ntrials is the number of trials in the input data\n" \
 			"   nbin is the number of bins to use\n" \
-			"NOTE: The data is expected through stdin\n");
+			"   --format F is 'text' (default), 'f64', or 'f32'\n" \
+			"NOTE: The data is expected through stdin (text or binary)\n");
 		return 0;
 	}
 
@@ -74,10 +111,42 @@ int main(int argc, char **argv) {
 	// read in the data
 	// get the min and max values, store the logarithms
 	logt = (double*)malloc(ntrials*sizeof(double));
+	binary = stream_is_binary(stdin);
+	if(binary) {
+		if(stream_read_header(stdin, &in)) {
+			fprintf(stderr, "Error: Malformed binary input.\n");
+			free(logt);
+			return 0;
+		}
+
+		col = stream_header_find(&in, "G");
+		if(col < 0 && in.ncols == 1)
+			col = 0;
+		if(col < 0) {
+			fprintf(stderr, "Error: The input has no 'G' column.\n");
+			free(logt);
+			return 0;
+		}
+
+		// read the conductances straight into logt; the logarithms are
+		// taken below
+		if(stream_read_columns(stdin, &in, &col, 1, &logt, ntrials) != ntrials) {
+			fprintf(stderr, "Error: The input has fewer than %d trials.\n",
+				ntrials);
+			free(logt);
+			return 0;
+		}
+	}
+	else
+		stream_header_init(&in, "", 1);
+
 	mint = 1.0;
 	maxt = 0.0;
 	for(i = 0; i < ntrials; ++i) {
-		scanf("%le", &t);
+		if(binary)
+			t = logt[i];
+		else
+			scanf("%le", &t);
 		if(t < mint)
 			mint = t;
 		if(t > maxt)
@@ -97,13 +166,15 @@ int main(int argc, char **argv) {
 
 	// print it out
 	// count the number of bins with meaningful population
+	bing = (double*)malloc(nbin*sizeof(double));
+	binpdf = (double*)malloc(nbin*sizeof(double));
+	text = text_output_alloc(stdout);
 	usedbin = 0;
 	for(i = 0; i < nbin; ++i) {
 		t = gsl_histogram_get(h, i);
 		// don't print out an empty or sparsely filled bin
 		if(t < 0.005*ntrials)
 			continue;
-		++usedbin;
 
 		gsl_histogram_get_range(h, i, &mint, &maxt);
 		// convert the range back to regular 'g' (from 'log g')
@@ -111,11 +182,36 @@ int main(int argc, char **argv) {
 		maxt = pow(10.0, maxt);
 		// also have to scale the histogram count by the width of the bin and
 		// the total number of trials
-		printf("%.6e %.6e\n", 0.5*(maxt + mint), t / ((maxt - mint) * ntrials));
+		bing[usedbin] = 0.5*(maxt + mint);
+		binpdf[usedbin] = t / ((maxt - mint) * ntrials);
+		if(format == FORMAT_TEXT) {
+			row[0] = bing[usedbin];
+			row[1] = binpdf[usedbin];
+			text_output_row(text, row, 2, true);
+		}
+		++usedbin;
+	}
+	text_output_free(text);
+
+	if(format != FORMAT_TEXT) {
+		out = in;
+		out.frame_rows = nbin;
+		out.ncols = 0;
+		stream_header_param(&out, "nbin", nbin);
+		stream_header_column(&out, "g", format);
+		stream_header_column(&out, "pdf", format);
+		stream_write_header(stdout, &out);
+
+		cols[0] = bing;
+		cols[1] = binpdf;
+		stream_write_frame(stdout, &out, cols, usedbin);
+		stream_write_end(stdout);
 	}
 
 	// clean up
 	gsl_histogram_free(h);
+	free(binpdf);
+	free(bing);
 	free(logt);
 	fprintf(stderr, "%d\n", usedbin);
 
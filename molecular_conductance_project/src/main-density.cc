@@ -0,0 +1,310 @@
+/*
+This work is licensed under the Creative Commons Attribution 3.0 United States
+License. To view a copy of this license, visit
+http://creativecommons.org/licenses/by/3.0/us/ or send a letter to Creative
+Commons, 444 Castro Street, Suite 900, Mountain View, California, 94041, USA.
+
+Copyright (C) 2013 Oak Ridge National Laboratory
+*/
+/**
+ * \file main-density.cc
+ * \brief Main function for computing voltage-dependent conductance histograms
+ *        by numerical integration instead of random sampling.
+ *
+ * The 2D histogram made by `final-sim-v-2d --histogram' estimates the
+ * distribution of log10 conductance that the (normally distributed) coupling
+ * and site level energy induce through the conductance model, for voltages
+ * uniform in [Vmin, Vmax]. This program computes the probability of each bin
+ * directly, so the histogram has no sampling noise.
+ *
+ * For each voltage column, the probability is integrated by the midpoint
+ * rule over the voltage bin and over the quantiles of the coupling. The site
+ * level energy, which changes the conductance most sharply, is handled
+ * along each line of fixed voltage and coupling: log10 conductance is
+ * evaluated at equally spaced quantiles of the site level energy and taken
+ * to be linear between them, so the probability between two quantiles is
+ * spread over the bins it crosses in proportion to the overlap.
+ *
+ * There are ten required command-line arguments:
+ *    -# The model to use:
+ *       - `i' for the independent-level voltage-dependent model
+ *       - `s' for the single-site voltage-dependent model
+ *       - `d' for the double-site voltage-dependent model
+ *       - `x' for the double-site model with the exact dI/dV
+ *    -# The Fermi level of the system (eV)
+ *    -# The standard deviation in site level energy (eV)
+ *    -# The average site level energy (eV)
+ *    -# The standard deviation in electrode-channel coupling (eV)
+ *    -# The average coupling to both electrodes, in eV.
+ *    -# The lower bound of the applied bias range (V).
+ *    -# The upper bound of the applied bias range (V).
+ *    -# The relative voltage drop for one electrode.
+ *    -# The number of bins in each direction.
+ *
+ * Optional arguments may be given before or after the required ones:
+ *    - `--grange LO HI' is the range of log10 conductance to bin. By default
+ *      it is the extent of the conductances at the integration nodes, which
+ *      is usually a little narrower than that of a large simulation; give
+ *      the same range to both programs to compare them.
+ *    - `--nodes NV NG NE' sets the number of integration nodes per voltage
+ *      bin, for the coupling, and for the site level energy (default 4, 128,
+ *      and 512).
+ *    - `--threads N' computes N voltage columns at a time (default 1).
+ *    - `--format F' is the output format, as for final-sim-v-2d.
+ *
+ * The output is in the layout of final-binner-v-2d (and of the files in
+ * `Data Processing/data'), with the largest bin scaled to 1.
+ *
+ * \author agent
+ * \date October 2026
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <cfloat>
+#include <gsl/gsl_histogram2d.h>
+#include "parallel.h"
+#include "sampler.h"
+#include "sample-stream.h"
+#include "simulation.h"
+#include "density.h"
+
+/**
+ * \brief Main function for computing a histogram.
+ *
+ * Parses the input parameters and outputs the integrated histogram.
+ *
+ * \param[in] argc The number of command-line arguments.
+ * \param[in] argv The command-line arguments.
+ * \return Exit status; 0 for normal.
+ */
+int main(int argc, char **argv) {
+	long i, j;
+	int nthreads, nargs;
+	en_format format;
+	bool grange;
+	char *args[11];
+	double minv, maxv, ming, maxg;
+	st_density d;
+	st_stream_header header;
+	st_blocks blocks;
+	gsl_histogram2d *h;
+
+	// pull out the optional arguments
+	nthreads = 1;
+	format = FORMAT_TEXT;
+	grange = false;
+	d.gmin = d.gmax = 0.0;
+	d.nv = 4;
+	d.ng = 128;
+	d.ne = 512;
+	nargs = 0;
+	for (i = 0; i < argc; ++i) {
+		if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+			nthreads = atoi(argv[++i]);
+			if (nthreads < 1) {
+				fprintf(stderr, "Error: Use at least one thread.\n");
+				return 0;
+			}
+		}
+		else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+			if (stream_parse_format(argv[++i], &format)) {
+				fprintf(stderr, "Error: Unknown format: '%s'.\n", argv[i]);
+				return 0;
+			}
+		}
+		else if (strcmp(argv[i], "--grange") == 0 && i + 2 < argc) {
+			d.gmin = atof(argv[++i]);
+			d.gmax = atof(argv[++i]);
+			grange = true;
+			if (d.gmin >= d.gmax) {
+				fprintf(stderr, "Error: The conductance range must have LO < " \
+					"HI.\n");
+				return 0;
+			}
+		}
+		else if (strcmp(argv[i], "--nodes") == 0 && i + 3 < argc) {
+			d.nv = atoi(argv[++i]);
+			d.ng = atoi(argv[++i]);
+			d.ne = atoi(argv[++i]);
+			if (d.nv < 1 || d.ng < 1 || d.ne < 2) {
+				fprintf(stderr, "Error: Use at least 1, 1, and 2 nodes.\n");
+				return 0;
+			}
+		}
+		else if (nargs < 11)
+			args[nargs++] = argv[i];
+		else
+			++nargs;
+	}
+	argc = nargs;
+	argv = args;
+
+	if (argc != 11) {
+		fprintf(stderr, "Usage error: ./density model EF depsilon epsilon0 " \
+			"dgamma gamma0 Vmin Vmax eta nbin\n" \
+			"   model is the model to use: 'i', 's', 'd', or 'x'\n" \
+			"   EF is the Fermi level (eV)\n" \
+			"   depsilon is the standard deviation in site level energy (eV)\n" \
+			"   epsilon0 is the average site level energy (eV)\n" \
+			"   dgamma is the standard deviation in the coupling (eV)\n" \
+			"   gamma0 is the average coupling for one electrode (eV)\n" \
+			"   Vmin is the lower bound of the applied bias range (V)\n" \
+			"   Vmax is the upper bound of the applied bias range (V)\n" \
+			"   eta is the relative voltage drop for one electrode\n" \
+			"   nbin is the number of bins in each direction\n" \
+			"\n   Options:\n" \
+			"   --grange LO HI is the log10 conductance range\n" \
+			"   --nodes NV NG NE are the numbers of integration nodes " \
+				"(default 4 128 512)\n" \
+			"   --threads N computes N voltage columns at a time\n" \
+			"   --format F is 'text' (default), 'f64', or 'f32'\n" \
+			"\n   NOTE: symmetric coupling is assumed.\n");
+		return 0;
+	}
+
+	// model
+	d.cond = select_model(*argv[1]);
+	if (d.cond == NULL) {
+		fprintf(stderr, "Error: Unknown model: '%c'.\n", *argv[1]);
+		return 0;
+	}
+	d.EF = atof(argv[2]);
+	d.depsilon = atof(argv[3]);
+	d.epsilon0 = atof(argv[4]);
+	d.dgamma = atof(argv[5]);
+	d.gamma0 = atof(argv[6]);
+	d.Vmin = atof(argv[7]);
+	d.Vmax = atof(argv[8]);
+	d.eta = atof(argv[9]);
+	d.nbin = atoi(argv[10]);
+
+	if (d.depsilon <= 0.0 || d.dgamma <= 0.0) {
+		fprintf(stderr, "Error: standard deviations must be positive.\n");
+		return 0;
+	}
+
+	if (d.gamma0 <= 0.0) {
+		fprintf(stderr, "Error: gamma0 must be positive.\n");
+		return 0;
+	}
+
+	if (d.gamma0 / d.dgamma < 4.0) {
+		fprintf(stderr, "Warning: The model assumes gamma0 / dgamma >> 0; " \
+			"bigger than 4, in practice.\n");
+	}
+
+	if (d.Vmin > d.Vmax) {
+		fprintf(stderr, "Error: Vmin is lower bound, Vmax is upper bound; " \
+			"Vmax > Vmin.\n");
+		return 0;
+	}
+
+	if (d.eta > 1.0 || d.eta < 0.0) {
+		fprintf(stderr, "Error: eta is a relative voltage drop on one side; " \
+			"0 <= eta <= 1.\n");
+		return 0;
+	}
+
+	if (d.nbin < 1) {
+		fprintf(stderr, "Error: Use at least one bin.\n");
+		return 0;
+	}
+
+	// the nodes are at the midpoints of equal-probability intervals
+	d.gq = (double*)malloc(d.ng*sizeof(double));
+	d.eq = (double*)malloc(d.ne*sizeof(double));
+	for (i = 0; i < d.ng; ++i)
+		d.gq[i] = normal_quantile((i + 0.5) / d.ng);
+	for (i = 0; i < d.ne; ++i)
+		d.eq[i] = normal_quantile((i + 0.5) / d.ne);
+
+	d.colmin = (double*)malloc(d.nbin*sizeof(double));
+	d.colmax = (double*)malloc(d.nbin*sizeof(double));
+	d.prob = (double*)calloc((size_t)d.nbin*d.nbin, sizeof(double));
+	d.V = (double**)malloc(nthreads*sizeof(double*));
+	d.gamma = (double**)malloc(nthreads*sizeof(double*));
+	d.epsilon = (double**)malloc(nthreads*sizeof(double*));
+	d.logg = (double**)malloc(nthreads*sizeof(double*));
+	for (i = 0; i < nthreads; ++i) {
+		d.V[i] = (double*)malloc(d.ne*sizeof(double));
+		d.gamma[i] = (double*)malloc(d.ne*sizeof(double));
+		d.epsilon[i] = (double*)malloc(d.ne*sizeof(double));
+		d.logg[i] = (double*)malloc(d.ne*sizeof(double));
+	}
+
+	blocks.work = density_column;
+	blocks.emit = NULL;
+	blocks.params = &d;
+
+	if (!grange) {
+		d.range = true;
+		run_blocks(d.nbin, nthreads, &blocks);
+
+		d.gmin = DBL_MAX;
+		d.gmax = -DBL_MAX;
+		for (i = 0; i < d.nbin; ++i) {
+			if (d.colmin[i] < d.gmin)
+				d.gmin = d.colmin[i];
+			if (d.colmax[i] > d.gmax)
+				d.gmax = d.colmax[i];
+		}
+		if (d.gmin >= d.gmax) {
+			fprintf(stderr, "Error: The conductances span no range; use " \
+				"--grange.\n");
+			return 0;
+		}
+	}
+
+	d.range = false;
+	run_blocks(d.nbin, nthreads, &blocks);
+
+	h = gsl_histogram2d_alloc(d.nbin, d.nbin);
+	gsl_histogram2d_set_ranges_uniform(h, d.Vmin, d.Vmax, d.gmin, d.gmax);
+	for (i = 0; i < d.nbin; ++i) {
+		gsl_histogram2d_get_xrange(h, i, &minv, &maxv);
+		for (j = 0; j < d.nbin; ++j) {
+			gsl_histogram2d_get_yrange(h, j, &ming, &maxg);
+			gsl_histogram2d_accumulate(h, 0.5*(minv + maxv),
+				0.5*(ming + maxg), d.prob[i*d.nbin + j]);
+		}
+	}
+
+	if (format != FORMAT_TEXT) {
+		stream_header_init(&header, argv[1], d.nbin);
+		stream_header_param(&header, "EF", d.EF);
+		stream_header_param(&header, "depsilon", d.depsilon);
+		stream_header_param(&header, "epsilon0", d.epsilon0);
+		stream_header_param(&header, "dgamma", d.dgamma);
+		stream_header_param(&header, "gamma0", d.gamma0);
+		stream_header_param(&header, "Vmin", d.Vmin);
+		stream_header_param(&header, "Vmax", d.Vmax);
+		stream_header_param(&header, "eta", d.eta);
+		stream_header_param(&header, "nbin", d.nbin);
+		stream_header_column(&header, "V", format);
+		stream_header_column(&header, "logG", format);
+		stream_header_column(&header, "count", format);
+	}
+	write_histogram(stdout, h, d.nbin, format, &header);
+
+	gsl_histogram2d_free(h);
+	for (i = 0; i < nthreads; ++i) {
+		free(d.V[i]);
+		free(d.gamma[i]);
+		free(d.epsilon[i]);
+		free(d.logg[i]);
+	}
+	free(d.V);
+	free(d.gamma);
+	free(d.epsilon);
+	free(d.logg);
+	free(d.prob);
+	free(d.colmax);
+	free(d.colmin);
+	free(d.eq);
+	free(d.gq);
+
+	return 0;
+}
@@ -0,0 +1,316 @@
+/*
+This work is licensed under the Creative Commons Attribution 3.0 United States
+License. To view a copy of this license, visit
+http://creativecommons.org/licenses/by/3.0/us/ or send a letter to Creative
+Commons, 444 Castro Street, Suite 900, Mountain View, California, 94041, USA.
+
+Copyright (C) 2013 Oak Ridge National Laboratory
+*/
+/**
+ * \file main-model-check.cc
+ * \brief Main function for checking the exact double-site model with
+ *        symmetric coupling (x) against the one with asymmetric coupling
+ *        (da).
+ *
+ * With gammaL = gammaR = gamma, conductance_da() and conductance_x() are
+ * both the exact dI/dV of the double-site model, found by different
+ * routes: da from the Green's function's poles, x from the partial
+ * fractions of the transmission (see conductance.cc). They are compared on
+ * a grid of n voltages and n level energies in [-#CHECK_RANGE,
+ * #CHECK_RANGE], the couplings +-10^-3, +-10^-2, ..., +-1, and the relative
+ * voltage drops 0, 0.3, 0.5, and 1, with EF = 0. The batch functions
+ * conductance_x_batch() and conductance_d_batch() are checked on the same
+ * grid, and must match conductance_x() and conductance_d() exactly.
+ *
+ * One line is written for each coupling: the coupling, the largest
+ * |x - da| over the rest of the grid, the point where it occurs, and the
+ * number of batch mismatches. A line then gives the largest difference
+ * overall.
+ *
+ * Both double-site models go negative where the junction has negative
+ * differential conductance, which has no log10. The integrated histogram of
+ * the density program (see density.h) is therefore also computed for d and
+ * x, with EF = 0, depsilon = 0.3, epsilon0 = -3, dgamma = 0.05, gamma0 =
+ * 0.5, V in [-2, 2], eta = 0.3, and #CHECK_BINS bins, and every bin must be
+ * finite, with a total probability of at most 1 in each voltage column. One
+ * line is written for each model: the number of bins that are not finite
+ * and the mean total of the columns.
+ *
+ * There is one required command-line argument:
+ *    -# The number of voltages and of level energies, n (at least 2).
+ *
+ * Optional arguments:
+ *    - `--tol T' is the largest |x - da| accepted (default 1e-8).
+ *
+ * \author agent
+ * \date October 2026
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include "conductance.h"
+#include "density.h"
+
+/// The voltages and level energies span [-CHECK_RANGE, CHECK_RANGE].
+#define CHECK_RANGE 3.0
+
+/// The number of coupling magnitudes, 10^-3 to 1.
+#define CHECK_GAMMAS 4
+
+/// The number of relative voltage drops.
+#define CHECK_ETAS 4
+
+/// The number of bins in each direction of the density check.
+#define CHECK_BINS 100
+
+/**
+ * \brief The largest difference found for one coupling.
+ */
+typedef struct {
+	/// The difference, |x - da|.
+	double diff;
+
+	/// Where it occurs.
+	double V, epsilon, eta;
+
+	/// The conductances there.
+	double x, da;
+
+	/// The number of samples where conductance_x_batch() or
+	/// conductance_d_batch() differs from conductance_x() or
+	/// conductance_d().
+	long batch;
+} st_worst;
+
+/**
+ * \brief Compares x with da for one coupling over the grid.
+ *
+ * \param[in] gamma The coupling.
+ * \param[in] n The number of voltages and of level energies.
+ * \param[out] worst The largest difference and where it occurs.
+ */
+void check_gamma(double gamma, int n, st_worst *worst);
+
+/**
+ * \brief Integrates the histogram of the density program for one model.
+ *
+ * \param[in] cond The model (batch version).
+ * \param[out] total The mean total probability of the voltage columns.
+ * \return The number of bins whose probability is not finite.
+ */
+long check_density(conductance_batch_fn cond, double *total);
+
+/**
+ * \brief Main function for the model check.
+ *
+ * \param[in] argc The number of command-line arguments.
+ * \param[in] argv The command-line arguments.
+ * \return Exit status; 0 if x and da agree within the tolerance, the
+ *         batch functions agree with the scalar ones, and the histograms
+ *         are finite, 1 otherwise.
+ */
+int main(int argc, char **argv) {
+	int i, j, n, nargs;
+	char *args[2];
+	long bad;
+	double tol, gamma, dmax, total;
+	st_worst worst;
+	bool ok;
+
+	// pull out the optional arguments
+	tol = 1.0e-8;
+	nargs = 0;
+	for (i = 0; i < argc; ++i) {
+		if (strcmp(argv[i], "--tol") == 0 && i + 1 < argc)
+			tol = atof(argv[++i]);
+		else if (nargs < 2)
+			args[nargs++] = argv[i];
+		else
+			++nargs;
+	}
+	argc = nargs;
+	argv = args;
+
+	if (argc != 2) {
+		fprintf(stderr, "Usage error: ./model-check n\n" \
+			"   n is the number of voltages and of level energies\n" \
+			"\n   Options:\n" \
+			"   --tol T is the largest |x - da| accepted (default 1e-8)\n");
+		return 0;
+	}
+
+	n = atoi(argv[1]);
+	if (n < 2) {
+		fprintf(stderr, "Error: Use at least 2 voltages.\n");
+		return 0;
+	}
+
+	ok = true;
+	dmax = 0.0;
+	printf("# gamma max|x-da| V epsilon eta x da batch_mismatches\n");
+	for (i = 0; i < CHECK_GAMMAS; ++i) {
+		for (j = -1; j <= 1; j += 2) {
+			gamma = j * pow(10.0, i - CHECK_GAMMAS + 1);
+			check_gamma(gamma, n, &worst);
+			printf("%g %.3e %.6f %.6f %.1f %.12g %.12g %ld\n", gamma,
+				worst.diff, worst.V, worst.epsilon, worst.eta, worst.x,
+				worst.da, worst.batch);
+
+			if (worst.diff > dmax)
+				dmax = worst.diff;
+			if (worst.diff > tol || worst.batch != 0)
+				ok = false;
+		}
+	}
+
+	printf("# largest |x - da|: %.3e\n", dmax);
+
+	printf("# model nonfinite_bins column_probability\n");
+	bad = check_density(conductance_d_batch, &total);
+	printf("d %ld %.12g\n", bad, total);
+	if (bad != 0 || !(total <= 1.0 + 1.0e-12))
+		ok = false;
+	bad = check_density(conductance_x_batch, &total);
+	printf("x %ld %.12g\n", bad, total);
+	if (bad != 0 || !(total <= 1.0 + 1.0e-12))
+		ok = false;
+
+	printf("# %s\n", ok ? "ok" : "FAILED");
+	return ok ? 0 : 1;
+}
+
+void check_gamma(double gamma, int n, st_worst *worst) {
+	static const double etas[CHECK_ETAS] = {0.0, 0.3, 0.5, 1.0};
+	double *V, *g, *e, *out, *outd;
+	double x, d, da, diff;
+	int i, j, k;
+
+	V = (double*)malloc(n * sizeof(double));
+	g = (double*)malloc(n * sizeof(double));
+	e = (double*)malloc(n * sizeof(double));
+	out = (double*)malloc(n * sizeof(double));
+	outd = (double*)malloc(n * sizeof(double));
+
+	memset(worst, 0, sizeof(st_worst));
+	for (j = 0; j < n; ++j) {
+		g[j] = gamma;
+		e[j] = CHECK_RANGE * (2.0*j / (n - 1) - 1.0);
+	}
+
+	for (k = 0; k < CHECK_ETAS; ++k) {
+		for (i = 0; i < n; ++i) {
+			for (j = 0; j < n; ++j)
+				V[j] = CHECK_RANGE * (2.0*i / (n - 1) - 1.0);
+			conductance_x_batch(V, g, e, etas[k], 0.0, out, n);
+			conductance_d_batch(V, g, e, etas[k], 0.0, outd, n);
+
+			for (j = 0; j < n; ++j) {
+				x = conductance_x(V[j], gamma, e[j], etas[k], 0.0);
+				d = conductance_d(V[j], gamma, e[j], etas[k], 0.0);
+				da = conductance_da(V[j], gamma, gamma, e[j], etas[k], 0.0);
+				diff = fabs(x - da);
+
+				// NaN counts as the largest difference
+				if (std::isnan(diff))
+					diff = INFINITY;
+				if (diff > worst->diff) {
+					worst->diff = diff;
+					worst->V = V[j];
+					worst->epsilon = e[j];
+					worst->eta = etas[k];
+					worst->x = x;
+					worst->da = da;
+				}
+				if (memcmp(&out[j], &x, sizeof(double)) != 0)
+					++worst->batch;
+				if (memcmp(&outd[j], &d, sizeof(double)) != 0)
+					++worst->batch;
+			}
+		}
+	}
+
+	free(V);
+	free(g);
+	free(e);
+	free(out);
+	free(outd);
+}
+
+long check_density(conductance_batch_fn cond, double *total) {
+	st_density d;
+	long bad;
+	int i;
+
+	d.cond = cond;
+	d.EF = 0.0;
+	d.depsilon = 0.3;
+	d.epsilon0 = -3.0;
+	d.dgamma = 0.05;
+	d.gamma0 = 0.5;
+	d.Vmin = -2.0;
+	d.Vmax = 2.0;
+	d.eta = 0.3;
+	d.nbin = CHECK_BINS;
+	d.nv = 1;
+	d.ng = 16;
+	d.ne = 256;
+
+	d.gq = (double*)malloc(d.ng*sizeof(double));
+	d.eq = (double*)malloc(d.ne*sizeof(double));
+	for (i = 0; i < d.ng; ++i)
+		d.gq[i] = normal_quantile((i + 0.5) / d.ng);
+	for (i = 0; i < d.ne; ++i)
+		d.eq[i] = normal_quantile((i + 0.5) / d.ne);
+
+	d.colmin = (double*)malloc(d.nbin*sizeof(double));
+	d.colmax = (double*)malloc(d.nbin*sizeof(double));
+	d.prob = (double*)calloc((size_t)d.nbin*d.nbin, sizeof(double));
+	d.V = (double**)malloc(sizeof(double*));
+	d.gamma = (double**)malloc(sizeof(double*));
+	d.epsilon = (double**)malloc(sizeof(double*));
+	d.logg = (double**)malloc(sizeof(double*));
+	d.V[0] = (double*)malloc(d.ne*sizeof(double));
+	d.gamma[0] = (double*)malloc(d.ne*sizeof(double));
+	d.epsilon[0] = (double*)malloc(d.ne*sizeof(double));
+	d.logg[0] = (double*)malloc(d.ne*sizeof(double));
+
+	// the range pass, then the probabilities, one column at a time
+	d.range = true;
+	for (i = 0; i < d.nbin; ++i)
+		density_column(i, 0, &d);
+	d.gmin = d.colmin[0];
+	d.gmax = d.colmax[0];
+	for (i = 1; i < d.nbin; ++i) {
+		d.gmin = fmin(d.gmin, d.colmin[i]);
+		d.gmax = fmax(d.gmax, d.colmax[i]);
+	}
+	d.range = false;
+	for (i = 0; i < d.nbin; ++i)
+		density_column(i, 0, &d);
+
+	bad = 0;
+	*total = 0.0;
+	for (i = 0; i < d.nbin*d.nbin; ++i) {
+		if (!std::isfinite(d.prob[i]))
+			++bad;
+		*total += d.prob[i];
+	}
+	*total /= d.nbin;
+
+	free(d.V[0]);
+	free(d.gamma[0]);
+	free(d.epsilon[0]);
+	free(d.logg[0]);
+	free(d.V);
+	free(d.gamma);
+	free(d.epsilon);
+	free(d.logg);
+	free(d.prob);
+	free(d.colmax);
+	free(d.colmin);
+	free(d.eq);
+	free(d.gq);
+	return bad;
+}
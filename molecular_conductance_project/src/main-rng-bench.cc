@@ -0,0 +1,183 @@
+/*
+This work is licensed under the Creative Commons Attribution 3.0 United States
+License. To view a copy of this license, visit
+http://creativecommons.org/licenses/by/3.0/us/ or send a letter to Creative
+Commons, 444 Castro Street, Suite 900, Mountain View, California, 94041, USA.
+
+Copyright (C) 2013 Oak Ridge National Laboratory
+*/
+/**
+ * \file main-rng-bench.cc
+ * \brief Main function for measuring the throughput of the random number
+ *        generators.
+ *
+ * Each generator (see sampler.h) draws the random numbers of n trials the way
+ * the simulators do: in batches of #TRIALS_PER_BATCH, one uniform voltage and
+ * two normal parameters (coupling and site level energy) per trial. One line
+ * is written per generator: its name, the time taken, and the number of
+ * trials and of samples (three per trial) drawn per second.
+ *
+ * There is one required command-line argument:
+ *    -# The number of trials.
+ *
+ * Optional arguments:
+ *    - `--rng NAME' measures only the generator NAME (see parse_rng()).
+ *      By default xoshiro, pcg64, philox, and gsl:mt19937 are measured.
+ *    - `--precision P' is `double' (default) or `single', to measure the
+ *      single-precision sampler functions instead.
+ *
+ * \author agent
+ * \date October 2026
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include "parallel.h"
+#include "sampler.h"
+#include "simulation.h"
+
+/**
+ * \brief Draws the random numbers for n trials.
+ *
+ * \param[in,out] r The sampler.
+ * \param[in] n The number of trials.
+ * \param[in] single Whether to use the single-precision functions.
+ * \return The sum of the numbers drawn (so that they are not optimized away).
+ */
+double draw_trials(st_sampler *r, long n, bool single);
+
+/**
+ * \brief Gets the time from a monotonic clock.
+ *
+ * \return The time, in seconds.
+ */
+double now();
+
+/**
+ * \brief Main function for the generator benchmark.
+ *
+ * \param[in] argc The number of command-line arguments.
+ * \param[in] argv The command-line arguments.
+ * \return Exit status; 0 for normal.
+ */
+int main(int argc, char **argv) {
+	static const char *defaults[] = {"xoshiro", "pcg64", "philox",
+		"gsl:mt19937"};
+	long i, n;
+	int nargs, nnames;
+	char *args[2];
+	const char *names[4];
+	bool single;
+	st_rng rng;
+	st_sampler *r;
+	double start, elapsed, sum;
+
+	// pull out the optional arguments
+	single = false;
+	nnames = 0;
+	nargs = 0;
+	for (i = 0; i < argc; ++i) {
+		if (strcmp(argv[i], "--rng") == 0 && i + 1 < argc) {
+			if (parse_rng(argv[++i], &rng)) {
+				fprintf(stderr, "Error: Unknown generator: '%s'.\n", argv[i]);
+				return 0;
+			}
+			names[0] = argv[i];
+			nnames = 1;
+		}
+		else if (strcmp(argv[i], "--precision") == 0 && i + 1 < argc) {
+			if (parse_precision(argv[++i], &single)) {
+				fprintf(stderr, "Error: Unknown precision: '%s'.\n", argv[i]);
+				return 0;
+			}
+		}
+		else if (nargs < 2)
+			args[nargs++] = argv[i];
+		else
+			++nargs;
+	}
+	argc = nargs;
+	argv = args;
+
+	if (argc != 2) {
+		fprintf(stderr, "Usage error: ./rng-bench n\n" \
+			"   n is the number of trials (one uniform and two normal " \
+				"numbers each)\n" \
+			"\n   Options:\n" \
+			"   --rng NAME measures only the generator NAME\n" \
+			"   --precision P is 'double' (default) or 'single'\n");
+		return 0;
+	}
+
+	n = atol(argv[1]);
+	if (n <= 0) {
+		fprintf(stderr, "Error: There must be at least one trial.\n");
+		return 0;
+	}
+
+	if (nnames == 0) {
+		for (i = 0; i < 4; ++i)
+			names[i] = defaults[i];
+		nnames = 4;
+	}
+
+	printf("# generator seconds trials/s samples/s\n");
+	for (i = 0; i < nnames; ++i) {
+		if (parse_rng(names[i], &rng)) {
+			fprintf(stderr, "Error: Unknown generator: '%s'.\n", names[i]);
+			continue;
+		}
+		r = sampler_alloc_rng(&rng);
+
+		start = now();
+		sum = draw_trials(r, n, single);
+		elapsed = now() - start;
+
+		printf("%s %.3f %.4g %.4g\n", names[i], elapsed, n / elapsed,
+			3.0 * n / elapsed);
+
+		// keep the numbers alive
+		if (sum != sum)
+			fprintf(stderr, "Warning: NaN drawn by %s.\n", names[i]);
+		sampler_free(r);
+	}
+
+	return 0;
+}
+
+double draw_trials(st_sampler *r, long n, bool single) {
+	double V[TRIALS_PER_BATCH], gamma[TRIALS_PER_BATCH];
+	double epsilon[TRIALS_PER_BATCH];
+	float V_f[TRIALS_PER_BATCH], gamma_f[TRIALS_PER_BATCH];
+	float epsilon_f[TRIALS_PER_BATCH];
+	double sum = 0.0;
+	long i, m;
+
+	for (i = 0; i < n; i += TRIALS_PER_BATCH) {
+		m = (n - i < TRIALS_PER_BATCH) ? n - i : TRIALS_PER_BATCH;
+
+		if (single) {
+			sampler_flat_f(r, -1.0f, 1.0f, V_f, m);
+			sampler_gaussian_f(r, 0.5f, 0.05f, gamma_f, m);
+			sampler_gaussian_f(r, -3.0f, 0.3f, epsilon_f, m);
+			sum += V_f[m-1] + gamma_f[m-1] + epsilon_f[m-1];
+		}
+		else {
+			sampler_flat(r, -1.0, 1.0, V, m);
+			sampler_gaussian(r, 0.5, 0.05, gamma, m);
+			sampler_gaussian(r, -3.0, 0.3, epsilon, m);
+			sum += V[m-1] + gamma[m-1] + epsilon[m-1];
+		}
+	}
+
+	return sum;
+}
+
+double now() {
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + 1e-9 * t.tv_nsec;
+}
@@ -0,0 +1,447 @@
+/*
+This work is licensed under the Creative Commons Attribution 3.0 United States
+License. To view a copy of this license, visit
+http://creativecommons.org/licenses/by/3.0/us/ or send a letter to Creative
+Commons, 444 Castro Street, Suite 900, Mountain View, California, 94041, USA.
+
+Copyright (C) 2013 Oak Ridge National Laboratory
+*/
+/**
+ * \file main-sampler-check.cc
+ * \brief Main function for checking the statistics of the bulk sampler
+ *        against GSL's.
+ *
+ * n normal and n uniform numbers are drawn from each of four sources: the
+ * sampler in double precision (sampler_gaussian(), sampler_uniform()), the
+ * sampler in single precision (the _f functions), the sampler in double
+ * precision on the raw words of a second generator (`--rng2'; by default
+ * GSL's ranlux, which gives 24 bits per call), and GSL's mt19937 with
+ * gsl_ran_gaussian() and gsl_rng_uniform(). They are drawn in batches of
+ * #CHECK_BATCH, an odd number, so the single-precision functions also leave
+ * half words unused.
+ *
+ * For each statistic, one line is written: its name, its exact value, and
+ * for each source the value found and its deviation from the exact value in
+ * standard errors (z). The normal statistics are the mean, variance,
+ * skewness, and excess kurtosis; the fractions beyond |z| = 3 and 4; and a
+ * chi-square over #CHECK_BINS equally likely bins. Two more cover the
+ * Ziggurat's rejections, which the sampler resolves with its side stream:
+ * the fraction beyond the Ziggurat's base layer (|z| > 3.654..., drawn only
+ * by the tail algorithm) and the average distance beyond it. The wedges
+ * between the layers' rectangles and the curve hold about 1% of the
+ * numbers, spread over every bin, so mistakes there show in the chi-square.
+ * The uniform statistics are the mean, the variance, and a chi-square over
+ * #CHECK_BINS equal bins.
+ *
+ * A last line gives the largest |z| of each source. The chi-square's z is
+ * (chi^2 - dof) / sqrt(2 dof).
+ *
+ * There is one required command-line argument:
+ *    -# The number of numbers of each kind drawn from each source (10^8
+ *       resolves the tails well).
+ *
+ * Optional arguments:
+ *    - `--rng NAME' selects the sampler's generator (see parse_rng();
+ *      default xoshiro).
+ *    - `--rng2 NAME' selects the second generator (default gsl:ranlux).
+ *    - `--seed S' seeds the sampler and GSL's mt19937 (default 1).
+ *    - `--limit Z' is the largest |z| accepted from the sampler, on either
+ *      generator (default 5).
+ *
+ * \author agent
+ * \date October 2026
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <gsl/gsl_rng.h>
+#include <gsl/gsl_randist.h>
+#include "sampler.h"
+
+/// The number of numbers drawn at a time.
+#define CHECK_BATCH 999
+
+/// The number of bins of the chi-square statistics.
+#define CHECK_BINS 256
+
+/// The number of statistics.
+#define CHECK_STATS 12
+
+/// The number of sources.
+#define CHECK_SOURCES 4
+
+/// The boundary of the Ziggurat's base layer (see sampler.cc).
+#define CHECK_ZIGGURAT_R 3.6541528853610088
+
+/**
+ * \brief The sources of random numbers.
+ */
+typedef enum {
+	/// The sampler, in double precision.
+	SOURCE_F64,
+
+	/// The sampler, in single precision.
+	SOURCE_F32,
+
+	/// The sampler on the second generator, in double precision.
+	SOURCE_RNG2,
+
+	/// GSL.
+	SOURCE_GSL
+} en_source;
+
+/**
+ * \brief The running sums of one source's numbers.
+ */
+typedef struct {
+	/// The sums of the normal numbers' first four powers.
+	double s[4];
+
+	/// The counts of normal numbers beyond |z| = 3, 4, and the Ziggurat's
+	/// base layer.
+	double beyond3, beyond4, tail;
+
+	/// The sum of the distances beyond the base layer.
+	double excess;
+
+	/// The counts in the normal bins.
+	double nbin[CHECK_BINS];
+
+	/// The sums of the uniform numbers and their squares.
+	double u[2];
+
+	/// The counts in the uniform bins.
+	double ubin[CHECK_BINS];
+} st_sums;
+
+/**
+ * \brief Adds a batch of normal numbers to the sums.
+ *
+ * \param[in,out] sums The sums.
+ * \param[in] x The numbers.
+ * \param[in] m The number of numbers.
+ */
+void add_normal(st_sums *sums, const double *x, long m);
+
+/**
+ * \brief Adds a batch of uniform numbers to the sums.
+ *
+ * \param[in,out] sums The sums.
+ * \param[in] x The numbers.
+ * \param[in] m The number of numbers.
+ */
+void add_uniform(st_sums *sums, const double *x, long m);
+
+/**
+ * \brief Draws n normal and n uniform numbers from a source.
+ *
+ * \param[in] source The source.
+ * \param[in,out] r The sampler (all but SOURCE_GSL).
+ * \param[in,out] g The GSL generator (SOURCE_GSL).
+ * \param[in] n The number of numbers of each kind.
+ * \param[out] sums The sums of the numbers.
+ */
+void draw_source(en_source source, st_sampler *r, gsl_rng *g, long n,
+	st_sums *sums);
+
+/**
+ * \brief Finds the statistics from the sums, with their exact values and
+ *        standard errors.
+ *
+ * \param[in] sums The sums.
+ * \param[in] n The number of numbers of each kind.
+ * \param[out] value The statistics (#CHECK_STATS).
+ * \param[out] exact Their exact values.
+ * \param[out] stderror Their standard errors (or, for the chi-squares, the
+ *             standard deviation of the statistic).
+ */
+void statistics(const st_sums *sums, long n, double *value, double *exact,
+	double *stderror);
+
+/**
+ * \brief Finds the chi-square statistic of equally likely bins.
+ *
+ * \param[in] bin The counts.
+ * \param[in] n The total count.
+ * \return The statistic.
+ */
+double chi_square(const double *bin, long n);
+
+/**
+ * \brief Main function for the sampler check.
+ *
+ * \param[in] argc The number of command-line arguments.
+ * \param[in] argv The command-line arguments.
+ * \return Exit status; 0 if the sampler's statistics are within the limit
+ *         on both generators, 1 otherwise.
+ */
+int main(int argc, char **argv) {
+	static const char *names[CHECK_STATS] = {"normal_mean", "normal_var",
+		"normal_skew", "normal_exkurt", "normal_gt3", "normal_gt4",
+		"normal_chi2", "zig_tail", "zig_tail_excess", "uniform_mean",
+		"uniform_var", "uniform_chi2"};
+	long i, n;
+	int nargs, j;
+	char *args[2];
+	const char *rngname, *rng2name;
+	unsigned long seed;
+	double limit, z, zmax[CHECK_SOURCES];
+	double value[CHECK_SOURCES][CHECK_STATS], exact[CHECK_STATS];
+	double stderror[CHECK_STATS];
+	st_rng rng, rng2;
+	st_sampler *r, *r2;
+	gsl_rng *g;
+	st_sums *sums;
+	bool ok;
+
+	// pull out the optional arguments
+	rngname = "xoshiro";
+	rng2name = "gsl:ranlux";
+	seed = 1;
+	limit = 5.0;
+	nargs = 0;
+	for (i = 0; i < argc; ++i) {
+		if (strcmp(argv[i], "--rng") == 0 && i + 1 < argc)
+			rngname = argv[++i];
+		else if (strcmp(argv[i], "--rng2") == 0 && i + 1 < argc)
+			rng2name = argv[++i];
+		else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+			seed = strtoul(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], "--limit") == 0 && i + 1 < argc)
+			limit = atof(argv[++i]);
+		else if (nargs < 2)
+			args[nargs++] = argv[i];
+		else
+			++nargs;
+	}
+	argc = nargs;
+	argv = args;
+
+	if (argc != 2) {
+		fprintf(stderr, "Usage error: ./sampler-check n\n" \
+			"   n is the number of normal and of uniform numbers drawn " \
+				"from each source\n" \
+			"\n   Options:\n" \
+			"   --rng NAME selects the sampler's generator\n" \
+			"   --rng2 NAME selects the second generator (default " \
+				"gsl:ranlux)\n" \
+			"   --seed S seeds the sampler and GSL (default 1)\n" \
+			"   --limit Z is the largest |z| accepted (default 5)\n");
+		return 0;
+	}
+
+	n = atol(argv[1]);
+	if (n < CHECK_BINS) {
+		fprintf(stderr, "Error: Draw at least %d numbers.\n", CHECK_BINS);
+		return 0;
+	}
+
+	if (parse_rng(rngname, &rng)) {
+		fprintf(stderr, "Error: Unknown generator: '%s'.\n", rngname);
+		return 0;
+	}
+	if (parse_rng(rng2name, &rng2)) {
+		fprintf(stderr, "Error: Unknown generator: '%s'.\n", rng2name);
+		return 0;
+	}
+
+	sums = (st_sums*)malloc(sizeof(st_sums));
+	r = sampler_alloc_rng(&rng);
+	r2 = sampler_alloc_rng(&rng2);
+	g = gsl_rng_alloc(gsl_rng_mt19937);
+	for (j = 0; j < CHECK_SOURCES; ++j) {
+		sampler_set(r, seed);
+		sampler_set(r2, seed);
+		gsl_rng_set(g, seed);
+		draw_source((en_source)j, (j == SOURCE_RNG2) ? r2 : r, g, n, sums);
+		statistics(sums, n, value[j], exact, stderror);
+	}
+
+	printf("# statistic exact f64 z f32 z rng2 z gsl z\n");
+	for (j = 0; j < CHECK_SOURCES; ++j)
+		zmax[j] = 0.0;
+	for (i = 0; i < CHECK_STATS; ++i) {
+		printf("%s %.6g", names[i], exact[i]);
+		for (j = 0; j < CHECK_SOURCES; ++j) {
+			z = (value[j][i] - exact[i]) / stderror[i];
+			if (fabs(z) > zmax[j])
+				zmax[j] = fabs(z);
+			printf(" %.6g %.2f", value[j][i], z);
+		}
+		printf("\n");
+	}
+
+	ok = zmax[SOURCE_F64] <= limit && zmax[SOURCE_F32] <= limit &&
+		zmax[SOURCE_RNG2] <= limit;
+	printf("# largest |z|: f64 %.2f, f32 %.2f, rng2 %.2f, gsl %.2f; %s\n",
+		zmax[SOURCE_F64], zmax[SOURCE_F32], zmax[SOURCE_RNG2],
+		zmax[SOURCE_GSL], ok ? "ok" : "FAILED");
+
+	gsl_rng_free(g);
+	sampler_free(r2);
+	sampler_free(r);
+	free(sums);
+	return ok ? 0 : 1;
+}
+
+void add_normal(st_sums *sums, const double *x, long m) {
+	long k;
+	int b;
+	double x2, a;
+
+	for (k = 0; k < m; ++k) {
+		x2 = x[k]*x[k];
+		sums->s[0] += x[k];
+		sums->s[1] += x2;
+		sums->s[2] += x2*x[k];
+		sums->s[3] += x2*x2;
+
+		a = fabs(x[k]);
+		sums->beyond3 += (a > 3.0);
+		sums->beyond4 += (a > 4.0);
+		if (a > CHECK_ZIGGURAT_R) {
+			sums->tail += 1.0;
+			sums->excess += a - CHECK_ZIGGURAT_R;
+		}
+
+		// the normal CDF puts the numbers in equally likely bins
+		b = (int)(0.5*erfc(-x[k]*M_SQRT1_2) * CHECK_BINS);
+		sums->nbin[(b < CHECK_BINS) ? b : CHECK_BINS - 1] += 1.0;
+	}
+}
+
+void add_uniform(st_sums *sums, const double *x, long m) {
+	long k;
+
+	for (k = 0; k < m; ++k) {
+		sums->u[0] += x[k];
+		sums->u[1] += x[k]*x[k];
+		sums->ubin[(int)(x[k] * CHECK_BINS)] += 1.0;
+	}
+}
+
+void draw_source(en_source source, st_sampler *r, gsl_rng *g, long n,
+	st_sums *sums) {
+
+	double x[CHECK_BATCH];
+	float x_f[CHECK_BATCH];
+	long i, k, m;
+
+	memset(sums, 0, sizeof(st_sums));
+	for (i = 0; i < n; i += CHECK_BATCH) {
+		m = (n - i < CHECK_BATCH) ? n - i : CHECK_BATCH;
+
+		switch(source) {
+		case SOURCE_F64:
+		case SOURCE_RNG2:
+			sampler_gaussian(r, 0.0, 1.0, x, m);
+			break;
+		case SOURCE_F32:
+			sampler_gaussian_f(r, 0.0f, 1.0f, x_f, m);
+			for (k = 0; k < m; ++k)
+				x[k] = x_f[k];
+			break;
+		case SOURCE_GSL:
+			for (k = 0; k < m; ++k)
+				x[k] = gsl_ran_gaussian(g, 1.0);
+			break;
+		}
+		add_normal(sums, x, m);
+
+		switch(source) {
+		case SOURCE_F64:
+		case SOURCE_RNG2:
+			sampler_uniform(r, x, m);
+			break;
+		case SOURCE_F32:
+			sampler_uniform_f(r, x_f, m);
+			for (k = 0; k < m; ++k)
+				x[k] = x_f[k];
+			break;
+		case SOURCE_GSL:
+			for (k = 0; k < m; ++k)
+				x[k] = gsl_rng_uniform(g);
+			break;
+		}
+		add_uniform(sums, x, m);
+	}
+}
+
+void statistics(const st_sums *sums, long n, double *value, double *exact,
+	double *stderror) {
+
+	const double rz = CHECK_ZIGGURAT_R;
+	double m1, m2, m3, m4, c2, c3, c4, p, lambda;
+	int i;
+
+	m1 = sums->s[0] / n;
+	m2 = sums->s[1] / n;
+	m3 = sums->s[2] / n;
+	m4 = sums->s[3] / n;
+	c2 = m2 - m1*m1;
+	c3 = m3 - 3.0*m1*m2 + 2.0*m1*m1*m1;
+	c4 = m4 - 4.0*m1*m3 + 6.0*m1*m1*m2 - 3.0*m1*m1*m1*m1;
+
+	value[0] = m1;
+	exact[0] = 0.0;
+	stderror[0] = sqrt(1.0 / n);
+
+	value[1] = c2;
+	exact[1] = 1.0;
+	stderror[1] = sqrt(2.0 / n);
+
+	value[2] = c3 / pow(c2, 1.5);
+	exact[2] = 0.0;
+	stderror[2] = sqrt(6.0 / n);
+
+	value[3] = c4 / (c2*c2) - 3.0;
+	exact[3] = 0.0;
+	stderror[3] = sqrt(24.0 / n);
+
+	value[4] = sums->beyond3 / n;
+	exact[4] = erfc(3.0*M_SQRT1_2);
+	value[5] = sums->beyond4 / n;
+	exact[5] = erfc(4.0*M_SQRT1_2);
+	for (i = 4; i < 6; ++i)
+		stderror[i] = sqrt(exact[i] * (1.0 - exact[i]) / n);
+
+	value[6] = chi_square(sums->nbin, n);
+	exact[6] = CHECK_BINS - 1;
+	stderror[6] = sqrt(2.0 * (CHECK_BINS - 1));
+
+	// the tail beyond the base layer, and the distance into it (the mean
+	// and variance of a normal number truncated to x > rz)
+	p = erfc(rz*M_SQRT1_2);
+	value[7] = sums->tail / n;
+	exact[7] = p;
+	stderror[7] = sqrt(p * (1.0 - p) / n);
+
+	lambda = 2.0 * exp(-0.5*rz*rz) / sqrt(2.0*M_PI) / p;
+	value[8] = (sums->tail > 0.0) ? sums->excess / sums->tail : 0.0;
+	exact[8] = lambda - rz;
+	stderror[8] = sqrt((1.0 + rz*lambda - lambda*lambda) / (p*n));
+
+	value[9] = sums->u[0] / n;
+	exact[9] = 0.5;
+	stderror[9] = sqrt(1.0 / (12.0*n));
+
+	value[10] = sums->u[1] / n - value[9]*value[9];
+	exact[10] = 1.0 / 12.0;
+	stderror[10] = sqrt((1.0/80.0 - 1.0/144.0) / n);
+
+	value[11] = chi_square(sums->ubin, n);
+	exact[11] = CHECK_BINS - 1;
+	stderror[11] = sqrt(2.0 * (CHECK_BINS - 1));
+}
+
+double chi_square(const double *bin, long n) {
+	const double expected = (double)n / CHECK_BINS;
+	double chi2 = 0.0;
+	int i;
+
+	for (i = 0; i < CHECK_BINS; ++i)
+		chi2 += (bin[i] - expected) * (bin[i] - expected) / expected;
+	return chi2;
+}
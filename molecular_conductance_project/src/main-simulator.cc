@@ -14,54 +14,297 @@ Copyright (C) 2013 Oak Ridge National Laboratory
  * on the command-line and used to simulate conductance data. This data can
  * subsequently be binned into a histogram to test the fitting procedures.
  *
- * Two models are presently implemented:
- *    - Symmetric couplings (same coupling used for the left and right leads).
- *    - Asymmetric couplings (different couplings for the two leads).
+ * One program provides all of the Lorentzian simulators; the variant is
+ * chosen by the name the program is run as (the Makefile links each name to
+ * it) or by `--variant NAME'. Each variant is a combination of the policies
+ * in simulator-policies.h, instantiated at compile time.
+ *    - `simulator': conductance at zero bias, for symmetric (`s') or
+ *      asymmetric (`a') couplings. Arguments: model n EF depsilon epsilon0
+ *      dgamma gamma1 [gamma2].
+ *    - `sim-v-1d': as `simulator', at a fixed bias. Arguments: model n EF
+ *      depsilon epsilon0 dgamma gamma1 [gamma2] [V eta]; without V and eta
+ *      there is no bias.
+ *    - `sim-v-2d': n trials at each voltage of a grid. Arguments: n EF
+ *      depsilon epsilon0 dgamma gamma0 Vmin Vmax Vstep eta.
+ *    - `sim-v-2d-rng': a uniformly random voltage for each trial. Arguments:
+ *      n EF depsilon epsilon0 dgamma gamma0 Vmin Vmax eta.
+ *    - `sim-v-2d-betad': as `sim-v-2d-rng', with a beta-distributed eta.
+ *      Arguments: n EF depsilon epsilon0 dgamma gamma0 Vmin Vmax eta_alpha
+ *      eta_beta.
+ *    - `sim-v-2d-updated': as `sim-v-2d-rng', with an average site level
+ *      energy linear in the voltage. Arguments: n EF depsilon mepsilon
+ *      bepsilon dgamma gamma0 Vmin Vmax eta.
  *
- * There are seven or eight required command-line arguments, depending on the
- * model:
- *    -# The model to use (`s' for symmetric, `a' for asymmetric).
- *    -# The number of conductance data points to simulate.
- *    -# The Fermi level of the system (eV)
- *    -# The standard deviation in site level energy (eV)
- *    -# The average site level energy (eV)
- *    -# The standard deviation in electrode-channel coupling (eV)
- *    -# The average coupling to one electrode (asymmetric model) or to both
- *       electrodes (symmetric model), in eV.
- *    -# The average coupling to the other electrode (eV). Only required if the
- *       asymmetric model is used.
+ * Run a variant without arguments for a description of them. The `sim-v-2d'
+ * variants use symmetric couplings and output lines of voltage and
+ * conductance; the others output one conductance per line.
+ *
+ * Optional arguments may be given before or after the required ones:
+ *    - `--variant NAME' selects the variant, overriding the program name.
+ *    - `--format F' selects the output format: `text' (default), or `f64' /
+ *      `f32' for a binary sample stream (see sample-stream.h) with the
+ *      columns `V' (2D variants only) and `G'.
+ *    - `--sampler S' is `pseudo' (default) for pseudo-random parameters or
+ *      `sobol' for scrambled Sobol points (see sobol.h), whose histograms
+ *      converge faster. A beta-distributed eta is always pseudo-random.
+ *    - `--replica R' selects the Sobol scrambling (default 0). Runs with
+ *      different R are independent, and the spread of their results
+ *      estimates the error. Only with `--sampler sobol'.
+ *    - `--rng NAME' selects the pseudo-random generator: `xoshiro'
+ *      (default), `pcg64', `philox', or `gsl:NAME' for a GSL generator such
+ *      as `gsl:mt19937' (see sampler.h). A GSL generator only supplies the
+ *      raw words, so its trials are not those of the original programs; for
+ *      those, use
+ *    - `--legacy', which draws every number with gsl_rng_uniform(),
+ *      gsl_ran_gaussian(), and gsl_ran_beta() from one stream of GSL's
+ *      default generator (set by GSL_RNG_TYPE), seeded with 0xFEEDFACE, trial
+ *      by trial, as the original programs did (see legacy_source). It cannot
+ *      be combined with `--sampler sobol'.
+ *    - `--per-junction' (`sim-v-2d' only) draws each of the n junctions once
+ *      and evaluates it at every voltage of the grid, instead of drawing new
+ *      parameters for each voltage. The lines are output junction by
+ *      junction, so each junction's conductance-voltage trace is a run of
+ *      consecutive lines.
+ *    - `--pdf NAME FILE' draws the parameter NAME (`gamma1', also called
+ *      `gamma0'; `gamma2'; or `epsilon') from the measured distribution in
+ *      FILE instead of a normal distribution (see distributions.h). For
+ *      `sim-v-2d-updated', the distribution of epsilon is that of its
+ *      fluctuation about mepsilon V + bepsilon. The option may be repeated
+ *      for different parameters.
+ *
+ * final-sim-v-2d, which evaluates its models with vectorized batch kernels
+ * (see conductance.h) and adds threads and histograms, is separate.
  *
  * \author Patrick D.\ Williams and Matthew G.\ Reuter
- * \date July 2012, May 2013
+ * \date July 2012, May 2013, October 2026
  */
 
 #include <cstdio>
 #include <cstdlib>
-#include <gsl/gsl_rng.h>
-#include <gsl/gsl_randist.h>
+#include <cstring>
+#include <cstddef>
+#include "distributions.h"
+#include "parallel.h"
+#include "sampler.h"
+#include "sample-stream.h"
+#include "simulation.h"
+#include "simulator-policies.h"
+#include "sobol.h"
+#include "text-format.h"
+
+/// The most arguments of any variant, including the program name.
+#define SIMULATOR_MAX_ARGS 11
+
+/**
+ * \brief The simulator variants.
+ */
+typedef enum {
+	/// `simulator'
+	VARIANT_ZERO_BIAS,
+
+	/// `sim-v-1d'
+	VARIANT_FIXED_BIAS,
+
+	/// `sim-v-2d'
+	VARIANT_GRID,
+
+	/// `sim-v-2d-rng'
+	VARIANT_UNIFORM,
+
+	/// `sim-v-2d-betad'
+	VARIANT_BETA_ETA,
+
+	/// `sim-v-2d-updated'
+	VARIANT_LINEAR_EPSILON,
+
+	/// The number of variants.
+	VARIANT_COUNT
+} en_variant;
+
+/**
+ * \brief The command-line description of a variant.
+ */
+typedef struct {
+	/// The program name.
+	const char *name;
+
+	/// Whether the first argument is the model (`s' or `a').
+	bool model;
+
+	/// The required arguments after the model, by name; for the asymmetric
+	/// model, gamma2 follows gamma1.
+	const char *args;
+
+	/// Whether `V eta' may follow the required arguments.
+	bool bias;
+
+	/// Whether the voltage is output.
+	bool voltage;
+
+	/// The usage message.
+	const char *usage;
+} st_variant;
+
+/// The variants, in the order of en_variant.
+static const st_variant variants[VARIANT_COUNT] = {
+	{"simulator", true, "n EF depsilon epsilon0 dgamma gamma1", false, false,
+		"Usage error: ./simulator model n EF deps eps0 dgamma gamma1 gamma2\n" \
+		"   model is the model to use ('s' for symmetric, 'a' for " \
+			"asymmetric)\n" \
+		"   n is the number of trials\n" \
+		"   EF is the Fermi level (eV)\n" \
+		"   deps is the standard deviation in site level energy (eV)\n" \
+		"   eps0 is the average site level energy (eV)\n" \
+		"   dgamma is the standard deviation in the coupling (eV)\n" \
+		"   gamma1 is the average coupling for one electrode (eV)\n" \
+		"   gamma2 is the average coupling for the other electrode (eV)\n" \
+		"\n   NOTE: gamma2 is ignored (and unnecessary) if model == 's'.\n"},
+	{"sim-v-1d", true, "n EF depsilon epsilon0 dgamma gamma1", true, false,
+		"Usage error: ./sim-v-1d model n EF depsilon epsilon0 dgamma " \
+			"gamma1 gamma2 V eta\n" \
+		"   model is the model to use ('s' for symmetric, 'a' for " \
+			"asymmetric)\n" \
+		"   n is the number of trials\n" \
+		"   EF is the Fermi level (eV)\n" \
+		"   depsilon is the standard deviation in site level energy (eV)\n" \
+		"   epsilon0 is the average site level energy (eV)\n" \
+		"   dgamma is the standard deviation in the coupling (eV)\n" \
+		"   gamma1 is the average coupling for one electrode (eV)\n" \
+		"   gamma2 is the average coupling for the other electrode (eV)\n" \
+		"   V is the applied bias (V)\n" \
+		"   eta is the relative voltage drop for one electrode\n" \
+		"\n   NOTES: gamma2 is ignored (and unnecessary) if model == 's'." \
+		"\n          V and eta are used together and are optional;" \
+		"\n              if not specified no bias is assumed.\n"},
+	{"sim-v-2d", false,
+		"n EF depsilon epsilon0 dgamma gamma0 Vmin Vmax Vstep eta", false, true,
+		"Usage error: ./sim-v-2d n EF depsilon epsilon0 dgamma " \
+			"gamma0 Vmin Vmax Vstep eta\n" \
+		"   n is the number of trials at each voltage\n" \
+		"   EF is the Fermi level (eV)\n" \
+		"   depsilon is the standard deviation in site level energy (eV)\n" \
+		"   epsilon0 is the average site level energy (eV)\n" \
+		"   dgamma is the standard deviation in the coupling (eV)\n" \
+		"   gamma0 is the average coupling for one electrode (eV)\n" \
+		"   Vmin is the lower bound of the applied bias range (V)\n" \
+		"   Vmax is the upper bound of the applied bias range (V)\n" \
+		"   Vstep is the step size for evaluating the bias range (V)\n" \
+		"   eta is the relative voltage drop for one electrode\n" \
+		"\n   NOTE: symmetric model is assumed - coupling is the same for " \
+			"both electrodes.\n"},
+	{"sim-v-2d-rng", false,
+		"n EF depsilon epsilon0 dgamma gamma0 Vmin Vmax eta", false, true,
+		"Usage error: ./sim-v-2d-rng n EF depsilon epsilon0 dgamma " \
+			"gamma0 Vmin Vmax eta\n" \
+		"   n is the number of trials\n" \
+		"   EF is the Fermi level (eV)\n" \
+		"   depsilon is the standard deviation in site level energy (eV)\n" \
+		"   epsilon0 is the average site level energy (eV)\n" \
+		"   dgamma is the standard deviation in the coupling (eV)\n" \
+		"   gamma0 is the average coupling for one electrode (eV)\n" \
+		"   Vmin is the lower bound of the applied bias range (V)\n" \
+		"   Vmax is the upper bound of the applied bias range (V)\n" \
+		"   eta is the relative voltage drop for one electrode\n" \
+		"\n   NOTE: symmetric model is assumed - coupling is the same for " \
+			"both electrodes.\n"},
+	{"sim-v-2d-betad", false,
+		"n EF depsilon epsilon0 dgamma gamma0 Vmin Vmax eta_alpha eta_beta",
+		false, true,
+		"Usage error: ./sim-v-2d-betad n EF depsilon epsilon0 dgamma \n" \
+		"                 gamma0 Vmin Vmax eta_alpha eta_beta\n" \
+		"   n is the number of trials\n" \
+		"   EF is the Fermi level (eV)\n" \
+		"   depsilon is the standard deviation in site level energy (eV)\n" \
+		"   epsilon0 is the average site level energy (eV)\n" \
+		"   dgamma is the standard deviation in the coupling (eV)\n" \
+		"   gamma0 is the average coupling for one electrode (eV)\n" \
+		"   Vmin is the lower bound of the applied bias range (V)\n" \
+		"   Vmax is the upper bound of the applied bias range (V)\n" \
+		"   eta_alpha and eta_beta are the parameters of the beta " \
+			"distribution\n" \
+		"      here varying eta, the relative voltage drop for one " \
+			"electrode\n\n" \
+		"NOTE: symmetric model is assumed - coupling is the same for both " \
+			"electrodes.\n"},
+	{"sim-v-2d-updated", false,
+		"n EF depsilon mepsilon bepsilon dgamma gamma0 Vmin Vmax eta", false,
+		true,
+		"Usage error: ./sim-v-2d-updated n EF depsilon mepsilon bepsilon " \
+			"dgamma\n" \
+		"                 gamma0 Vmin Vmax eta\n" \
+		"   n is the number of trials\n" \
+		"   EF is the Fermi level (eV)\n" \
+		"   depsilon is the standard deviation in site level energy (eV)\n" \
+		"   epsilon0 is the average site level energy (eV);\n" \
+		"      here it is assumed to be a linear function of the applied " \
+			"bias;\n" \
+		"      epsilon0 = mepsilon * V + bepsilon\n" \
+		"   dgamma is the standard deviation in the coupling (eV)\n" \
+		"   gamma0 is the average coupling for one electrode (eV)\n" \
+		"   Vmin is the lower bound of the applied bias range (V)\n" \
+		"   Vmax is the upper bound of the applied bias range (V)\n" \
+		"   eta is the relative voltage drop for one electrode\n\n" \
+		"NOTE: symmetric model is assumed - coupling is the same for both " \
+			"electrodes.\n"}
+};
+
+/// The options, which every variant accepts.
+static const char *options_usage =
+	"\n   Options:\n" \
+	"   --variant NAME selects the variant (default: the program name)\n" \
+	"   --format F is 'text' (default), 'f64', or 'f32'\n" \
+	"   --sampler S is 'pseudo' (default) or 'sobol'\n" \
+	"   --replica R selects the Sobol scrambling\n" \
+	"   --rng NAME is 'xoshiro' (default), 'pcg64', 'philox', or " \
+		"'gsl:NAME'\n" \
+	"      ('gsl:NAME' is not bit-compatible with the original output)\n" \
+	"   --legacy draws the trials as the original programs did\n" \
+	"   --per-junction evaluates each junction at every voltage (sim-v-2d " \
+		"only)\n" \
+	"   --pdf NAME FILE draws gamma1, gamma2, or epsilon from a measured " \
+		"distribution\n";
 
 /**
- * \brief Samples from a normal distribution with the given mean and standard
- *        deviation.
+ * \brief Finds a variant by program name.
  *
- * \param[in] mean The distribution's average.
- * \param[in] stdev The distribution's standard deviation.
- * \param[in] r The internal workspace for GSL's random number generation.
- * \return The random number.
+ * \param[in] name The name, possibly with a directory.
+ * \return The variant, or VARIANT_COUNT if the name is unknown.
  */
-double normal_random_variable(double mean, double stdev, gsl_rng *r);
+en_variant find_variant(const char *name);
 
 /**
- * \brief Evalutates the transmission (Landauer theory) using the specified
- *        physical parameters.
- * 
- * \param[in] gamma1 One channel-lead coupling.
- * \param[in] gamma2 The other channel-lead coupling.
- * \param[in] epsilon The channel's level energy.
- * \param[in] E The Fermi level.
- * \return The transmission.
+ * \brief Gets the location of a named parameter.
+ *
+ * \param[in] p The parameters.
+ * \param[in] name The parameter's name on the command line.
+ * \param[in] len The length of the name.
+ * \return The parameter, or NULL if the name is unknown.
+ */
+double *param_by_name(st_sim_params *p, const char *name, size_t len);
+
+/**
+ * \brief Runs the simulation for a variant, with the policies it stands for.
+ *
+ * \param[in] variant The variant.
+ * \param[in] model `s' or `a' (`simulator' and `sim-v-1d' only).
+ * \param[in] junctions Whether to evaluate each junction at every voltage
+ *            (`sim-v-2d' only).
+ * \param[in] p The parameters.
+ * \param[in,out] src The source of random numbers.
+ * \param[in,out] out Where the trials go.
  */
-double transmission(double gamma1, double gamma2, double epsilon, double E);
+template <class Source>
+void run_variant(en_variant variant, char model, bool junctions,
+	const st_sim_params *p, Source *src, st_sim_output *out);
+
+/**
+ * \brief Gets the number of random numbers drawn per trial by a variant.
+ *
+ * \param[in] variant The variant.
+ * \param[in] model `s' or `a' (`simulator' and `sim-v-1d' only).
+ * \return The number of random numbers (Sobol dimensions).
+ */
+int variant_draws(en_variant variant, char model);
 
 /**
  * \brief Main function for simulating a histogram.
@@ -74,118 +317,430 @@ double transmission(double gamma1, double gamma2, double epsilon, double E);
  * \return Exit status; 0 for normal.
  */
 int main(int argc, char **argv) {
-	const gsl_rng_type *T;
-	gsl_rng *r;
-     
-	int i, n;
-	double gammaL, gammaR, epsilon, trans;
-	double gamma1, gamma2;
-	double dgamma;
-	double epsilon0;
-	double depsilon;
-	double E;
-	char model;
-
-	if(argc != 8 && argc != 9) {
-		fprintf(stderr, "Usage error: ./simulator model n EF deps eps0 dgamma " \
-			"gamma1 gamma2 n\n" \
-			"   model is the model to use ('s' for symmetric, 'a' for " \
-				"asymmetric)\n" \
-			"   n is the number of trials\n" \
-			"   EF is the Fermi level (eV)\n" \
-			"   deps is the standard deviation in site level energy (eV)\n" \
-			"   eps0 is the average site level energy (eV)\n" \
-			"   dgamma is the standard deviation in the coupling (eV)\n" \
-			"   gamma1 is the average coupling for one electrode (eV)\n" \
-			"   gamma2 is the average coupling for the other electrode (eV)\n" \
-			"\n   NOTE: gamma2 is ignored (and unnecessary) if model == 's'.\n");
+	en_variant variant;
+	const st_variant *v;
+	en_format format;
+	en_sampling sampling;
+	unsigned long replica;
+	st_rng rng;
+	st_sim_params p;
+	st_sim_output out;
+	pseudo_source pseudo;
+	sobol_source *sobol;
+	legacy_source legacy;
+	st_empirical_dist *gamma1_pdf, *gamma2_pdf, *epsilon_pdf;
+	st_empirical_dist **pdf;
+
+	int i, nargs, nrequired, first;
+	bool junctions, legacy_draws, replica_given;
+	char *args[SIMULATOR_MAX_ARGS];
+	char model, param[32];
+	const char *name, *end;
+	double *x;
+
+	// pull out the optional arguments
+	variant = find_variant(argv[0]);
+	format = FORMAT_TEXT;
+	sampling = SAMPLING_PSEUDO;
+	replica = 0;
+	parse_rng("xoshiro", &rng);
+	junctions = false;
+	legacy_draws = false;
+	replica_given = false;
+	gamma1_pdf = gamma2_pdf = epsilon_pdf = NULL;
+	nargs = 0;
+	for (i = 0; i < argc; ++i) {
+		if (strcmp(argv[i], "--variant") == 0 && i + 1 < argc) {
+			variant = find_variant(argv[++i]);
+			if (variant == VARIANT_COUNT) {
+				fprintf(stderr, "Error: Unknown variant: '%s'.\n", argv[i]);
+				return 0;
+			}
+		}
+		else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+			if (stream_parse_format(argv[++i], &format)) {
+				fprintf(stderr, "Error: Unknown format: '%s'.\n", argv[i]);
+				return 0;
+			}
+		}
+		else if (strcmp(argv[i], "--sampler") == 0 && i + 1 < argc) {
+			if (parse_sampling(argv[++i], &sampling)) {
+				fprintf(stderr, "Error: Unknown sampler: '%s'.\n", argv[i]);
+				return 0;
+			}
+		}
+		else if (strcmp(argv[i], "--replica") == 0 && i + 1 < argc) {
+			replica = strtoul(argv[++i], NULL, 10);
+			replica_given = true;
+		}
+		else if (strcmp(argv[i], "--rng") == 0 && i + 1 < argc) {
+			if (parse_rng(argv[++i], &rng)) {
+				fprintf(stderr, "Error: Unknown generator: '%s'.\n", argv[i]);
+				return 0;
+			}
+		}
+		else if (strcmp(argv[i], "--per-junction") == 0)
+			junctions = true;
+		else if (strcmp(argv[i], "--legacy") == 0)
+			legacy_draws = true;
+		else if (strcmp(argv[i], "--pdf") == 0 && i + 2 < argc) {
+			if (strcmp(argv[++i], "gamma1") == 0 ||
+				strcmp(argv[i], "gamma0") == 0) {
+
+				pdf = &gamma1_pdf;
+			}
+			else if (strcmp(argv[i], "gamma2") == 0)
+				pdf = &gamma2_pdf;
+			else if (strcmp(argv[i], "epsilon") == 0)
+				pdf = &epsilon_pdf;
+			else {
+				fprintf(stderr, "Error: Unknown parameter: '%s'.\n", argv[i]);
+				return 0;
+			}
+			empirical_dist_free(*pdf);
+			*pdf = empirical_dist_read(argv[++i]);
+			if (*pdf == NULL) {
+				fprintf(stderr, "Error: Cannot read a distribution from " \
+					"'%s'.\n", argv[i]);
+				return 0;
+			}
+		}
+		else if (nargs < SIMULATOR_MAX_ARGS)
+			args[nargs++] = argv[i];
+		else
+			++nargs;
+	}
+	argc = nargs;
+	argv = args;
+
+	// an unknown program name acts as `simulator'
+	if (variant == VARIANT_COUNT)
+		variant = VARIANT_ZERO_BIAS;
+	v = &variants[variant];
+
+	// count the required arguments
+	nrequired = 1;
+	for (name = v->args; *name != '\0'; name = end) {
+		end = name + strcspn(name, " ");
+		++nrequired;
+		end += strspn(end, " ");
+	}
+	model = 's';
+	first = 1;
+	if (v->model) {
+		++nrequired;
+		if (argc > 1)
+			model = argv[1][0];
+		if (model == 'a')
+			++nrequired;
+		first = 2;
+	}
+
+	if (argc != nrequired && !(v->bias && argc == nrequired + 2)) {
+		fprintf(stderr, "%s%s", v->usage, options_usage);
 		return 0;
 	}
 
-	model = argv[1][0];
-	if(model != 'a' && model != 's') {
+	if (v->model && model != 'a' && model != 's') {
 		fprintf(stderr, "Error: Unknown model. Must be 's' or 'a'.\n");
 		return 0;
 	}
 
-	n = atoi(argv[2]);
-	E = atof(argv[3]);
-	depsilon = atof(argv[4]);
-	epsilon0 = atof(argv[5]);
-	dgamma = atof(argv[6]);
-	gamma1 = atof(argv[7]);
-	if(model == 'a') {
-		if(argc == 9)
-			gamma2 = atof(argv[8]);
+	// the required arguments, by name
+	memset(&p, 0, sizeof(p));
+	i = first;
+	for (name = v->args; *name != '\0'; name = end) {
+		end = name + strcspn(name, " ");
+		if (strncmp(name, "n", end - name) == 0)
+			p.n = atol(argv[i]);
 		else {
-			fprintf(stderr, "Error: Not enough parameters for the asymmetric " \
-				"model.\n       Run ./simulator for the correct usage.\n");
-			return 0;
+			x = param_by_name(&p, name, end - name);
+			*x = atof(argv[i]);
 		}
+		++i;
+		if (model == 'a' && strncmp(name, "gamma1", end - name) == 0)
+			p.gamma2 = atof(argv[i++]);
+		end += strspn(end, " ");
+	}
+	if (v->bias && argc == nrequired + 2) {
+		p.V = atof(argv[i]);
+		p.eta = atof(argv[i + 1]);
 	}
 
-	if(depsilon <= 0.0 || dgamma <= 0.0) {
+	if (p.depsilon <= 0.0 || p.dgamma <= 0.0) {
 		fprintf(stderr, "Error: standard deviations must be positive.\n");
 		return 0;
 	}
 
-	if(gamma1 <= 0.0) {
-		fprintf(stderr, "Error: gamma1 must be positive.\n");
+	if (p.gamma1 <= 0.0) {
+		fprintf(stderr, "Error: %s must be positive.\n",
+			v->model ? "gamma1" : "gamma0");
 		return 0;
 	}
 
-	if(model == 'a' && gamma2 <= 0.0) {
+	if (model == 'a' && p.gamma2 <= 0.0) {
 		fprintf(stderr, "Error: gamma2 must be positive.\n");
 		return 0;
 	}
 
-	if(n <= 0) {
+	if (p.n <= 0) {
 		fprintf(stderr, "Error: There must be at least one trial.\n");
 		return 0;
 	}
 
-	if(gamma1 / dgamma < 4.0 || (model == 'a' && gamma2 / dgamma < 4.0)) {
+	p.gamma1_pdf = gamma1_pdf;
+	p.gamma2_pdf = gamma2_pdf;
+	p.epsilon_pdf = epsilon_pdf;
+	if (gamma2_pdf != NULL && model != 'a') {
+		fprintf(stderr, "Error: gamma2 needs the asymmetric model.\n");
+		return 0;
+	}
+
+	if ((gamma1_pdf == NULL && p.gamma1 / p.dgamma < 4.0) ||
+		(model == 'a' && gamma2_pdf == NULL && p.gamma2 / p.dgamma < 4.0)) {
+
 		fprintf(stderr, "Warning: The models assume gamma1(2) / dgamma >> 0; " \
 			"bigger than 4, in practice.\n");
 	}
 
-	// Setup the GSL random number generator
-	gsl_rng_env_setup();
-	T = gsl_rng_default;
-	r = gsl_rng_alloc(T);
+	if (!v->model && p.Vmin > p.Vmax) {
+		fprintf(stderr, "Error: Vmin is lower bound, Vmax is upper bound; " \
+			"Vmax > Vmin.\n");
+		return 0;
+	}
+
+	if (variant == VARIANT_GRID && p.Vstep <= 0.0) {
+		fprintf(stderr, "Error: The step size must be positive.\n");
+		return 0;
+	}
 
-	// seed the generator
-	gsl_rng_set(r, 0xFEEDFACE);
+	if (replica_given && sampling != SAMPLING_SOBOL) {
+		fprintf(stderr, "Error: --replica goes with --sampler sobol.\n");
+		return 0;
+	}
 
-	// Get the requested number of transmission values
-	for (i = 0; i < n; ++i) {
-		gammaL = normal_random_variable(gamma1, dgamma, r);
-		epsilon = normal_random_variable(epsilon0, depsilon, r);
+	if (legacy_draws && sampling == SAMPLING_SOBOL) {
+		fprintf(stderr, "Error: --legacy cannot be combined with --sampler " \
+			"sobol.\n");
+		return 0;
+	}
 
-		if(model == 's') {
-			trans = transmission(gammaL, gammaL, epsilon, E);
+	if (junctions && variant != VARIANT_GRID) {
+		fprintf(stderr, "Error: --per-junction needs the voltage grid of " \
+			"sim-v-2d.\n");
+		return 0;
+	}
+
+	if (variant == VARIANT_BETA_ETA) {
+		if (p.eta_alpha <= 1.0 || p.eta_beta <= 1.0) {
+			fprintf(stderr, "Warning: Model assumes beta distribution is " \
+				"unimodal; eta_alpha, eta_beta > 1.\n");
 		}
-		else if(model == 'a') {
-			gammaR = normal_random_variable(gamma2, dgamma, r);
-			trans = transmission(gammaL, gammaR, epsilon, E);
+	}
+	else if (p.eta > 1.0 || p.eta < 0.0) {
+		fprintf(stderr, "Error: eta is a relative voltage drop on one side; " \
+			"0 <= eta <= 1.\n");
+		return 0;
+	}
+
+	// Setup the random number sampler
+	pseudo.r = sampler_alloc_rng(&rng);
+	sampler_set(pseudo.r, 0xFEEDFACE);
+	sobol = NULL;
+	if (sampling == SAMPLING_SOBOL) {
+		sobol = (sobol_source*)malloc(sizeof(sobol_source));
+		sobol_init(&sobol->s, variant_draws(variant, model), replica);
+	}
+
+	// the original programs' stream, which eta shares
+	legacy.r = NULL;
+	if (legacy_draws) {
+		gsl_rng_env_setup();
+		legacy.r = gsl_rng_alloc(gsl_rng_default);
+		gsl_rng_set(legacy.r, 0xFEEDFACE);
+		sampling = SAMPLING_LEGACY;
+	}
+
+	// otherwise eta has its own stream, so that it does not shift the other
+	// draws; GSL is still used for a beta distribution that cannot be
+	// tabulated
+	p.eta_dist = NULL;
+	p.eta_r = NULL;
+	p.beta_rng = NULL;
+	if (variant == VARIANT_BETA_ETA && legacy_draws)
+		p.beta_rng = legacy.r;
+	else if (variant == VARIANT_BETA_ETA) {
+		p.eta_dist = beta_dist_alloc(p.eta_alpha, p.eta_beta);
+		if (p.eta_dist != NULL) {
+			p.eta_r = sampler_alloc_rng(&rng);
+			sampler_set(p.eta_r, 0xFEEDFACE + 1);
 		}
 		else {
-			fprintf(stderr, "An impossible error has occurred.\n");
-			trans = 0.0;
+			gsl_rng_env_setup();
+			p.beta_rng = gsl_rng_alloc(gsl_rng_default);
+			gsl_rng_set(p.beta_rng, 0xFEEDFACE);
 		}
+	}
 
-		printf("%.6f\n", trans);
+	out.format = format;
+	out.voltage = v->voltage;
+	out.text = text_output_alloc(stdout);
+	if (format != FORMAT_TEXT) {
+		stream_header_init(&out.header, v->model ? argv[1] : "s",
+			TRIALS_PER_BATCH);
+		i = first;
+		for (name = v->args; *name != '\0'; name = end) {
+			end = name + strcspn(name, " ");
+			snprintf(param, sizeof(param), "%.*s", (int)(end - name), name);
+			stream_header_param(&out.header, param, atof(argv[i++]));
+			if (model == 'a' && strncmp(name, "gamma1", end - name) == 0)
+				stream_header_param(&out.header, "gamma2", p.gamma2);
+			end += strspn(end, " ");
+		}
+		if (v->bias) {
+			stream_header_param(&out.header, "V", p.V);
+			stream_header_param(&out.header, "eta", p.eta);
+		}
+		if (sampling == SAMPLING_SOBOL)
+			stream_header_param(&out.header, "replica", replica);
+		if (legacy_draws)
+			stream_header_param(&out.header, "legacy", 1);
+		if (junctions)
+			stream_header_param(&out.header, "per_junction", 1);
+		if (gamma1_pdf != NULL)
+			stream_header_param(&out.header, "pdf_gamma1", 1);
+		if (gamma2_pdf != NULL)
+			stream_header_param(&out.header, "pdf_gamma2", 1);
+		if (epsilon_pdf != NULL)
+			stream_header_param(&out.header, "pdf_epsilon", 1);
+		if (v->voltage)
+			stream_header_column(&out.header, "V", format);
+		stream_header_column(&out.header, "G", format);
+		stream_write_header(stdout, &out.header);
 	}
 
-	gsl_rng_free(r);
+	if (sampling == SAMPLING_SOBOL)
+		run_variant(variant, model, junctions, &p, sobol, &out);
+	else if (sampling == SAMPLING_LEGACY)
+		run_variant(variant, model, junctions, &p, &legacy, &out);
+	else
+		run_variant(variant, model, junctions, &p, &pseudo, &out);
+
+	text_output_free(out.text);
+	if (format != FORMAT_TEXT)
+		stream_write_end(stdout);
+
+	if (p.eta_dist != NULL) {
+		beta_dist_free(p.eta_dist);
+		sampler_free(p.eta_r);
+	}
+	if (p.beta_rng != NULL && p.beta_rng != legacy.r)
+		gsl_rng_free(p.beta_rng);
+	if (legacy.r != NULL)
+		gsl_rng_free(legacy.r);
+	free(sobol);
+	sampler_free(pseudo.r);
+	empirical_dist_free(gamma1_pdf);
+	empirical_dist_free(gamma2_pdf);
+	empirical_dist_free(epsilon_pdf);
 	return 0;
 }
 
-double normal_random_variable(double mean, double stdev, gsl_rng *r) {
-	return gsl_ran_gaussian(r, stdev) + mean;
+en_variant find_variant(const char *name) {
+	const char *base = strrchr(name, '/');
+	int i;
+
+	base = (base == NULL) ? name : base + 1;
+	for (i = 0; i < VARIANT_COUNT; ++i)
+		if (strcmp(base, variants[i].name) == 0)
+			return (en_variant)i;
+	return VARIANT_COUNT;
+}
+
+double *param_by_name(st_sim_params *p, const char *name, size_t len) {
+	static const struct {
+		const char *name;
+		size_t offset;
+	} table[] = {
+		{"EF", offsetof(st_sim_params, EF)},
+		{"depsilon", offsetof(st_sim_params, depsilon)},
+		{"epsilon0", offsetof(st_sim_params, epsilon0)},
+		{"mepsilon", offsetof(st_sim_params, mepsilon)},
+		{"bepsilon", offsetof(st_sim_params, bepsilon)},
+		{"dgamma", offsetof(st_sim_params, dgamma)},
+		{"gamma0", offsetof(st_sim_params, gamma1)},
+		{"gamma1", offsetof(st_sim_params, gamma1)},
+		{"Vmin", offsetof(st_sim_params, Vmin)},
+		{"Vmax", offsetof(st_sim_params, Vmax)},
+		{"Vstep", offsetof(st_sim_params, Vstep)},
+		{"eta", offsetof(st_sim_params, eta)},
+		{"eta_alpha", offsetof(st_sim_params, eta_alpha)},
+		{"eta_beta", offsetof(st_sim_params, eta_beta)}
+	};
+	size_t i;
+
+	for (i = 0; i < sizeof(table) / sizeof(table[0]); ++i)
+		if (strlen(table[i].name) == len &&
+			strncmp(table[i].name, name, len) == 0)
+			return (double*)((char*)p + table[i].offset);
+	return NULL;
+}
+
+template <class Source>
+void run_variant(en_variant variant, char model, bool junctions,
+	const st_sim_params *p, Source *src, st_sim_output *out) {
+
+	switch (variant) {
+	case VARIANT_ZERO_BIAS:
+		if (model == 'a')
+			simulate<model_pair_asymmetric, voltage_none, eta_fixed,
+				epsilon_fixed, order_standard>(p, src, out);
+		else
+			simulate<model_pair_symmetric, voltage_none, eta_fixed,
+				epsilon_fixed, order_standard>(p, src, out);
+		break;
+	case VARIANT_FIXED_BIAS:
+		if (model == 'a')
+			simulate<model_pair_asymmetric, voltage_fixed, eta_fixed,
+				epsilon_fixed, order_standard>(p, src, out);
+		else
+			simulate<model_pair_symmetric, voltage_fixed, eta_fixed,
+				epsilon_fixed, order_standard>(p, src, out);
+		break;
+	case VARIANT_GRID:
+		if (junctions)
+			simulate_junctions<model_symmetric, order_standard>(p, src, out);
+		else
+			simulate<model_symmetric, voltage_grid, eta_fixed, epsilon_fixed,
+				order_standard>(p, src, out);
+		break;
+	case VARIANT_UNIFORM:
+		simulate<model_symmetric, voltage_uniform, eta_fixed, epsilon_fixed,
+			order_standard>(p, src, out);
+		break;
+	case VARIANT_BETA_ETA:
+		simulate<model_symmetric, voltage_uniform, eta_beta, epsilon_fixed,
+			order_voltage_last>(p, src, out);
+		break;
+	case VARIANT_LINEAR_EPSILON:
+		simulate<model_symmetric, voltage_uniform, eta_fixed, epsilon_linear,
+			order_epsilon_first>(p, src, out);
+		break;
+	default:
+		break;
+	}
 }
 
-double transmission(double gamma1, double gamma2, double epsilon, double E) {
-	return 4.0*gamma1*gamma2 / 
-		(4.0*(E-epsilon)*(E-epsilon) + (gamma1 + gamma2)*(gamma1 + gamma2));
+int variant_draws(en_variant variant, char model) {
+	switch (variant) {
+	case VARIANT_ZERO_BIAS:
+	case VARIANT_FIXED_BIAS:
+		return (model == 'a') ?
+			simulate_draws<model_pair_asymmetric, voltage_fixed>() :
+			simulate_draws<model_pair_symmetric, voltage_fixed>();
+	case VARIANT_GRID:
+		return simulate_draws<model_symmetric, voltage_grid>();
+	default:
+		return simulate_draws<model_symmetric, voltage_uniform>();
+	}
 }
@@ -0,0 +1,480 @@
+/*
+This work is licensed under the Creative Commons Attribution 3.0 United States
+License. To view a copy of this license, visit
+http://creativecommons.org/licenses/by/3.0/us/ or send a letter to Creative
+Commons, 444 Castro Street, Suite 900, Mountain View, California, 94041, USA.
+
+Copyright (C) 2013 Oak Ridge National Laboratory
+*/
+/**
+ * \file main-sweep.cc
+ * \brief Main function for simulating 2D histograms over a grid of models
+ *        and parameters.
+ *
+ * Each grid point (model, average site level energy, average coupling, and
+ * eta) is simulated and binned exactly as `final-sim-v-2d --histogram' would
+ * do, and its histogram is written to its own file in the output directory.
+ * The files are named like those in `Data Processing/data': for example,
+ * `deps-10gam1.0eta0.3' is the `d' model with epsilon0 = -10, gamma0 = 1,
+ * and eta = 0.3.
+ *
+ * The grid points are spread over a pool of threads, each taking the next
+ * point as soon as it is free, so that cheap and costly points do not wait
+ * for each other. The random number samplers, the conductance kernels, and
+ * the sampler tables are set up once and shared by every point.
+ *
+ * There are eight required command-line arguments:
+ *    -# The number of trials at each grid point.
+ *    -# The Fermi level of the system (eV).
+ *    -# The standard deviation in site level energy (eV).
+ *    -# The standard deviation in electrode-channel coupling (eV).
+ *    -# The lower bound of the applied bias range (V).
+ *    -# The upper bound of the applied bias range (V).
+ *    -# The number of bins in each direction.
+ *    -# The output directory (which must exist).
+ *
+ * The grid is given by optional arguments, each a comma-separated list:
+ *    - `--models LIST' of `i', `s', `d', and `x' (default `i,s,d').
+ *    - `--epsilon LIST' of average site level energies (default -3,-6.5,-10).
+ *    - `--gamma LIST' of average couplings (default 0.5,0.75,1.0).
+ *    - `--eta LIST' of relative voltage drops (default 0.3,0.4,0.5).
+ *
+ * The defaults give the 81 histograms in `Data Processing/data'. Other
+ * options:
+ *    - `--threads N' simulates N grid points at a time (default 1).
+ *    - `--format F' is the file format: `text' (default), `f64', or `f32'.
+ *    - `--precision P' is `double' (default) or `single' (see
+ *      final-sim-v-2d).
+ *    - `--rng NAME' is the pseudo-random generator: `xoshiro' (default),
+ *      `pcg64', `philox', or `gsl:NAME' (see sampler.h). A GSL generator
+ *      only supplies the raw words, so the trials are not bit-compatible with
+ *      the original programs' gsl_ran_gaussian() draws.
+ *
+ * \author agent
+ * \date October 2026
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cfloat>
+#include <gsl/gsl_histogram2d.h>
+#include "parallel.h"
+#include "sampler.h"
+#include "sample-stream.h"
+#include "simulation.h"
+
+/// The longest output file name.
+#define SWEEP_NAME_LENGTH 4096
+
+/**
+ * \brief Struct for passing the sweep to the block functions.
+ *
+ * Each "block" handed to run_blocks() is one grid point.
+ */
+typedef struct {
+	/// The trial parameters shared by all grid points.
+	st_trials common;
+
+	/// The models at each grid point.
+	char *models;
+
+	/// The average site level energy, average coupling, and eta at each grid
+	/// point.
+	double *epsilon0, *gamma0, *eta;
+
+	/// The number of bins in each direction.
+	int nbin;
+
+	/// The output directory.
+	const char *outdir;
+
+	/// The output format.
+	en_format format;
+
+	/// Whether to simulate in single precision.
+	bool single;
+
+	/// One random number sampler per slot.
+	st_sampler **r;
+
+	/// Whether each grid point's file was written successfully.
+	bool *ok;
+} st_sweep;
+
+/**
+ * \brief Parses a comma-separated list of numbers.
+ *
+ * \param[in] arg The list.
+ * \param[out] n The number of values.
+ * \return The values (to be freed by the caller), or NULL if the list is
+ *         empty or malformed.
+ */
+double *parse_list(const char *arg, int *n);
+
+/**
+ * \brief Formats a parameter for a file name.
+ *
+ * \param[out] buf The formatted value.
+ * \param[in] size The size of buf.
+ * \param[in] x The value.
+ * \param[in] decimal Whether to force a decimal point (1 becomes "1.0").
+ */
+void format_name_value(char *buf, size_t size, double x, bool decimal);
+
+/**
+ * \brief Simulates, bins, and writes the histogram for one grid point.
+ *
+ * \param[in] point The grid point.
+ * \param[in] slot The slot (thread) workspace to use.
+ * \param[in] params The st_sweep.
+ */
+void sweep_point(long point, int slot, void *params);
+
+/**
+ * \brief Main function for the parameter sweep.
+ *
+ * Parses the input parameters and writes one histogram per grid point.
+ *
+ * \param[in] argc The number of command-line arguments.
+ * \param[in] argv The command-line arguments.
+ * \return Exit status; 0 for normal.
+ */
+int main(int argc, char **argv) {
+	long i, npoints;
+	int nthreads, nargs, nbin, neps, ngam, neta, nmodels;
+	int im, ie, ig, it;
+	char *args[9];
+	const char *models;
+	double *epslist, *gamlist, *etalist;
+	en_format format;
+	bool single;
+	st_rng rng;
+	st_sweep sweep;
+	st_blocks blocks;
+
+	// pull out the optional arguments
+	nthreads = 1;
+	format = FORMAT_TEXT;
+	single = false;
+	parse_rng("xoshiro", &rng);
+	models = "i,s,d";
+	epslist = parse_list("-3,-6.5,-10", &neps);
+	gamlist = parse_list("0.5,0.75,1.0", &ngam);
+	etalist = parse_list("0.3,0.4,0.5", &neta);
+	nargs = 0;
+	for (i = 0; i < argc; ++i) {
+		if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+			nthreads = atoi(argv[++i]);
+			if (nthreads < 1) {
+				fprintf(stderr, "Error: Use at least one thread.\n");
+				return 0;
+			}
+		}
+		else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+			if (stream_parse_format(argv[++i], &format)) {
+				fprintf(stderr, "Error: Unknown format: '%s'.\n", argv[i]);
+				return 0;
+			}
+		}
+		else if (strcmp(argv[i], "--precision") == 0 && i + 1 < argc) {
+			if (parse_precision(argv[++i], &single)) {
+				fprintf(stderr, "Error: Unknown precision: '%s'.\n", argv[i]);
+				return 0;
+			}
+		}
+		else if (strcmp(argv[i], "--rng") == 0 && i + 1 < argc) {
+			if (parse_rng(argv[++i], &rng)) {
+				fprintf(stderr, "Error: Unknown generator: '%s'.\n", argv[i]);
+				return 0;
+			}
+		}
+		else if (strcmp(argv[i], "--models") == 0 && i + 1 < argc)
+			models = argv[++i];
+		else if (strcmp(argv[i], "--epsilon") == 0 && i + 1 < argc) {
+			free(epslist);
+			epslist = parse_list(argv[++i], &neps);
+		}
+		else if (strcmp(argv[i], "--gamma") == 0 && i + 1 < argc) {
+			free(gamlist);
+			gamlist = parse_list(argv[++i], &ngam);
+		}
+		else if (strcmp(argv[i], "--eta") == 0 && i + 1 < argc) {
+			free(etalist);
+			etalist = parse_list(argv[++i], &neta);
+		}
+		else if (nargs < 9)
+			args[nargs++] = argv[i];
+		else
+			++nargs;
+	}
+	argc = nargs;
+	argv = args;
+
+	if (argc != 9) {
+		fprintf(stderr, "Usage error: ./sweep n EF depsilon dgamma Vmin Vmax " \
+			"nbin outdir\n" \
+			"   n is the number of trials at each grid point\n" \
+			"   EF is the Fermi level (eV)\n" \
+			"   depsilon is the standard deviation in site level energy (eV)\n" \
+			"   dgamma is the standard deviation in the coupling (eV)\n" \
+			"   Vmin is the lower bound of the applied bias range (V)\n" \
+			"   Vmax is the upper bound of the applied bias range (V)\n" \
+			"   nbin is the number of bins in each direction\n" \
+			"   outdir is the directory for the histograms\n" \
+			"\n   Options (lists are comma-separated):\n" \
+			"   --models LIST of 'i', 's', 'd', 'x' (default i,s,d)\n" \
+			"   --epsilon LIST of average site level energies " \
+				"(default -3,-6.5,-10)\n" \
+			"   --gamma LIST of average couplings (default 0.5,0.75,1.0)\n" \
+			"   --eta LIST of relative voltage drops (default 0.3,0.4,0.5)\n" \
+			"   --threads N simulates N grid points at a time\n" \
+			"   --format F is 'text' (default), 'f64', or 'f32'\n" \
+			"   --precision P is 'double' (default) or 'single'\n" \
+			"   --rng NAME is 'xoshiro' (default), 'pcg64', 'philox', or " \
+				"'gsl:NAME'\n");
+		return 0;
+	}
+
+	if (epslist == NULL || gamlist == NULL || etalist == NULL) {
+		fprintf(stderr, "Error: Malformed parameter list.\n");
+		return 0;
+	}
+
+	// models, ignoring the commas
+	nmodels = 0;
+	for (i = 0; models[i] != '\0'; ++i) {
+		if (models[i] == ',')
+			continue;
+		if (select_model(models[i]) == NULL) {
+			fprintf(stderr, "Error: Unknown model: '%c'.\n", models[i]);
+			return 0;
+		}
+		++nmodels;
+	}
+	if (nmodels == 0) {
+		fprintf(stderr, "Error: Use at least one model.\n");
+		return 0;
+	}
+
+	sweep.common.cond = NULL;
+	sweep.common.cond_f = NULL;
+	sweep.common.cond_a = NULL;
+	sweep.common.chain = NULL;
+	sweep.common.cond_h = NULL;
+	sweep.common.molecule = NULL;
+	sweep.common.cond_t = NULL;
+	sweep.common.kT = 0.0;
+	sweep.common.n = atol(argv[1]);
+	sweep.common.EF = atof(argv[2]);
+	sweep.common.depsilon = atof(argv[3]);
+	sweep.common.epsilon0 = 0.0;
+	sweep.common.dgamma = atof(argv[4]);
+	sweep.common.gamma0 = 0.0;
+	sweep.common.gammaR0 = 0.0;
+	sweep.common.cov = NULL;
+	sweep.common.coupling = COUPLING_NORMAL;
+	sweep.common.pdf_gamma = NULL;
+	sweep.common.pdf_gammaR = NULL;
+	sweep.common.pdf_epsilon = NULL;
+	sweep.common.Vmin = atof(argv[5]);
+	sweep.common.Vmax = atof(argv[6]);
+	sweep.common.eta = 0.0;
+	sweep.common.sampling = SAMPLING_PSEUDO;
+	sweep.common.replica = 0;
+	sweep.common.nstrata = 0;
+	sweep.common.legacy = NULL;
+	nbin = atoi(argv[7]);
+
+	if (sweep.common.depsilon <= 0.0 || sweep.common.dgamma <= 0.0) {
+		fprintf(stderr, "Error: standard deviations must be positive.\n");
+		return 0;
+	}
+
+	if (sweep.common.n <= 0) {
+		fprintf(stderr, "Error: There must be at least one trial.\n");
+		return 0;
+	}
+
+	if (sweep.common.Vmin > sweep.common.Vmax) {
+		fprintf(stderr, "Error: Vmin is lower bound, Vmax is upper bound; " \
+			"Vmax > Vmin.\n");
+		return 0;
+	}
+
+	if (nbin < 1) {
+		fprintf(stderr, "Error: Use at least one bin.\n");
+		return 0;
+	}
+
+	for (i = 0; i < ngam; ++i) {
+		if (gamlist[i] <= 0.0) {
+			fprintf(stderr, "Error: gamma0 must be positive.\n");
+			return 0;
+		}
+		if (gamlist[i] / sweep.common.dgamma < 4.0) {
+			fprintf(stderr, "Warning: The model assumes gamma0 / dgamma >> 0; " \
+				"bigger than 4, in practice.\n");
+		}
+	}
+
+	for (i = 0; i < neta; ++i) {
+		if (etalist[i] > 1.0 || etalist[i] < 0.0) {
+			fprintf(stderr, "Error: eta is a relative voltage drop on one " \
+				"side; 0 <= eta <= 1.\n");
+			return 0;
+		}
+	}
+
+	// lay out the grid points, in the order of the file names
+	npoints = (long)nmodels * neps * ngam * neta;
+	sweep.models = (char*)malloc(npoints*sizeof(char));
+	sweep.epsilon0 = (double*)malloc(npoints*sizeof(double));
+	sweep.gamma0 = (double*)malloc(npoints*sizeof(double));
+	sweep.eta = (double*)malloc(npoints*sizeof(double));
+	i = 0;
+	for (im = 0; models[im] != '\0'; ++im) {
+		if (models[im] == ',')
+			continue;
+		for (ie = 0; ie < neps; ++ie)
+		for (ig = 0; ig < ngam; ++ig)
+		for (it = 0; it < neta; ++it) {
+			sweep.models[i] = models[im];
+			sweep.epsilon0[i] = epslist[ie];
+			sweep.gamma0[i] = gamlist[ig];
+			sweep.eta[i] = etalist[it];
+			++i;
+		}
+	}
+
+	sweep.nbin = nbin;
+	sweep.outdir = argv[8];
+	sweep.format = format;
+	sweep.single = single;
+	sweep.r = (st_sampler**)malloc(nthreads*sizeof(st_sampler*));
+	sweep.ok = (bool*)malloc(npoints*sizeof(bool));
+	for (i = 0; i < nthreads; ++i)
+		sweep.r[i] = sampler_alloc_rng(&rng);
+
+	// the files are written as the points finish, in any order
+	blocks.work = sweep_point;
+	blocks.emit = NULL;
+	blocks.params = &sweep;
+	run_blocks(npoints, nthreads, &blocks);
+
+	for (i = 0; i < npoints; ++i)
+		if (!sweep.ok[i])
+			fprintf(stderr, "Error: Could not write grid point %ld.\n", i);
+
+	for (i = 0; i < nthreads; ++i)
+		sampler_free(sweep.r[i]);
+	free(sweep.r);
+	free(sweep.ok);
+	free(sweep.models);
+	free(sweep.epsilon0);
+	free(sweep.gamma0);
+	free(sweep.eta);
+	free(epslist);
+	free(gamlist);
+	free(etalist);
+	return 0;
+}
+
+double *parse_list(const char *arg, int *n) {
+	double *x;
+	const char *p;
+	char *end;
+	int i;
+
+	// count the entries
+	*n = 1;
+	for (p = arg; *p != '\0'; ++p)
+		if (*p == ',')
+			++*n;
+
+	x = (double*)malloc(*n*sizeof(double));
+	p = arg;
+	for (i = 0; i < *n; ++i) {
+		x[i] = strtod(p, &end);
+		if (end == p || (*end != ',' && *end != '\0')) {
+			free(x);
+			return NULL;
+		}
+		p = end + 1;
+	}
+
+	return x;
+}
+
+void format_name_value(char *buf, size_t size, double x, bool decimal) {
+	snprintf(buf, size, "%g", x);
+	if (decimal && strpbrk(buf, ".e") == NULL)
+		strncat(buf, ".0", size - strlen(buf) - 1);
+}
+
+void sweep_point(long point, int slot, void *params) {
+	st_sweep *sweep = (st_sweep*)params;
+	st_sampler *r = sweep->r[slot];
+	st_trials t = sweep->common;
+	st_stream_header header;
+	gsl_histogram2d *h;
+	char name[SWEEP_NAME_LENGTH], eps[32], gam[32], eta[32];
+	double gmin, gmax;
+	long block, nblocks;
+	FILE *f;
+
+	t.cond = select_model(sweep->models[point]);
+	t.cond_f = sweep->single ? select_model_f(sweep->models[point]) : NULL;
+	t.epsilon0 = sweep->epsilon0[point];
+	t.gamma0 = sweep->gamma0[point];
+	t.eta = sweep->eta[point];
+	nblocks = count_blocks(t.n);
+
+	// the conductance range, then the histogram (as final-sim-v-2d does)
+	gmin = DBL_MAX;
+	gmax = -DBL_MAX;
+	for (block = 0; block < nblocks; ++block)
+		trials_log_range(&t, block, r, &gmin, &gmax);
+
+	h = gsl_histogram2d_alloc(sweep->nbin, sweep->nbin);
+	gsl_histogram2d_set_ranges_uniform(h, t.Vmin, t.Vmax, gmin, gmax);
+	for (block = 0; block < nblocks; ++block)
+		trials_histogram(&t, block, r, h);
+
+	format_name_value(eps, sizeof(eps), t.epsilon0, false);
+	format_name_value(gam, sizeof(gam), t.gamma0, true);
+	format_name_value(eta, sizeof(eta), t.eta, true);
+	snprintf(name, sizeof(name), "%s/%ceps%sgam%seta%s", sweep->outdir,
+		sweep->models[point], eps, gam, eta);
+
+	if (sweep->format != FORMAT_TEXT) {
+		char model[2] = {sweep->models[point], '\0'};
+
+		stream_header_init(&header, model, sweep->nbin);
+		stream_header_param(&header, "n", t.n);
+		stream_header_param(&header, "EF", t.EF);
+		stream_header_param(&header, "depsilon", t.depsilon);
+		stream_header_param(&header, "epsilon0", t.epsilon0);
+		stream_header_param(&header, "dgamma", t.dgamma);
+		stream_header_param(&header, "gamma0", t.gamma0);
+		stream_header_param(&header, "Vmin", t.Vmin);
+		stream_header_param(&header, "Vmax", t.Vmax);
+		stream_header_param(&header, "eta", t.eta);
+		stream_header_param(&header, "nbin", sweep->nbin);
+		if (sweep->single)
+			stream_header_param(&header, "single", 1);
+		stream_header_column(&header, "V", sweep->format);
+		stream_header_column(&header, "logG", sweep->format);
+		stream_header_column(&header, "count", sweep->format);
+	}
+
+	f = fopen(name, (sweep->format == FORMAT_TEXT) ? "w" : "wb");
+	sweep->ok[point] = (f != NULL);
+	if (f != NULL) {
+		write_histogram(f, h, sweep->nbin, sweep->format, &header);
+		sweep->ok[point] = (ferror(f) == 0);
+		fclose(f);
+	}
+
+	gsl_histogram2d_free(h);
+}
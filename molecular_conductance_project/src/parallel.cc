@@ -0,0 +1,209 @@
+/*
+This work is licensed under the Creative Commons Attribution 3.0 United States
+License. To view a copy of this license, visit
+http://creativecommons.org/licenses/by/3.0/us/ or send a letter to Creative
+Commons, 444 Castro Street, Suite 900, Mountain View, California, 94041, USA.
+
+Copyright (C) 2013 Oak Ridge National Laboratory
+*/
+/**
+ * \file parallel.cc
+ * \brief Implementation of the block-parallel processing of trials.
+ *
+ * \author agent
+ * \date October 2026
+ */
+
+#include "parallel.h"
+#include <cstdlib>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * \brief The worker threads shared by every call to run_blocks().
+ *
+ * The workers are started when a call first needs them and then wait for
+ * the next call; the calling thread works as slot 0. All fields but next are
+ * guarded by lock.
+ */
+typedef struct {
+	/// The lock.
+	std::mutex lock;
+
+	/// Signals a new call, an emitted block, a finished worker, or stop.
+	std::condition_variable changed;
+
+	/// The workers; worker i works as slot i + 1.
+	std::vector<std::thread> threads;
+
+	/// The current call's work.
+	const st_blocks *blocks;
+
+	/// The number of blocks in the current call.
+	long nblocks;
+
+	/// The number of slots in the current call.
+	int nslots;
+
+	/// Counts the calls, so that the workers can tell a new one.
+	unsigned long call;
+
+	/// The number of workers still busy with the current call.
+	int busy;
+
+	/// The next block to hand out.
+	std::atomic<long> next;
+
+	/// The next block to emit.
+	long next_emit;
+
+	/// The finished block waiting in each slot to be emitted, or -1.
+	std::vector<long> held;
+
+	/// Tells the workers to exit.
+	bool stop;
+} st_pool;
+
+static st_pool pool;
+
+/**
+ * \brief Processes blocks in one slot until none are left.
+ *
+ * Each block is taken from the shared counter as soon as the slot is free,
+ * so a slow block holds up no other thread's work. A finished block is kept
+ * in the slot until every earlier block is emitted; whichever thread
+ * finishes the last of them emits the waiting blocks in order.
+ *
+ * \param[in] slot The slot.
+ */
+static void work_blocks(int slot) {
+	const st_blocks *blocks = pool.blocks;
+	long block;
+	int s;
+
+	while ((block = pool.next++) < pool.nblocks) {
+		blocks->work(block, slot, blocks->params);
+		if (blocks->emit == NULL)
+			continue;
+
+		std::unique_lock<std::mutex> guard(pool.lock);
+		pool.held[slot] = block;
+		for (s = 0; s < pool.nslots; ) {
+			if (pool.held[s] == pool.next_emit) {
+				blocks->emit(pool.next_emit, s, blocks->params);
+				pool.held[s] = -1;
+				++pool.next_emit;
+				s = 0;
+			}
+			else
+				++s;
+		}
+		pool.changed.notify_all();
+
+		// the slot's workspace is reused once its block is out
+		while (pool.held[slot] != -1)
+			pool.changed.wait(guard);
+	}
+}
+
+/**
+ * \brief The body of a worker thread.
+ *
+ * \param[in] slot The worker's slot.
+ * \param[in] seen The last call before the worker was started.
+ */
+static void worker(int slot, unsigned long seen) {
+	std::unique_lock<std::mutex> guard(pool.lock);
+
+	for (;;) {
+		while (!pool.stop && pool.call == seen)
+			pool.changed.wait(guard);
+		if (pool.stop)
+			return;
+		seen = pool.call;
+		if (slot >= pool.nslots)
+			continue;
+
+		guard.unlock();
+		work_blocks(slot);
+		guard.lock();
+		if (--pool.busy == 0)
+			pool.changed.notify_all();
+	}
+}
+
+/**
+ * \brief Stops and joins the workers at exit.
+ */
+static void stop_workers() {
+	size_t i;
+
+	{
+		std::lock_guard<std::mutex> guard(pool.lock);
+		pool.stop = true;
+	}
+	pool.changed.notify_all();
+	for (i = 0; i < pool.threads.size(); ++i)
+		pool.threads[i].join();
+}
+
+unsigned long block_seed(unsigned long seed, long block) {
+	// splitmix64 finalizer on the (seed, block) pair
+	unsigned long long z = (unsigned long long)seed +
+		0x9E3779B97F4A7C15ULL * (unsigned long long)(block + 1);
+
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	z ^= z >> 31;
+
+	// GSL treats a seed of 0 as a request for its default seed
+	if ((unsigned long)z == 0)
+		z = 1;
+
+	return (unsigned long)z;
+}
+
+long count_blocks(long n) {
+	return (n + TRIALS_PER_BLOCK - 1) / TRIALS_PER_BLOCK;
+}
+
+long block_trials(long n, long block) {
+	long first = block * TRIALS_PER_BLOCK;
+
+	return (n - first < TRIALS_PER_BLOCK) ? n - first : TRIALS_PER_BLOCK;
+}
+
+void run_blocks(long nblocks, int nthreads, const st_blocks *blocks) {
+	int slot;
+
+	if (nthreads < 1)
+		nthreads = 1;
+
+	std::unique_lock<std::mutex> guard(pool.lock);
+
+	if (pool.threads.empty() && nthreads > 1)
+		atexit(stop_workers);
+	for (slot = (int)pool.threads.size() + 1; slot < nthreads; ++slot)
+		pool.threads.push_back(std::thread(worker, slot, pool.call));
+
+	pool.blocks = blocks;
+	pool.nblocks = nblocks;
+	pool.nslots = nthreads;
+	pool.busy = nthreads - 1;
+	pool.next = 0;
+	pool.next_emit = 0;
+	pool.held.assign(nthreads, -1);
+	++pool.call;
+	guard.unlock();
+	pool.changed.notify_all();
+
+	// the calling thread takes slot 0 itself
+	work_blocks(0);
+
+	guard.lock();
+	while (pool.busy > 0)
+		pool.changed.wait(guard);
+}
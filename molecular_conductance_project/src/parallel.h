@@ -0,0 +1,96 @@
+/*
+This work is licensed under the Creative Commons Attribution 3.0 United States
+License. To view a copy of this license, visit
+http://creativecommons.org/licenses/by/3.0/us/ or send a letter to Creative
+Commons, 444 Castro Street, Suite 900, Mountain View, California, 94041, USA.
+
+Copyright (C) 2013 Oak Ridge National Laboratory
+*/
+/**
+ * \file parallel.h
+ * \brief Prototypes for splitting the simulation trials into blocks that can
+ *        be processed on several threads.
+ *
+ * The trials are divided into blocks of #TRIALS_PER_BLOCK trials, and each
+ * block draws its random numbers from its own stream, seeded from the block
+ * index. Which thread processes a block therefore has no bearing on the
+ * numbers it produces, and the blocks are always output in order; the
+ * simulated data is the same for any number of threads.
+ *
+ * \author agent
+ * \date October 2026
+ */
+
+#ifndef __parallel_h__
+#define __parallel_h__
+
+/// The number of trials in each block (the last block may be shorter).
+#define TRIALS_PER_BLOCK 65536L
+
+/// The number of trials whose random numbers are drawn at a time.
+#define TRIALS_PER_BATCH 512
+
+/**
+ * \brief Struct for passing the per-block work to run_blocks().
+ *
+ * Each thread is given a slot number in [0, nthreads); a slot's workspace
+ * (random number generator, output buffer, etc.) is used by one block at a
+ * time.
+ */
+typedef struct {
+	/// Processes the specified block using the given slot's workspace.
+	void (*work)(long block, int slot, void *params);
+
+	/// Outputs the specified block (called in block order; may be NULL).
+	void (*emit)(long block, int slot, void *params);
+
+	/// The parameters passed to work and emit.
+	void *params;
+} st_blocks;
+
+/**
+ * \brief Produces the seed for a block's random number stream.
+ *
+ * The block index is hashed with the overall seed so that neighboring blocks
+ * get unrelated seeds.
+ *
+ * \param[in] seed The seed for the whole simulation.
+ * \param[in] block The block index.
+ * \return The seed for the block.
+ */
+unsigned long block_seed(unsigned long seed, long block);
+
+/**
+ * \brief Gets the number of blocks needed for the specified number of trials.
+ *
+ * \param[in] n The number of trials.
+ * \return The number of blocks.
+ */
+long count_blocks(long n);
+
+/**
+ * \brief Gets the number of trials in the specified block.
+ *
+ * \param[in] n The total number of trials.
+ * \param[in] block The block index.
+ * \return The number of trials in the block.
+ */
+long block_trials(long n, long block);
+
+/**
+ * \brief Processes all blocks, using up to nthreads threads.
+ *
+ * The threads are kept in a pool and reused by later calls. Each takes the
+ * next block as soon as it is free, so blocks of different costs do not wait
+ * for each other. A finished block stays in its slot until every earlier
+ * block has been emitted, and is then emitted by whichever thread finishes
+ * the last of those; only then does the slot take another block. Without
+ * emit, the slots never wait.
+ *
+ * \param[in] nblocks The number of blocks.
+ * \param[in] nthreads The number of threads (and slots) to use.
+ * \param[in] blocks The work to perform on each block.
+ */
+void run_blocks(long nblocks, int nthreads, const st_blocks *blocks);
+
+#endif
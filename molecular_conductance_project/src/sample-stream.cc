@@ -0,0 +1,316 @@
+/*
+This work is licensed under the Creative Commons Attribution 3.0 United States
+License. To view a copy of this license, visit
+http://creativecommons.org/licenses/by/3.0/us/ or send a letter to Creative
+Commons, 444 Castro Street, Suite 900, Mountain View, California, 94041, USA.
+
+Copyright (C) 2013 Oak Ridge National Laboratory
+*/
+/**
+ * \file sample-stream.cc
+ * \brief Implementation of the framed binary format.
+ *
+ * \author agent
+ * \date October 2026
+ */
+
+#include "sample-stream.h"
+#include <cstdlib>
+#include <cstring>
+
+/// The magic bytes at the start of a stream.
+static const char stream_magic[4] = {'M', 'C', 'S', 'S'};
+
+/// The version of the format.
+static const unsigned int stream_version = 1;
+
+/// The number of values converted to/from float32 at a time.
+#define STREAM_CHUNK 1024
+
+/**
+ * \brief Copies a name into a fixed-length, NUL-padded field.
+ *
+ * \param[out] dest The field.
+ * \param[in] src The name (truncated if too long).
+ */
+static void set_name(char *dest, const char *src) {
+	memset(dest, 0, STREAM_NAME_LENGTH);
+	strncpy(dest, src, STREAM_NAME_LENGTH - 1);
+}
+
+/**
+ * \brief Writes an unsigned integer as a uint32.
+ *
+ * \return 0 on success; -1 on error.
+ */
+static int write_u32(FILE *f, unsigned int x) {
+	return (fwrite(&x, sizeof(x), 1, f) == 1) ? 0 : -1;
+}
+
+/**
+ * \brief Reads a uint32.
+ *
+ * \return 0 on success; -1 on error.
+ */
+static int read_u32(FILE *f, unsigned int *x) {
+	return (fread(x, sizeof(*x), 1, f) == 1) ? 0 : -1;
+}
+
+int stream_parse_format(const char *arg, en_format *format) {
+	if (strcmp(arg, "text") == 0)
+		*format = FORMAT_TEXT;
+	else if (strcmp(arg, "f64") == 0)
+		*format = FORMAT_F64;
+	else if (strcmp(arg, "f32") == 0)
+		*format = FORMAT_F32;
+	else
+		return -1;
+
+	return 0;
+}
+
+void stream_header_init(st_stream_header *h, const char *model,
+	unsigned int frame_rows) {
+
+	memset(h, 0, sizeof(st_stream_header));
+	set_name(h->model, model);
+	h->frame_rows = frame_rows;
+}
+
+void stream_header_param(st_stream_header *h, const char *name, double value) {
+	if (h->nparams == STREAM_MAX_PARAMS)
+		return;
+
+	set_name(h->param_names[h->nparams], name);
+	h->params[h->nparams] = value;
+	++h->nparams;
+}
+
+void stream_header_column(st_stream_header *h, const char *name,
+	en_format format) {
+
+	if (h->ncols == STREAM_MAX_COLUMNS)
+		return;
+
+	set_name(h->col_names[h->ncols], name);
+	h->col_sizes[h->ncols] = (format == FORMAT_F32) ? 4 : 8;
+	++h->ncols;
+}
+
+int stream_header_get(const st_stream_header *h, const char *name,
+	double *value) {
+
+	unsigned int i;
+
+	for (i = 0; i < h->nparams; ++i) {
+		if (strncmp(h->param_names[i], name, STREAM_NAME_LENGTH) == 0) {
+			*value = h->params[i];
+			return 0;
+		}
+	}
+
+	return -1;
+}
+
+int stream_header_find(const st_stream_header *h, const char *name) {
+	unsigned int i;
+
+	for (i = 0; i < h->ncols; ++i)
+		if (strncmp(h->col_names[i], name, STREAM_NAME_LENGTH) == 0)
+			return (int)i;
+
+	return -1;
+}
+
+int stream_write_header(FILE *f, const st_stream_header *h) {
+	unsigned int i;
+	int err = 0;
+
+	err |= (fwrite(stream_magic, 1, 4, f) == 4) ? 0 : -1;
+	err |= write_u32(f, stream_version);
+	err |= (fwrite(h->model, 1, STREAM_NAME_LENGTH, f) ==
+		STREAM_NAME_LENGTH) ? 0 : -1;
+
+	err |= write_u32(f, h->nparams);
+	for (i = 0; i < h->nparams; ++i) {
+		err |= (fwrite(h->param_names[i], 1, STREAM_NAME_LENGTH, f) ==
+			STREAM_NAME_LENGTH) ? 0 : -1;
+		err |= (fwrite(&h->params[i], sizeof(double), 1, f) == 1) ? 0 : -1;
+	}
+
+	err |= write_u32(f, h->ncols);
+	for (i = 0; i < h->ncols; ++i) {
+		err |= (fwrite(h->col_names[i], 1, STREAM_NAME_LENGTH, f) ==
+			STREAM_NAME_LENGTH) ? 0 : -1;
+		err |= write_u32(f, h->col_sizes[i]);
+	}
+
+	err |= write_u32(f, h->frame_rows);
+
+	return err ? -1 : 0;
+}
+
+int stream_write_frame(FILE *f, const st_stream_header *h,
+	const double *const *cols, size_t nrows) {
+
+	float chunk[STREAM_CHUNK];
+	unsigned int c;
+	size_t i, j, m;
+	int err = 0;
+
+	if (nrows == 0)
+		return 0; // an empty frame would end the stream
+
+	err |= write_u32(f, (unsigned int)nrows);
+	for (c = 0; c < h->ncols; ++c) {
+		if (h->col_sizes[c] == 8) {
+			err |= (fwrite(cols[c], sizeof(double), nrows, f) == nrows) ? 0 : -1;
+			continue;
+		}
+
+		for (i = 0; i < nrows; i += m) {
+			m = (nrows - i < STREAM_CHUNK) ? nrows - i : STREAM_CHUNK;
+			for (j = 0; j < m; ++j)
+				chunk[j] = (float)cols[c][i + j];
+			err |= (fwrite(chunk, sizeof(float), m, f) == m) ? 0 : -1;
+		}
+	}
+
+	return err ? -1 : 0;
+}
+
+int stream_write_end(FILE *f) {
+	return write_u32(f, 0);
+}
+
+int stream_is_binary(FILE *f) {
+	int c = getc(f);
+
+	if (c == EOF)
+		return 0;
+
+	ungetc(c, f);
+	return (c == stream_magic[0]);
+}
+
+int stream_read_header(FILE *f, st_stream_header *h) {
+	char magic[4];
+	unsigned int version, i;
+
+	memset(h, 0, sizeof(st_stream_header));
+
+	if (fread(magic, 1, 4, f) != 4 || memcmp(magic, stream_magic, 4) != 0)
+		return -1;
+	if (read_u32(f, &version) || version != stream_version)
+		return -1;
+	if (fread(h->model, 1, STREAM_NAME_LENGTH, f) != STREAM_NAME_LENGTH)
+		return -1;
+	h->model[STREAM_NAME_LENGTH - 1] = '\0';
+
+	if (read_u32(f, &h->nparams) || h->nparams > STREAM_MAX_PARAMS)
+		return -1;
+	for (i = 0; i < h->nparams; ++i) {
+		if (fread(h->param_names[i], 1, STREAM_NAME_LENGTH, f) !=
+			STREAM_NAME_LENGTH)
+			return -1;
+		h->param_names[i][STREAM_NAME_LENGTH - 1] = '\0';
+		if (fread(&h->params[i], sizeof(double), 1, f) != 1)
+			return -1;
+	}
+
+	if (read_u32(f, &h->ncols) || h->ncols > STREAM_MAX_COLUMNS)
+		return -1;
+	for (i = 0; i < h->ncols; ++i) {
+		if (fread(h->col_names[i], 1, STREAM_NAME_LENGTH, f) !=
+			STREAM_NAME_LENGTH)
+			return -1;
+		h->col_names[i][STREAM_NAME_LENGTH - 1] = '\0';
+		if (read_u32(f, &h->col_sizes[i]) ||
+			(h->col_sizes[i] != 4 && h->col_sizes[i] != 8))
+			return -1;
+	}
+
+	if (read_u32(f, &h->frame_rows) || h->frame_rows == 0)
+		return -1;
+
+	return 0;
+}
+
+long stream_read_frame(FILE *f, const st_stream_header *h, double *const *cols) {
+	float chunk[STREAM_CHUNK];
+	unsigned int nrows, c;
+	size_t i, j, m;
+
+	if (read_u32(f, &nrows))
+		return -1;
+	if (nrows == 0)
+		return 0;
+	if (nrows > h->frame_rows)
+		return -1;
+
+	for (c = 0; c < h->ncols; ++c) {
+		if (cols[c] == NULL) {
+			if (fseek(f, (long)nrows * h->col_sizes[c], SEEK_CUR) == 0)
+				continue;
+
+			// pipes cannot seek; read and discard instead
+			for (i = 0; i < (size_t)nrows * h->col_sizes[c]; i += m) {
+				m = (size_t)nrows * h->col_sizes[c] - i;
+				if (m > sizeof(chunk))
+					m = sizeof(chunk);
+				if (fread(chunk, 1, m, f) != m)
+					return -1;
+			}
+			continue;
+		}
+
+		if (h->col_sizes[c] == 8) {
+			if (fread(cols[c], sizeof(double), nrows, f) != nrows)
+				return -1;
+			continue;
+		}
+
+		for (i = 0; i < nrows; i += m) {
+			m = (nrows - i < STREAM_CHUNK) ? nrows - i : STREAM_CHUNK;
+			if (fread(chunk, sizeof(float), m, f) != m)
+				return -1;
+			for (j = 0; j < m; ++j)
+				cols[c][i + j] = chunk[j];
+		}
+	}
+
+	return (long)nrows;
+}
+
+long stream_read_columns(FILE *f, const st_stream_header *h, const int *which,
+	int nwhich, double *const *out, long max) {
+
+	double *cols[STREAM_MAX_COLUMNS];
+	long nread, m, rows;
+	int k;
+
+	for (k = 0; k < STREAM_MAX_COLUMNS; ++k)
+		cols[k] = NULL;
+	for (k = 0; k < nwhich; ++k)
+		cols[which[k]] = (double*)malloc(h->frame_rows*sizeof(double));
+
+	nread = 0;
+	while (nread < max) {
+		rows = stream_read_frame(f, h, cols);
+		if (rows <= 0) {
+			if (rows < 0)
+				nread = -1;
+			break;
+		}
+
+		m = (max - nread < rows) ? max - nread : rows;
+		for (k = 0; k < nwhich; ++k)
+			memcpy(out[k] + nread, cols[which[k]], m*sizeof(double));
+		nread += m;
+	}
+
+	for (k = 0; k < nwhich; ++k)
+		free(cols[which[k]]);
+
+	return nread;
+}
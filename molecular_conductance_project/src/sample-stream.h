@@ -0,0 +1,227 @@
+/*
+This work is licensed under the Creative Commons Attribution 3.0 United States
+License. To view a copy of this license, visit
+http://creativecommons.org/licenses/by/3.0/us/ or send a letter to Creative
+Commons, 444 Castro Street, Suite 900, Mountain View, California, 94041, USA.
+
+Copyright (C) 2013 Oak Ridge National Laboratory
+*/
+/**
+ * \file sample-stream.h
+ * \brief Prototypes for the framed binary format passed between the
+ *        simulators and binners.
+ *
+ * A stream begins with a header:
+ *    -# The magic bytes `MCSS' and the format version (uint32).
+ *    -# The model name (16 characters, NUL padded).
+ *    -# The number of parameters (uint32), followed by each parameter's name
+ *       (16 characters) and value (float64).
+ *    -# The number of columns (uint32), followed by each column's name
+ *       (16 characters) and element size (uint32; 4 for float32 or 8 for
+ *       float64).
+ *    -# The number of rows in each full frame (uint32).
+ *
+ * The data follows in frames. Each frame gives its number of rows (uint32;
+ * at most the number in the header) and then each column's values in turn.
+ * A frame with zero rows ends the stream. All values are stored in the
+ * machine's native byte order.
+ *
+ * \author agent
+ * \date October 2026
+ */
+
+#ifndef __sample_stream_h__
+#define __sample_stream_h__
+
+#include <cstdio>
+#include <cstddef>
+
+/// The maximum number of parameters in a header.
+#define STREAM_MAX_PARAMS 32
+
+/// The maximum number of columns in a stream.
+#define STREAM_MAX_COLUMNS 16
+
+/// The length of the model, parameter, and column names.
+#define STREAM_NAME_LENGTH 16
+
+/**
+ * \brief The output formats supported by the simulators and binners.
+ */
+typedef enum {
+	/// Formatted text (the default).
+	FORMAT_TEXT,
+
+	/// Binary frames with float64 columns.
+	FORMAT_F64,
+
+	/// Binary frames with float32 columns.
+	FORMAT_F32
+} en_format;
+
+/**
+ * \brief The header of a binary stream.
+ */
+typedef struct {
+	/// The model that produced the data.
+	char model[STREAM_NAME_LENGTH];
+
+	/// The number of parameters.
+	unsigned int nparams;
+
+	/// The parameter names.
+	char param_names[STREAM_MAX_PARAMS][STREAM_NAME_LENGTH];
+
+	/// The parameter values.
+	double params[STREAM_MAX_PARAMS];
+
+	/// The number of columns.
+	unsigned int ncols;
+
+	/// The column names.
+	char col_names[STREAM_MAX_COLUMNS][STREAM_NAME_LENGTH];
+
+	/// The size of each column's elements (4 or 8 bytes).
+	unsigned int col_sizes[STREAM_MAX_COLUMNS];
+
+	/// The number of rows in a full frame.
+	unsigned int frame_rows;
+} st_stream_header;
+
+/**
+ * \brief Parses the argument of a `--format' option.
+ *
+ * \param[in] arg `text', `f64', or `f32'.
+ * \param[out] format The format.
+ * \return 0 if the format is recognized; -1 otherwise.
+ */
+int stream_parse_format(const char *arg, en_format *format);
+
+/**
+ * \brief Initializes a header with no parameters or columns.
+ *
+ * \param[out] h The header.
+ * \param[in] model The model name.
+ * \param[in] frame_rows The number of rows in each full frame.
+ */
+void stream_header_init(st_stream_header *h, const char *model,
+	unsigned int frame_rows);
+
+/**
+ * \brief Adds a parameter to a header.
+ *
+ * \param[in,out] h The header.
+ * \param[in] name The parameter's name.
+ * \param[in] value The parameter's value.
+ */
+void stream_header_param(st_stream_header *h, const char *name, double value);
+
+/**
+ * \brief Adds a column to a header.
+ *
+ * \param[in,out] h The header.
+ * \param[in] name The column's name.
+ * \param[in] format FORMAT_F64 or FORMAT_F32.
+ */
+void stream_header_column(st_stream_header *h, const char *name,
+	en_format format);
+
+/**
+ * \brief Looks up a parameter in a header.
+ *
+ * \param[in] h The header.
+ * \param[in] name The parameter's name.
+ * \param[out] value The parameter's value, if found.
+ * \return 0 if found; -1 otherwise.
+ */
+int stream_header_get(const st_stream_header *h, const char *name,
+	double *value);
+
+/**
+ * \brief Looks up a column in a header.
+ *
+ * \param[in] h The header.
+ * \param[in] name The column's name.
+ * \return The column's index, or -1 if there is no such column.
+ */
+int stream_header_find(const st_stream_header *h, const char *name);
+
+/**
+ * \brief Writes a header.
+ *
+ * \param[in] f The output file.
+ * \param[in] h The header.
+ * \return 0 on success; -1 on a write error.
+ */
+int stream_write_header(FILE *f, const st_stream_header *h);
+
+/**
+ * \brief Writes one frame.
+ *
+ * \param[in] f The output file.
+ * \param[in] h The stream's header.
+ * \param[in] cols The column data (one array of nrows values per column).
+ * \param[in] nrows The number of rows; at most h->frame_rows.
+ * \return 0 on success; -1 on a write error.
+ */
+int stream_write_frame(FILE *f, const st_stream_header *h,
+	const double *const *cols, size_t nrows);
+
+/**
+ * \brief Writes the frame that ends a stream.
+ *
+ * \param[in] f The output file.
+ * \return 0 on success; -1 on a write error.
+ */
+int stream_write_end(FILE *f);
+
+/**
+ * \brief Checks whether an input file holds a binary stream.
+ *
+ * Only the first byte is examined (and then pushed back), so this works on
+ * pipes.
+ *
+ * \param[in] f The input file.
+ * \return 1 if the input is binary; 0 otherwise.
+ */
+int stream_is_binary(FILE *f);
+
+/**
+ * \brief Reads a header.
+ *
+ * \param[in] f The input file.
+ * \param[out] h The header.
+ * \return 0 on success; -1 if the header is missing or malformed.
+ */
+int stream_read_header(FILE *f, st_stream_header *h);
+
+/**
+ * \brief Reads one frame.
+ *
+ * \param[in] f The input file.
+ * \param[in] h The stream's header.
+ * \param[out] cols The column data; each array must hold h->frame_rows
+ *             values. Columns whose array is NULL are skipped.
+ * \return The number of rows read; 0 at the end of the stream and -1 on a
+ *         read error.
+ */
+long stream_read_frame(FILE *f, const st_stream_header *h, double *const *cols);
+
+/**
+ * \brief Reads selected columns from the remaining frames into contiguous
+ *        arrays.
+ *
+ * \param[in] f The input file.
+ * \param[in] h The stream's header.
+ * \param[in] which The indices of the requested columns.
+ * \param[in] nwhich The number of requested columns.
+ * \param[out] out The arrays for the requested columns; each must hold max
+ *             values.
+ * \param[in] max The maximum number of rows to read.
+ * \return The number of rows read (fewer than max if the stream ended), or
+ *         -1 on a read error.
+ */
+long stream_read_columns(FILE *f, const st_stream_header *h, const int *which,
+	int nwhich, double *const *out, long max);
+
+#endif
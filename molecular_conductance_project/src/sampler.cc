@@ -0,0 +1,782 @@
+/*
+This work is licensed under the Creative Commons Attribution 3.0 United States
+License. To view a copy of this license, visit
+http://creativecommons.org/licenses/by/3.0/us/ or send a letter to Creative
+Commons, 444 Castro Street, Suite 900, Mountain View, California, 94041, USA.
+
+Copyright (C) 2013 Oak Ridge National Laboratory
+*/
+/**
+ * \file sampler.cc
+ * \brief Implementation of the bulk uniform and normal sampler.
+ *
+ * The Ziggurat follows G.\ Marsaglia and W.\ W.\ Tsang, J.\ Stat.\ Softw.\
+ * \b 5, 1-7 (2000), with the 256-layer tables of J.\ A.\ Doornik (2005).
+ * The xoshiro256++ generator is from D.\ Blackman and S.\ Vigna, ACM Trans.\
+ * Math.\ Softw.\ \b 47, 36 (2021); PCG64 from M.\ E.\ O'Neill, HMC-CS-2014-0905
+ * (2014); and Philox4x32-10 from J.\ K.\ Salmon, M.\ A.\ Moraes, R.\ O.\ Dror,
+ * and D.\ E.\ Shaw, Proc.\ SC11 (2011).
+ *
+ * \author agent
+ * \date October 2026
+ */
+
+#include "sampler.h"
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+
+/// The number of Ziggurat layers.
+#define ZIGGURAT_LAYERS 256
+
+/// The number of 32-bit half words taken from the buffer at a time.
+#define HALF_CHUNK 256
+
+/// The number of Philox counters encrypted together by each lane.
+#define PHILOX_BLOCKS 4
+
+/// The start of the tail of the 256-layer Ziggurat.
+static const double zig_r = 3.6541528853610088;
+
+/// The area of each of the 256 layers (for the unnormalized density).
+static const double zig_v = 0.00492867323399;
+
+/// The PCG64 multiplier.
+static const unsigned __int128 pcg_mult =
+	((unsigned __int128)0x2360ED051FC65DA4ULL << 64) | 0x4385DF649FCCF645ULL;
+
+/// The Philox4x32 multipliers.
+static const unsigned int philox_m0 = 0xD2511F53, philox_m1 = 0xCD9E8D57;
+
+/// The Philox4x32 key increments (the golden ratio and sqrt(3) - 1).
+static const unsigned int philox_w0 = 0x9E3779B9, philox_w1 = 0xBB67AE85;
+
+/// 2^-53, to convert the top 53 bits of a word into [0, 1).
+static const double to_unit = 1.0 / 9007199254740992.0;
+
+/// 2^-24, to convert the top 24 bits of a 32-bit half word into [0, 1).
+static const float to_unit_f = 1.0f / 16777216.0f;
+
+/// 2^-23, to convert the top 23 bits of a 32-bit half word into [0, 1).
+static const float to_unit_23 = 1.0f / 8388608.0f;
+
+/// Four 64-bit words (used to advance the interleaved generators).
+typedef unsigned long long u64x4 __attribute__((vector_size(32)));
+
+/// Eight 64-bit words.
+typedef unsigned long long u64x8 __attribute__((vector_size(64)));
+
+/// Eight 32-bit half words (used by the single-precision functions).
+typedef unsigned int u32x8 __attribute__((vector_size(32)));
+
+/// Eight signed 32-bit integers.
+typedef int i32x8 __attribute__((vector_size(32)));
+
+/// Eight floats.
+typedef float f32x8 __attribute__((vector_size(32)));
+
+/**
+ * \brief The Ziggurat tables.
+ */
+typedef struct {
+	/// The layer widths; x[0] is the width of the base (including the tail).
+	double x[ZIGGURAT_LAYERS + 1];
+
+	/// x[i+1] / x[i]: a word in layer i is accepted outright below this.
+	double ratio[ZIGGURAT_LAYERS];
+
+	/// The density at each layer edge.
+	double f[ZIGGURAT_LAYERS + 1];
+
+	/// The layer widths, rounded to single precision.
+	float x_f[ZIGGURAT_LAYERS + 1];
+
+	/// ratio rounded up to single precision: for a single-precision u,
+	/// u < ratio[i] exactly when u < ratio_f[i].
+	float ratio_f[ZIGGURAT_LAYERS];
+} st_ziggurat;
+
+/**
+ * \brief Builds the Ziggurat tables.
+ *
+ * \param[out] z The tables.
+ */
+static void ziggurat_setup(st_ziggurat *z) {
+	int i;
+
+	z->x[0] = zig_v / exp(-0.5*zig_r*zig_r);
+	z->x[1] = zig_r;
+	for (i = 1; i < ZIGGURAT_LAYERS - 1; ++i)
+		z->x[i+1] = sqrt(-2.0*log(zig_v / z->x[i] +
+			exp(-0.5*z->x[i]*z->x[i])));
+	z->x[ZIGGURAT_LAYERS] = 0.0;
+
+	for (i = 0; i < ZIGGURAT_LAYERS; ++i)
+		z->ratio[i] = z->x[i+1] / z->x[i];
+	for (i = 0; i <= ZIGGURAT_LAYERS; ++i)
+		z->f[i] = exp(-0.5*z->x[i]*z->x[i]);
+	for (i = 0; i <= ZIGGURAT_LAYERS; ++i)
+		z->x_f[i] = (float)z->x[i];
+	for (i = 0; i < ZIGGURAT_LAYERS; ++i) {
+		z->ratio_f[i] = (float)z->ratio[i];
+		if (z->ratio_f[i] < z->ratio[i])
+			z->ratio_f[i] = nextafterf(z->ratio_f[i], 2.0f);
+	}
+}
+
+/**
+ * \brief Gets the Ziggurat tables, building them on the first call.
+ *
+ * \return The tables.
+ */
+static const st_ziggurat &ziggurat() {
+	static st_ziggurat z;
+	static bool built = (ziggurat_setup(&z), true);
+
+	(void)built;
+	return z;
+}
+
+/**
+ * \brief Rotates a word left.
+ */
+static inline unsigned long long rotl(unsigned long long x, int k) {
+	return (x << k) | (x >> (64 - k));
+}
+
+/**
+ * \brief The splitmix64 generator, used to expand a seed into states.
+ *
+ * \param[in,out] x The splitmix64 state.
+ * \return The next output.
+ */
+static unsigned long long splitmix64(unsigned long long *x) {
+	unsigned long long z = (*x += 0x9E3779B97F4A7C15ULL);
+
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+/**
+ * \brief Draws one word from the scalar (side) xoshiro256++ stream.
+ *
+ * \param[in,out] s The state.
+ * \return The word.
+ */
+static unsigned long long side_next(unsigned long long *s) {
+	const unsigned long long result = rotl(s[0] + s[3], 23) + s[0];
+	const unsigned long long t = s[1] << 17;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = rotl(s[3], 45);
+
+	return result;
+}
+
+/**
+ * \brief Refills the word buffer from the interleaved xoshiro256++
+ *        generators.
+ *
+ * Compiled for several instruction sets; the widest one the machine supports
+ * is used.
+ *
+ * \param[in,out] s The sampler.
+ */
+__attribute__((target_clones("avx512f", "avx2", "default")))
+static void refill_xoshiro(st_sampler *s) {
+	const int nvec = SAMPLER_LANES / 4;
+	u64x4 s0[nvec], s1[nvec], s2[nvec], s3[nvec], r, t;
+	size_t k;
+	int j;
+
+	memcpy(s0, s->s[0], sizeof(s0));
+	memcpy(s1, s->s[1], sizeof(s1));
+	memcpy(s2, s->s[2], sizeof(s2));
+	memcpy(s3, s->s[3], sizeof(s3));
+
+	for (k = 0; k < SAMPLER_BUFFER; k += SAMPLER_LANES) {
+		for (j = 0; j < nvec; ++j) {
+			r = s0[j] + s3[j];
+			r = ((r << 23) | (r >> 41)) + s0[j];
+			memcpy(s->words + k + 4*j, &r, sizeof(r));
+
+			t = s1[j] << 17;
+			s2[j] ^= s0[j];
+			s3[j] ^= s1[j];
+			s1[j] ^= s2[j];
+			s0[j] ^= s3[j];
+			s2[j] ^= t;
+			s3[j] = (s3[j] << 45) | (s3[j] >> 19);
+		}
+	}
+
+	memcpy(s->s[0], s0, sizeof(s0));
+	memcpy(s->s[1], s1, sizeof(s1));
+	memcpy(s->s[2], s2, sizeof(s2));
+	memcpy(s->s[3], s3, sizeof(s3));
+}
+
+/**
+ * \brief Refills the word buffer from the interleaved PCG64 generators.
+ *
+ * The 128-bit multiplications do not map onto vector instructions, but the
+ * lanes are independent, so their multiplications overlap in the pipeline.
+ * The lane loop is unrolled so that the states stay in registers.
+ *
+ * \param[in,out] s The sampler.
+ */
+static void refill_pcg64(st_sampler *s) {
+	unsigned __int128 state[SAMPLER_LANES], inc[SAMPLER_LANES];
+	unsigned long long x;
+	unsigned int rot;
+	size_t k;
+	int j;
+
+	for (j = 0; j < SAMPLER_LANES; ++j) {
+		state[j] = ((unsigned __int128)s->s[1][j] << 64) | s->s[0][j];
+		inc[j] = ((unsigned __int128)s->s[3][j] << 64) | s->s[2][j];
+	}
+
+	for (k = 0; k < SAMPLER_BUFFER; k += SAMPLER_LANES) {
+#pragma GCC unroll 8
+		for (j = 0; j < SAMPLER_LANES; ++j) {
+			state[j] = state[j] * pcg_mult + inc[j];
+
+			// XSL RR output
+			x = (unsigned long long)(state[j] >> 64) ^
+				(unsigned long long)state[j];
+			rot = (unsigned int)(state[j] >> 122);
+			s->words[k + j] = (x >> rot) | (x << ((64 - rot) & 63));
+		}
+	}
+
+	for (j = 0; j < SAMPLER_LANES; ++j) {
+		s->s[0][j] = (unsigned long long)state[j];
+		s->s[1][j] = (unsigned long long)(state[j] >> 64);
+	}
+}
+
+/**
+ * \brief Refills the word buffer from the interleaved Philox4x32-10
+ *        generators.
+ *
+ * Each lane encrypts its counter with its own key; the four 32-bit outputs
+ * make two words. Row i of the vectors holds element i of every lane, one
+ * 32-bit value per 64-bit element so that the multiplications need no
+ * conversions. #PHILOX_BLOCKS consecutive counters are encrypted together:
+ * the rounds of one block depend on each other, but not on the other blocks.
+ * Compiled for several instruction sets; the widest one the machine supports
+ * is used.
+ *
+ * \param[in,out] s The sampler.
+ */
+__attribute__((target_clones("avx512f", "avx2", "default")))
+static void refill_philox(st_sampler *s) {
+	const u64x8 lo32 = {0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+		0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF};
+	u64x8 ctr_lo, ctr_hi, key, k0, k1, p0, p1, w;
+	u64x8 c0[PHILOX_BLOCKS], c1[PHILOX_BLOCKS], c2[PHILOX_BLOCKS],
+		c3[PHILOX_BLOCKS];
+	size_t k;
+	int b, round;
+
+	memcpy(&ctr_lo, s->s[0], sizeof(ctr_lo));
+	memcpy(&ctr_hi, s->s[1], sizeof(ctr_hi));
+	memcpy(&key, s->s[2], sizeof(key));
+
+	for (k = 0; k < SAMPLER_BUFFER; k += 2*SAMPLER_LANES*PHILOX_BLOCKS) {
+		for (b = 0; b < PHILOX_BLOCKS; ++b) {
+			// 2^64 blocks per lane are never reached, so no carry into ctr_hi
+			c0[b] = (ctr_lo + b) & lo32;
+			c1[b] = (ctr_lo + b) >> 32;
+			c2[b] = ctr_hi & lo32;
+			c3[b] = ctr_hi >> 32;
+		}
+		k0 = key & lo32;
+		k1 = key >> 32;
+
+		for (round = 0; round < 10; ++round) {
+			if (round > 0) {
+				k0 = (k0 + philox_w0) & lo32;
+				k1 = (k1 + philox_w1) & lo32;
+			}
+#pragma GCC unroll 4
+			for (b = 0; b < PHILOX_BLOCKS; ++b) {
+				p0 = c0[b] * philox_m0;
+				p1 = c2[b] * philox_m1;
+				c0[b] = (p1 >> 32) ^ c1[b] ^ k0;
+				c1[b] = p1 & lo32;
+				c2[b] = (p0 >> 32) ^ c3[b] ^ k1;
+				c3[b] = p0 & lo32;
+			}
+		}
+
+		for (b = 0; b < PHILOX_BLOCKS; ++b) {
+			w = c0[b] | (c1[b] << 32);
+			memcpy(s->words + k + 2*SAMPLER_LANES*b, &w, sizeof(w));
+			w = c2[b] | (c3[b] << 32);
+			memcpy(s->words + k + 2*SAMPLER_LANES*b + SAMPLER_LANES, &w,
+				sizeof(w));
+		}
+		ctr_lo += PHILOX_BLOCKS;
+	}
+
+	memcpy(s->s[0], &ctr_lo, sizeof(ctr_lo));
+}
+
+/**
+ * \brief Refills the word buffer from a GSL generator.
+ *
+ * GSL's generators give integers in [min, max], with as few as 24 random
+ * bits (ranlux) or a range that is not a power of two (minstd). Each word is
+ * the concatenation of as many draws as it takes, each contributing the b
+ * bits of x - min for the largest b with 2^b - 1 <= max - min; draws with
+ * x - min >= 2^b are rejected, so that every bit is uniform. For the 32-bit
+ * generators (mt19937 and most others) nothing is rejected, and a word is
+ * two draws, the first in its high half.
+ *
+ * \param[in,out] s The sampler.
+ */
+static void refill_gsl(st_sampler *s) {
+	const unsigned long min = gsl_rng_min(s->gsl);
+	const unsigned long long range = gsl_rng_max(s->gsl) - min;
+	unsigned long long w, x, mask;
+	int b, have;
+	size_t k;
+
+	// the bits per draw
+	for (b = 1; b < 32 && ((range + 1) >> (b + 1)) != 0; ++b)
+		;
+	mask = (1ULL << b) - 1;
+
+	for (k = 0; k < SAMPLER_BUFFER; ++k) {
+		w = 0;
+		for (have = 0; have < 64; have += b) {
+			do
+				x = gsl_rng_get(s->gsl) - min;
+			while (x > mask);
+			w = (w << b) | x;
+		}
+		s->words[k] = w;
+	}
+}
+
+/**
+ * \brief Refills the word buffer from the sampler's generator.
+ *
+ * \param[in,out] s The sampler.
+ */
+static void refill(st_sampler *s) {
+	switch(s->rng) {
+	case RNG_XOSHIRO:
+		refill_xoshiro(s);
+		break;
+	case RNG_PCG64:
+		refill_pcg64(s);
+		break;
+	case RNG_PHILOX:
+		refill_philox(s);
+		break;
+	case RNG_GSL:
+		refill_gsl(s);
+		break;
+	}
+	s->pos = 0;
+}
+
+/**
+ * \brief Resolves a Ziggurat word that fell outside its layer's rectangle.
+ *
+ * \param[in] z The Ziggurat tables.
+ * \param[in,out] side The side stream, for the extra random numbers.
+ * \param[in] word The rejected word.
+ * \return A standard normal random number.
+ */
+static double ziggurat_slow(const st_ziggurat &z, unsigned long long *side,
+	unsigned long long word) {
+
+	int i;
+	double u, x, a, b;
+
+	for (;;) {
+		i = (int)(word & 0xFF);
+		u = (word >> 11) * to_unit;
+		x = u * z.x[i];
+
+		if (u < z.ratio[i])
+			break;
+
+		if (i == 0) {
+			// the tail beyond zig_r
+			do {
+				a = -log(1.0 - (side_next(side) >> 11) * to_unit) / zig_r;
+				b = -log(1.0 - (side_next(side) >> 11) * to_unit);
+			} while (2.0*b < a*a);
+			x = zig_r + a;
+			break;
+		}
+
+		// the wedge between the rectangle and the curve
+		if (z.f[i] + (side_next(side) >> 11) * to_unit * (z.f[i+1] - z.f[i])
+			< exp(-0.5*x*x))
+			break;
+
+		word = side_next(side);
+	}
+
+	return (word & 0x100) ? -x : x;
+}
+
+st_sampler *sampler_alloc() {
+	st_rng rng;
+
+	rng.kind = RNG_XOSHIRO;
+	rng.gsl = NULL;
+	return sampler_alloc_rng(&rng);
+}
+
+st_sampler *sampler_alloc_rng(const st_rng *rng) {
+	st_sampler *s = (st_sampler*)malloc(sizeof(st_sampler));
+
+	s->rng = rng->kind;
+	s->gsl = (rng->kind == RNG_GSL) ? gsl_rng_alloc(rng->gsl) : NULL;
+	sampler_set(s, 0xFEEDFACE);
+	return s;
+}
+
+int parse_rng(const char *arg, st_rng *rng) {
+	const gsl_rng_type **t;
+
+	rng->gsl = NULL;
+	if (strcmp(arg, "xoshiro") == 0)
+		rng->kind = RNG_XOSHIRO;
+	else if (strcmp(arg, "pcg64") == 0)
+		rng->kind = RNG_PCG64;
+	else if (strcmp(arg, "philox") == 0)
+		rng->kind = RNG_PHILOX;
+	else if (strncmp(arg, "gsl:", 4) == 0) {
+		rng->kind = RNG_GSL;
+		for (t = gsl_rng_types_setup(); *t != NULL; ++t)
+			if (strcmp((*t)->name, arg + 4) == 0)
+				rng->gsl = *t;
+		if (rng->gsl == NULL)
+			return -1;
+	}
+	else
+		return -1;
+	return 0;
+}
+
+void sampler_set(st_sampler *s, unsigned long seed) {
+	unsigned long long x = seed;
+	int i, j;
+
+	for (j = 0; j < SAMPLER_LANES; ++j)
+		for (i = 0; i < 4; ++i)
+			s->s[i][j] = splitmix64(&x);
+	for (i = 0; i < 4; ++i)
+		s->side[i] = splitmix64(&x);
+
+	switch(s->rng) {
+	case RNG_PCG64:
+		// the increment must be odd
+		for (j = 0; j < SAMPLER_LANES; ++j)
+			s->s[2][j] |= 1;
+		break;
+	case RNG_PHILOX:
+		// the counters start at zero; row 2 is the key
+		for (j = 0; j < SAMPLER_LANES; ++j)
+			s->s[0][j] = s->s[1][j] = 0;
+		break;
+	case RNG_GSL:
+		gsl_rng_set(s->gsl, seed);
+		break;
+	default:
+		break;
+	}
+
+	s->pos = SAMPLER_BUFFER;
+}
+
+void sampler_free(st_sampler *s) {
+	if (s->gsl != NULL)
+		gsl_rng_free(s->gsl);
+	free(s);
+}
+
+void sampler_uniform(st_sampler *s, double *x, size_t n) {
+	size_t k, m;
+	const unsigned long long *w;
+
+	while (n > 0) {
+		if (s->pos == SAMPLER_BUFFER)
+			refill(s);
+		m = SAMPLER_BUFFER - s->pos;
+		if (m > n)
+			m = n;
+
+		w = s->words + s->pos;
+		for (k = 0; k < m; ++k)
+			x[k] = (w[k] >> 11) * to_unit;
+
+		s->pos += m;
+		x += m;
+		n -= m;
+	}
+}
+
+void sampler_flat(st_sampler *s, double a, double b, double *x, size_t n) {
+	size_t k;
+
+	sampler_uniform(s, x, n);
+	for (k = 0; k < n; ++k)
+		x[k] = a + (b - a) * x[k];
+}
+
+void sampler_gaussian(st_sampler *s, double mean, double stdev, double *x,
+	size_t n) {
+
+	const st_ziggurat &z = ziggurat();
+	size_t k, m;
+	const unsigned long long *w;
+	int i;
+	double u, y;
+
+	while (n > 0) {
+		if (s->pos == SAMPLER_BUFFER)
+			refill(s);
+		m = SAMPLER_BUFFER - s->pos;
+		if (m > n)
+			m = n;
+
+		w = s->words + s->pos;
+		for (k = 0; k < m; ++k) {
+			i = (int)(w[k] & 0xFF);
+			u = (w[k] >> 11) * to_unit;
+
+			if (__builtin_expect(u < z.ratio[i], 1)) {
+				y = u * z.x[i];
+				y = (w[k] & 0x100) ? -y : y;
+			}
+			else
+				y = ziggurat_slow(z, s->side, w[k]);
+
+			x[k] = stdev * y + mean;
+		}
+
+		s->pos += m;
+		x += m;
+		n -= m;
+	}
+}
+
+/**
+ * \brief Takes the next 32-bit half words from the buffer, two per word.
+ *
+ * A request for an odd number of halves leaves the last word's upper half
+ * unused.
+ *
+ * \param[in,out] s The sampler.
+ * \param[out] h The half words.
+ * \param[in] n The number of half words.
+ */
+static void take_halves(st_sampler *s, unsigned int *h, size_t n) {
+	size_t k, m;
+	const unsigned long long *w;
+
+	while (n > 0) {
+		if (s->pos == SAMPLER_BUFFER)
+			refill(s);
+		m = SAMPLER_BUFFER - s->pos;
+		if (m > n / 2)
+			m = n / 2;
+
+		w = s->words + s->pos;
+		for (k = 0; k < m; ++k) {
+			h[2*k] = (unsigned int)w[k];
+			h[2*k+1] = (unsigned int)(w[k] >> 32);
+		}
+
+		s->pos += m;
+		h += 2*m;
+		n -= 2*m;
+
+		// the last half may need a fresh buffer of its own
+		if (n == 1) {
+			if (s->pos == SAMPLER_BUFFER)
+				refill(s);
+			h[0] = (unsigned int)s->words[s->pos++];
+			n = 0;
+		}
+	}
+}
+
+/**
+ * \brief Converts half words into single-precision uniform numbers in
+ *        [0, 1), eight at a time.
+ *
+ * \param[in] h The half words.
+ * \param[out] x The uniform numbers.
+ * \param[in] n The number of half words.
+ */
+__attribute__((target_clones("avx512f", "avx2", "default")))
+static void uniform_halves(const unsigned int *h, float *x, size_t n) {
+	size_t k;
+	u32x8 w;
+	f32x8 u;
+
+	for (k = 0; k + 8 <= n; k += 8) {
+		memcpy(&w, h + k, sizeof(w));
+		u = __builtin_convertvector((i32x8)(w >> 8), f32x8) * to_unit_f;
+		memcpy(x + k, &u, sizeof(u));
+	}
+	for (; k < n; ++k)
+		x[k] = (int)(h[k] >> 8) * to_unit_f;
+}
+
+/**
+ * \brief Converts half words into single-precision normal numbers, eight at
+ *        a time, for the words that fall inside their layer's rectangle.
+ *
+ * \param[in] z The Ziggurat tables.
+ * \param[in] h The half words.
+ * \param[in] mean The distribution's average.
+ * \param[in] stdev The distribution's standard deviation.
+ * \param[out] x The normal numbers (garbage where reject is set).
+ * \param[out] reject Nonzero for the words that need ziggurat_slow().
+ * \param[in] n The number of half words.
+ */
+__attribute__((target_clones("avx512f", "avx2", "default")))
+static void gaussian_halves(const st_ziggurat &z, const unsigned int *h,
+	float mean, float stdev, float *x, int *reject, size_t n) {
+
+	size_t k;
+	int j;
+	u32x8 w;
+	i32x8 i;
+	f32x8 u, width, ratio, y;
+
+	for (k = 0; k + 8 <= n; k += 8) {
+		memcpy(&w, h + k, sizeof(w));
+		i = (i32x8)(w & 0xFF);
+		u = __builtin_convertvector((i32x8)(w >> 9), f32x8) * to_unit_23;
+		for (j = 0; j < 8; ++j) {
+			width[j] = z.x_f[i[j]];
+			ratio[j] = z.ratio_f[i[j]];
+		}
+
+		// u * width is never negative, so setting the sign bit negates it
+		y = (f32x8)((u32x8)(u * width) | ((w & 0x100) << 23));
+		y = stdev * y + mean;
+		memcpy(x + k, &y, sizeof(y));
+
+		i = (u >= ratio);
+		memcpy(reject + k, &i, sizeof(i));
+	}
+	for (; k < n; ++k) {
+		j = (int)(h[k] & 0xFF);
+		u[0] = (int)(h[k] >> 9) * to_unit_23;
+		y[0] = u[0] * z.x_f[j];
+		y[0] = (h[k] & 0x100) ? -y[0] : y[0];
+		x[k] = stdev * y[0] + mean;
+		reject[k] = (u[0] >= z.ratio_f[j]);
+	}
+}
+
+void sampler_uniform_f(st_sampler *s, float *x, size_t n) {
+	unsigned int h[HALF_CHUNK];
+	size_t m;
+
+	while (n > 0) {
+		m = (n < HALF_CHUNK) ? n : HALF_CHUNK;
+		take_halves(s, h, m);
+		uniform_halves(h, x, m);
+
+		x += m;
+		n -= m;
+	}
+}
+
+void sampler_flat_f(st_sampler *s, float a, float b, float *x, size_t n) {
+	size_t k;
+
+	sampler_uniform_f(s, x, n);
+	for (k = 0; k < n; ++k)
+		x[k] = a + (b - a) * x[k];
+}
+
+void sampler_gaussian_f(st_sampler *s, float mean, float stdev, float *x,
+	size_t n) {
+
+	const st_ziggurat &z = ziggurat();
+	unsigned int h[HALF_CHUNK];
+	int reject[HALF_CHUNK];
+	size_t k, m;
+
+	while (n > 0) {
+		m = (n < HALF_CHUNK) ? n : HALF_CHUNK;
+		take_halves(s, h, m);
+		gaussian_halves(z, h, mean, stdev, x, reject, m);
+
+		// place each rejected half word's bits where ziggurat_slow expects
+		// them
+		for (k = 0; k < m; ++k)
+			if (__builtin_expect(reject[k], 0))
+				x[k] = stdev * (float)ziggurat_slow(z, s->side,
+					((unsigned long long)(h[k] >> 9) << 41) | (h[k] & 0x1FF)) +
+					mean;
+
+		x += m;
+		n -= m;
+	}
+}
+
+double normal_quantile(double p) {
+	static const double a[6] = {-3.969683028665376e+01, 2.209460984245205e+02,
+		-2.759285104469687e+02, 1.383577518672690e+02, -3.066479806614716e+01,
+		2.506628277459239e+00};
+	static const double b[5] = {-5.447609879822406e+01, 1.615858368580409e+02,
+		-1.556989798598866e+02, 6.680131188771972e+01, -1.328068155288572e+01};
+	static const double c[6] = {-7.784894002430293e-03, -3.223964580411365e-01,
+		-2.400758277161838e+00, -2.549732539343734e+00, 4.374664141464968e+00,
+		2.938163982698783e+00};
+	static const double d[4] = {7.784695709041462e-03, 3.224671290700398e-01,
+		2.445134137142996e+00, 3.754408661907416e+00};
+	const double plow = 0.02425;
+	double q, r, x, e, u;
+
+	if (p <= 0.0)
+		return -HUGE_VAL;
+	if (p >= 1.0)
+		return HUGE_VAL;
+
+	if (p < plow) {
+		// lower tail
+		q = sqrt(-2.0*log(p));
+		x = (((((c[0]*q + c[1])*q + c[2])*q + c[3])*q + c[4])*q + c[5]) /
+			((((d[0]*q + d[1])*q + d[2])*q + d[3])*q + 1.0);
+	}
+	else if (p <= 1.0 - plow) {
+		// central region
+		q = p - 0.5;
+		r = q*q;
+		x = (((((a[0]*r + a[1])*r + a[2])*r + a[3])*r + a[4])*r + a[5])*q /
+			(((((b[0]*r + b[1])*r + b[2])*r + b[3])*r + b[4])*r + 1.0);
+	}
+	else {
+		// upper tail
+		q = sqrt(-2.0*log(1.0 - p));
+		x = -(((((c[0]*q + c[1])*q + c[2])*q + c[3])*q + c[4])*q + c[5]) /
+			((((d[0]*q + d[1])*q + d[2])*q + d[3])*q + 1.0);
+	}
+
+	// one step of Halley's method
+	e = 0.5 * erfc(-x / M_SQRT2) - p;
+	u = e * sqrt(2.0*M_PI) * exp(0.5*x*x);
+	return x - u / (1.0 + 0.5*x*u);
+}
@@ -0,0 +1,238 @@
+/*
+This work is licensed under the Creative Commons Attribution 3.0 United States
+License. To view a copy of this license, visit
+http://creativecommons.org/licenses/by/3.0/us/ or send a letter to Creative
+Commons, 444 Castro Street, Suite 900, Mountain View, California, 94041, USA.
+
+Copyright (C) 2013 Oak Ridge National Laboratory
+*/
+/**
+ * \file sampler.h
+ * \brief Prototypes for drawing uniform and normal random numbers in bulk.
+ *
+ * The sampler replaces per-sample calls to gsl_rng_uniform and
+ * gsl_ran_gaussian. Raw 64-bit words come from #SAMPLER_LANES interleaved
+ * generators, which are advanced together with vector instructions. The
+ * generator is xoshiro256++ by default; PCG64, Philox4x32-10, and the GSL
+ * generators are also available (see parse_rng()). Uniform variates use the
+ * top 53 bits of a word; normal variates use the 256-layer Ziggurat method,
+ * where roughly 99% of the words are accepted with one table lookup and one
+ * multiplication. The remaining words (the wedges and the tail) are resolved
+ * with a separate scalar xoshiro256++ stream, so the sequence depends only on
+ * the seed and on the order of the calls.
+ *
+ * A GSL generator only supplies the raw words, which go through the same
+ * conversions as any other generator's. The numbers are therefore not those
+ * of gsl_rng_uniform() and gsl_ran_gaussian(), and `--rng gsl:NAME' is not
+ * bit-compatible with the output of the original simulators; their
+ * `--legacy' option is (see #SAMPLING_LEGACY in simulation.h).
+ *
+ * The single-precision functions (suffix _f) take two numbers from each
+ * word, one from each 32-bit half, so they use half as many words.
+ *
+ * The interface mirrors GSL's: allocate with sampler_alloc(), seed with
+ * sampler_set(), and release with sampler_free().
+ *
+ * sampler-check compares the moments and tails of both precisions, and of
+ * a second generator (by default GSL's 24-bit ranlux), with
+ * gsl_ran_gaussian()'s and the exact values.
+ *
+ * \author agent
+ * \date October 2026
+ */
+
+#ifndef __sampler_h__
+#define __sampler_h__
+
+#include <cstddef>
+#include <gsl/gsl_rng.h>
+
+/// The number of interleaved generators.
+#define SAMPLER_LANES 8
+
+/// The number of raw words generated at a time.
+#define SAMPLER_BUFFER 2048
+
+/**
+ * \brief The generators that can supply the raw words.
+ */
+typedef enum {
+	/// xoshiro256++ (D.\ Blackman and S.\ Vigna).
+	RNG_XOSHIRO,
+
+	/// PCG64, the 128-bit LCG with XSL RR output (M.\ E.\ O'Neill).
+	RNG_PCG64,
+
+	/// The counter-based Philox4x32-10 (J.\ K.\ Salmon et al.).
+	RNG_PHILOX,
+
+	/// A GSL generator. Each word concatenates the random bits of as many
+	/// calls as it takes: two for a 32-bit generator such as mt19937, three
+	/// for a 24-bit one such as ranlux.
+	RNG_GSL
+} en_rng;
+
+/**
+ * \brief A choice of generator.
+ */
+typedef struct {
+	/// The generator.
+	en_rng kind;
+
+	/// The GSL generator type (RNG_GSL only).
+	const gsl_rng_type *gsl;
+} st_rng;
+
+/**
+ * \brief The state of the bulk sampler.
+ */
+typedef struct {
+	/// The generator.
+	en_rng rng;
+
+	/// The interleaved generator states, one column per lane. xoshiro256++
+	/// uses all four rows; PCG64 keeps the state in rows 0 (low) and 1
+	/// (high) and the increment in rows 2 and 3; Philox keeps the counter in
+	/// rows 0 and 1 and the key in row 2.
+	unsigned long long s[4][SAMPLER_LANES];
+
+	/// The GSL generator (RNG_GSL only).
+	gsl_rng *gsl;
+
+	/// The scalar xoshiro256++ state used for Ziggurat rejections.
+	unsigned long long side[4];
+
+	/// Raw words that have been generated but not yet used.
+	unsigned long long words[SAMPLER_BUFFER];
+
+	/// The index of the next unused word.
+	size_t pos;
+} st_sampler;
+
+/**
+ * \brief Allocates a sampler, seeded with a default seed.
+ *
+ * \return The sampler (using xoshiro256++).
+ */
+st_sampler *sampler_alloc();
+
+/**
+ * \brief Allocates a sampler using the specified generator, seeded with a
+ *        default seed.
+ *
+ * \param[in] rng The generator.
+ * \return The sampler.
+ */
+st_sampler *sampler_alloc_rng(const st_rng *rng);
+
+/**
+ * \brief Parses the argument of an `--rng' option.
+ *
+ * \param[in] arg `xoshiro', `pcg64', `philox', or `gsl:NAME' for the raw
+ *                words of the GSL generator NAME (for example,
+ *                `gsl:mt19937').
+ * \param[out] rng The generator.
+ * \return 0 if the generator is recognized; -1 otherwise.
+ */
+int parse_rng(const char *arg, st_rng *rng);
+
+/**
+ * \brief Seeds the sampler.
+ *
+ * The seed is expanded with splitmix64 into the states (or keys) of the
+ * lanes and of the side stream. A GSL generator is seeded directly.
+ *
+ * \param[in,out] s The sampler.
+ * \param[in] seed The seed.
+ */
+void sampler_set(st_sampler *s, unsigned long seed);
+
+/**
+ * \brief Frees a sampler.
+ *
+ * \param[in] s The sampler.
+ */
+void sampler_free(st_sampler *s);
+
+/**
+ * \brief Fills an array with uniform random numbers in [0, 1).
+ *
+ * \param[in,out] s The sampler.
+ * \param[out] x The random numbers.
+ * \param[in] n The number of random numbers.
+ */
+void sampler_uniform(st_sampler *s, double *x, size_t n);
+
+/**
+ * \brief Fills an array with uniform random numbers in [a, b).
+ *
+ * \param[in,out] s The sampler.
+ * \param[in] a The lower bound.
+ * \param[in] b The upper bound.
+ * \param[out] x The random numbers.
+ * \param[in] n The number of random numbers.
+ */
+void sampler_flat(st_sampler *s, double a, double b, double *x, size_t n);
+
+/**
+ * \brief Fills an array with normal random numbers.
+ *
+ * \param[in,out] s The sampler.
+ * \param[in] mean The distribution's average.
+ * \param[in] stdev The distribution's standard deviation.
+ * \param[out] x The random numbers.
+ * \param[in] n The number of random numbers.
+ */
+void sampler_gaussian(st_sampler *s, double mean, double stdev, double *x,
+	size_t n);
+
+/**
+ * \brief Fills an array with single-precision uniform random numbers in
+ *        [0, 1), using 24 bits per number.
+ *
+ * \param[in,out] s The sampler.
+ * \param[out] x The random numbers.
+ * \param[in] n The number of random numbers.
+ */
+void sampler_uniform_f(st_sampler *s, float *x, size_t n);
+
+/**
+ * \brief Fills an array with single-precision uniform random numbers in
+ *        [a, b).
+ *
+ * \param[in,out] s The sampler.
+ * \param[in] a The lower bound.
+ * \param[in] b The upper bound.
+ * \param[out] x The random numbers.
+ * \param[in] n The number of random numbers.
+ */
+void sampler_flat_f(st_sampler *s, float a, float b, float *x, size_t n);
+
+/**
+ * \brief Fills an array with single-precision normal random numbers.
+ *
+ * Each 32-bit half word chooses the Ziggurat layer and sign with its low 9
+ * bits and the position within the layer with its top 23 bits.
+ *
+ * \param[in,out] s The sampler.
+ * \param[in] mean The distribution's average.
+ * \param[in] stdev The distribution's standard deviation.
+ * \param[out] x The random numbers.
+ * \param[in] n The number of random numbers.
+ */
+void sampler_gaussian_f(st_sampler *s, float mean, float stdev, float *x,
+	size_t n);
+
+/**
+ * \brief The standard normal quantile function (inverse CDF).
+ *
+ * Used to turn uniform points (for instance, quasi-random ones) into normal
+ * random numbers. P.\ J.\ Acklam's rational approximation is refined with
+ * one Halley step, giving nearly full double precision.
+ *
+ * \param[in] p The probability, in (0, 1).
+ * \return The quantile.
+ */
+double normal_quantile(double p);
+
+#endif
@@ -0,0 +1,921 @@
+/*
+This work is licensed under the Creative Commons Attribution 3.0 United States
+License. To view a copy of this license, visit
+http://creativecommons.org/licenses/by/3.0/us/ or send a letter to Creative
+Commons, 444 Castro Street, Suite 900, Mountain View, California, 94041, USA.
+
+Copyright (C) 2013 Oak Ridge National Laboratory
+*/
+/**
+ * \file simulation.cc
+ * \brief Implementation of the block simulation and 2D histogram functions.
+ *
+ * \author agent
+ * \date October 2026
+ */
+
+#include "simulation.h"
+#include <cstdlib>
+#include <cmath>
+#include <cstring>
+#include <cfloat>
+#include <gsl/gsl_randist.h>
+#include "conductance.h"
+#include "parallel.h"
+#include "text-format.h"
+#include "sobol.h"
+
+/**
+ * \brief Struct for passing a log10 conductance range to log_range_batch().
+ */
+typedef struct {
+	/// The smallest and largest log10 conductance seen.
+	double *gmin, *gmax;
+} st_log_range;
+
+/**
+ * \brief Widens a log10 conductance range to cover a batch.
+ */
+static void log_range_batch(const double *V, const double *G, long offset,
+	long m, void *ctx) {
+
+	st_log_range *range = (st_log_range*)ctx;
+	double logg;
+	long j;
+
+	for (j = 0; j < m; ++j) {
+		logg = log10(G[j]);
+		if (logg < *range->gmin)
+			*range->gmin = logg;
+		if (logg > *range->gmax)
+			*range->gmax = logg;
+	}
+}
+
+/**
+ * \brief Bins a batch into the gsl_histogram2d passed as ctx.
+ *
+ * Conductances that are not positive (negative differential conductance)
+ * have no logarithm and are dropped; gsl_histogram2d_increment() would put
+ * the NaN in an end bin.
+ */
+static void histogram_batch(const double *V, const double *G, long offset,
+	long m, void *ctx) {
+
+	gsl_histogram2d *h = (gsl_histogram2d*)ctx;
+	long j;
+
+	for (j = 0; j < m; ++j)
+		if (G[j] > 0.0)
+			gsl_histogram2d_increment(h, V[j], log10(G[j]));
+}
+
+/// log10(2) to 16 bits, so that e*log10_2_hi is exact.
+static const float log10_2_hi = 0.301025390625f;
+
+/// The rest of log10(2).
+static const float log10_2_lo = 4.6050389811952e-06f;
+
+/// Eight floats.
+typedef float f32x8 __attribute__((vector_size(32)));
+
+/// Eight 32-bit integers.
+typedef int i32x8 __attribute__((vector_size(32)));
+
+/**
+ * \brief Single-precision log10 of a batch, eight at a time.
+ *
+ * With x = 2^e m and m in [sqrt(1/2), sqrt(2)), ln m = 2 atanh(s) for
+ * s = (m-1)/(m+1), |s| < 0.172; the series through s^9 is good to 4e-10.
+ * e log10(2) is split in two so that the result is as accurate as
+ * log10f()'s. Numbers that are not positive and normal are handed to
+ * log10f().
+ *
+ * \param[in] G The numbers.
+ * \param[out] logg Their log10.
+ * \param[in] m The number of numbers.
+ */
+__attribute__((target_clones("avx512f", "avx2", "default")))
+static void log10_batch_f(const float *G, float *logg, long m) {
+	long k, j;
+	i32x8 bits, e;
+	f32x8 x, mant, s, s2, ln, ef;
+
+	for (k = 0; k + 8 <= m; k += 8) {
+		memcpy(&x, G + k, sizeof(x));
+		bits = (i32x8)x;
+
+		// split off the exponent, centering the mantissa on 1
+		e = ((bits - 0x3F3504F3) >> 23);
+		bits -= e << 23;
+		mant = (f32x8)bits;
+
+		s = (mant - 1.0f) / (mant + 1.0f);
+		s2 = s*s;
+		ln = 2.0f*s*(1.0f + s2*(1.0f/3.0f + s2*(1.0f/5.0f + s2*(1.0f/7.0f +
+			s2*(1.0f/9.0f)))));
+		ef = __builtin_convertvector(e, f32x8);
+		x = ef*log10_2_hi + (ef*log10_2_lo + ln*(float)M_LOG10E);
+		memcpy(logg + k, &x, sizeof(x));
+	}
+
+	for (j = 0; j < k; ++j)
+		if (!(G[j] >= FLT_MIN && G[j] <= FLT_MAX))
+			logg[j] = log10f(G[j]);
+	for (; k < m; ++k)
+		logg[k] = log10f(G[k]);
+}
+
+/**
+ * \brief Single-precision version of log_range_batch().
+ */
+static void log_range_batch_f(const float *V, const float *G, long offset,
+	long m, void *ctx) {
+
+	st_log_range *range = (st_log_range*)ctx;
+	float gmin = (float)*range->gmin, gmax = (float)*range->gmax;
+	float logg[TRIALS_PER_BATCH];
+	long j;
+
+	log10_batch_f(G, logg, m);
+	for (j = 0; j < m; ++j) {
+		if (logg[j] < gmin)
+			gmin = logg[j];
+		if (logg[j] > gmax)
+			gmax = logg[j];
+	}
+
+	// (float)DBL_MAX is infinite, so an empty range keeps its +-DBL_MAX
+	if (gmin < *range->gmin)
+		*range->gmin = gmin;
+	if (gmax > *range->gmax)
+		*range->gmax = gmax;
+}
+
+/**
+ * \brief Single-precision version of histogram_batch().
+ *
+ * The bins are found arithmetically from the (uniform) ranges instead of
+ * with gsl_histogram2d_increment(). As there, points outside the ranges are
+ * dropped, except that a voltage rounded up to Vmax goes in the last
+ * column.
+ */
+static void histogram_batch_f(const float *V, const float *G, long offset,
+	long m, void *ctx) {
+
+	gsl_histogram2d *h = (gsl_histogram2d*)ctx;
+	const float nx = (float)h->nx, ny = (float)h->ny;
+	const float vmin = (float)h->xrange[0];
+	const float vscale = (float)(h->nx / (h->xrange[h->nx] - h->xrange[0]));
+	const float gmin = (float)h->yrange[0];
+	const float gscale = (float)(h->ny / (h->yrange[h->ny] - h->yrange[0]));
+	float logg[TRIALS_PER_BATCH];
+	float x, y;
+	long j;
+
+	log10_batch_f(G, logg, m);
+	for (j = 0; j < m; ++j) {
+		x = (V[j] - vmin) * vscale;
+		y = (logg[j] - gmin) * gscale;
+		if (x >= nx)
+			x = nx - 1.0f;
+
+		// written so that NaNs fail
+		if (x >= 0.0f && y >= 0.0f && y < ny)
+			h->bin[(size_t)x * h->ny + (size_t)y] += 1.0;
+	}
+}
+
+/**
+ * \brief Struct for passing a double-precision callback to widen_batch().
+ */
+typedef struct {
+	/// The callback.
+	void (*use)(const double *V, const double *G, long offset, long m,
+		void *ctx);
+
+	/// Its context.
+	void *ctx;
+} st_widen;
+
+/**
+ * \brief Widens a single-precision batch and passes it to the st_widen's
+ *        callback.
+ */
+static void widen_batch(const float *V, const float *G, long offset, long m,
+	void *ctx) {
+
+	st_widen *w = (st_widen*)ctx;
+	double Vd[TRIALS_PER_BATCH], Gd[TRIALS_PER_BATCH];
+	long j;
+
+	for (j = 0; j < m; ++j) {
+		Vd[j] = V[j];
+		Gd[j] = G[j];
+	}
+	w->use(Vd, Gd, offset, m, w->ctx);
+}
+
+/**
+ * \brief Maps uniform numbers in [0, 1) to voltages.
+ *
+ * Without stratification the voltage range is simply scaled. Otherwise
+ * trial k of the run is placed in voltage stratum k mod t->nstrata, at the
+ * position given by its uniform number within the stratum.
+ *
+ * \param[in] t The trial parameters.
+ * \param[in] first The index of the first trial within the run.
+ * \param[in,out] V The uniform numbers on input; the voltages on output.
+ * \param[in] m The number of trials.
+ */
+static void scale_voltages(const st_trials *t, long first, double *V,
+	long m) {
+
+	double width;
+	long j;
+
+	if (t->nstrata == 0) {
+		for (j = 0; j < m; ++j)
+			V[j] = t->Vmin + (t->Vmax - t->Vmin)*V[j];
+		return;
+	}
+
+	width = (t->Vmax - t->Vmin) / t->nstrata;
+	for (j = 0; j < m; ++j)
+		V[j] = t->Vmin + width*((first + j) % t->nstrata + V[j]);
+}
+
+/**
+ * \brief Prepares the random number source for a block of trials.
+ *
+ * \param[in] t The trial parameters.
+ * \param[in] block The block index.
+ * \param[in] first The index of the block's first trial.
+ * \param[in,out] r The sampler (pseudo-random sampling).
+ * \param[out] sobol The Sobol sequence (Sobol sampling).
+ */
+static void start_trials(const st_trials *t, long block, long first,
+	st_sampler *r, st_sobol *sobol) {
+
+	if (t->sampling == SAMPLING_SOBOL) {
+		sobol_init(sobol, (t->cond_a != NULL) ? 4 : 3, t->replica);
+		sobol_skip(sobol, first);
+	}
+
+	// the legacy stream runs through all of the blocks, as the original
+	// programs' did through all of the trials
+	if (t->sampling == SAMPLING_LEGACY && block == 0)
+		gsl_rng_set(t->legacy, SIMULATION_LEGACY_SEED);
+
+	// the chain's sites (and the molecule's disorder) are pseudo-random even
+	// with Sobol points
+	if (t->sampling != SAMPLING_SOBOL || t->chain != NULL ||
+		t->molecule != NULL)
+		sampler_set(r, block_seed(SIMULATION_SEED, block));
+}
+
+/**
+ * \brief Maps normal couplings to the coupling distribution of the trials.
+ *
+ * \param[in] t The trial parameters.
+ * \param[in] mean The average of the couplings.
+ * \param[in] stdev Their standard deviation.
+ * \param[in,out] gamma The couplings.
+ * \param[in] m The number of couplings.
+ */
+static void map_couplings(const st_trials *t, double mean, double stdev,
+	double *gamma, long m) {
+
+	switch (t->coupling) {
+	case COUPLING_TRUNCATED:
+		normal_truncate(mean, stdev, gamma, m);
+		break;
+	case COUPLING_LOGNORMAL:
+		normal_to_lognormal(mean, stdev, gamma, m);
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * \brief Maps uniform numbers (Sobol coordinates) to a parameter.
+ *
+ * \param[in] pdf The tabulated distribution of the parameter, or NULL for a
+ *            normal distribution.
+ * \param[in] mean The average of the normal distribution.
+ * \param[in] stdev Its standard deviation.
+ * \param[in,out] x The numbers.
+ * \param[in] m The number of numbers.
+ */
+static void quantile_param(const st_empirical_dist *pdf, double mean,
+	double stdev, double *x, long m) {
+
+	long j;
+
+	if (pdf != NULL) {
+		empirical_dist_quantile(pdf, x, x, m);
+		return;
+	}
+
+	for (j = 0; j < m; ++j)
+		x[j] = mean + stdev*normal_quantile(x[j]);
+}
+
+/**
+ * \brief Draws a parameter from a sampler.
+ *
+ * \param[in,out] r The sampler.
+ * \param[in] pdf The tabulated distribution of the parameter, or NULL for a
+ *            normal distribution.
+ * \param[in] mean The average of the normal distribution.
+ * \param[in] stdev Its standard deviation.
+ * \param[out] x The numbers.
+ * \param[in] m The number of numbers.
+ */
+static void sample_param(st_sampler *r, const st_empirical_dist *pdf,
+	double mean, double stdev, double *x, long m) {
+
+	if (pdf != NULL)
+		empirical_dist_sample(pdf, r, x, m);
+	else
+		sampler_gaussian(r, mean, stdev, x, m);
+}
+
+/**
+ * \brief Draws the voltages, couplings, and level energies of a batch as the
+ *        original programs did.
+ *
+ * Each trial draws its voltage, coupling, and level energy (and then its
+ * other coupling) before the next trial's, with gsl_rng_uniform() and
+ * gsl_ran_gaussian().
+ *
+ * \param[in] t The trial parameters.
+ * \param[out] V The voltages.
+ * \param[out] gamma The couplings.
+ * \param[out] epsilon The level energies.
+ * \param[out] gammaR The other couplings (asymmetric coupling only).
+ * \param[in] m The number of trials in the batch.
+ */
+static void draw_legacy(const st_trials *t, double *V, double *gamma,
+	double *epsilon, double *gammaR, long m) {
+
+	gsl_rng *r = t->legacy;
+	long j;
+
+	for (j = 0; j < m; ++j) {
+		V[j] = t->Vmin + gsl_rng_uniform(r) * (t->Vmax - t->Vmin);
+		gamma[j] = gsl_ran_gaussian(r, t->dgamma) + t->gamma0;
+		epsilon[j] = gsl_ran_gaussian(r, t->depsilon) + t->epsilon0;
+		if (t->cond_a != NULL)
+			gammaR[j] = gsl_ran_gaussian(r, t->dgamma) + t->gammaR0;
+	}
+}
+
+/**
+ * \brief Draws the voltages, couplings, and level energies of a batch.
+ *
+ * \param[in] t The trial parameters.
+ * \param[in] first The index of the batch's first trial within the run.
+ * \param[in,out] r The sampler (pseudo-random sampling).
+ * \param[in,out] sobol The Sobol sequence (Sobol sampling).
+ * \param[out] V The voltages.
+ * \param[out] gamma The couplings (to one electrode, with asymmetric
+ *             coupling).
+ * \param[out] epsilon The level energies.
+ * \param[out] gammaR The couplings to the other electrode (asymmetric
+ *             coupling only; may be NULL otherwise).
+ * \param[in] m The number of trials in the batch.
+ */
+static void draw_trials(const st_trials *t, long first, st_sampler *r,
+	st_sobol *sobol, double *V, double *gamma, double *epsilon,
+	double *gammaR, long m) {
+
+	double *const u[4] = {V, gamma, epsilon, gammaR};
+	double *const z[3] = {gamma, (t->cond_a != NULL) ? gammaR : epsilon,
+		epsilon};
+	double gamma0 = t->gamma0, dgamma = t->dgamma;
+	double epsilon0 = t->epsilon0, depsilon = t->depsilon;
+	double gammaR0 = t->gammaR0;
+
+	// with a joint distribution, draw standard normal numbers and map them
+	// afterwards
+	if (t->cov != NULL) {
+		gamma0 = epsilon0 = gammaR0 = 0.0;
+		dgamma = depsilon = 1.0;
+	}
+
+	if (t->sampling == SAMPLING_LEGACY)
+		draw_legacy(t, V, gamma, epsilon, gammaR, m);
+	else if (t->sampling == SAMPLING_SOBOL) {
+		sobol_next(sobol, u, m);
+		quantile_param(t->pdf_gamma, gamma0, dgamma, gamma, m);
+		quantile_param(t->pdf_epsilon, epsilon0, depsilon, epsilon, m);
+		if (t->cond_a != NULL)
+			quantile_param(t->pdf_gammaR, gammaR0, dgamma, gammaR, m);
+	}
+	else {
+		if (t->nstrata > 0)
+			sampler_uniform(r, V, m);
+		else
+			sampler_flat(r, t->Vmin, t->Vmax, V, m);
+		sample_param(r, t->pdf_gamma, gamma0, dgamma, gamma, m);
+		sample_param(r, t->pdf_epsilon, epsilon0, depsilon, epsilon, m);
+		if (t->cond_a != NULL)
+			sample_param(r, t->pdf_gammaR, gammaR0, dgamma, gammaR, m);
+	}
+
+	if (t->cov != NULL)
+		mvnormal_transform(t->cov, z, m);
+
+	if (t->coupling != COUPLING_NORMAL) {
+		if (t->cov != NULL) {
+			map_couplings(t, t->cov->mean[0], mvnormal_stdev(t->cov, 0),
+				gamma, m);
+			if (t->cond_a != NULL)
+				map_couplings(t, t->cov->mean[1], mvnormal_stdev(t->cov, 1),
+					gammaR, m);
+		}
+		else {
+			if (t->pdf_gamma == NULL)
+				map_couplings(t, t->gamma0, t->dgamma, gamma, m);
+			if (t->cond_a != NULL && t->pdf_gammaR == NULL)
+				map_couplings(t, t->gammaR0, t->dgamma, gammaR, m);
+		}
+	}
+
+	if (t->sampling == SAMPLING_SOBOL || t->nstrata > 0)
+		scale_voltages(t, first, V, m);
+}
+
+/**
+ * \brief Draws the site level energies and hoppings of a batch of chains.
+ *
+ * \param[in] t The trial parameters.
+ * \param[in,out] r The sampler.
+ * \param[in] epsilon The trials' level energies.
+ * \param[out] site The level energies; site[k][j] is site k of trial j.
+ * \param[out] beta The hoppings; beta[k][j] joins sites k and k+1.
+ * \param[in] m The number of trials in the batch.
+ */
+static void draw_chain(const st_trials *t, st_sampler *r,
+	const double *epsilon, double *const *site, double *const *beta, long m) {
+
+	const st_chain *c = t->chain;
+	long j;
+	int k;
+
+	for (k = 0; k < c->nsites; ++k) {
+		if (c->dsite > 0.0) {
+			sampler_gaussian(r, 0.0, c->dsite, site[k], m);
+			for (j = 0; j < m; ++j)
+				site[k][j] += epsilon[j];
+		}
+		else
+			memcpy(site[k], epsilon, m*sizeof(double));
+	}
+
+	for (k = 0; k + 1 < c->nsites; ++k) {
+		if (c->dbeta > 0.0)
+			sampler_gaussian(r, c->beta, c->dbeta, beta[k], m);
+		else
+			for (j = 0; j < m; ++j)
+				beta[k][j] = c->beta;
+	}
+}
+
+/**
+ * \brief Fills the spectra of a batch of molecules.
+ *
+ * \param[in] t The trial parameters.
+ * \param[in,out] r The sampler.
+ * \param[out] lambda The eigenvalues; lambda[k][j] is eigenvalue k of trial
+ *             j.
+ * \param[out] weight The spectral weights; weight[3k+i][j] is weight i of
+ *             eigenvector k of trial j.
+ * \param[out] offset Workspace for the disorder, one row per site and per
+ *             hopping (unused without disorder).
+ * \param[in,out] w Workspace for the decomposition (unused without
+ *                disorder).
+ * \param[in] m The number of trials in the batch.
+ */
+static void draw_molecule(const st_trials *t, st_sampler *r,
+	double *const *lambda, double *const *weight, double *const *offset,
+	st_hamiltonian_work *w, long m) {
+
+	const st_molecule *mol = t->molecule;
+	const st_hamiltonian *h = mol->h;
+	const int n = h->nsites;
+	double *dsite, *dhop, *lam, *wt;
+	long j;
+	int k;
+
+	if (mol->dsite <= 0.0 && mol->dhop <= 0.0) {
+		for (k = 0; k < n; ++k)
+			for (j = 0; j < m; ++j)
+				lambda[k][j] = h->lambda[k];
+		for (k = 0; k < 3*n; ++k)
+			for (j = 0; j < m; ++j)
+				weight[k][j] = h->weight[k];
+		return;
+	}
+
+	for (k = 0; k < n; ++k)
+		sampler_gaussian(r, 0.0, mol->dsite, offset[k], m);
+	for (k = 0; k < h->nhops; ++k)
+		sampler_gaussian(r, 0.0, mol->dhop, offset[n + k], m);
+
+	// one trial at a time: gather its offsets, decompose, and scatter
+	dsite = (double*)malloc((5*n + h->nhops)*sizeof(double));
+	lam = dsite + n;
+	wt = lam + n;
+	dhop = wt + 3*n;
+	for (j = 0; j < m; ++j) {
+		for (k = 0; k < n; ++k)
+			dsite[k] = offset[k][j];
+		for (k = 0; k < h->nhops; ++k)
+			dhop[k] = offset[n + k][j];
+		hamiltonian_spectrum(h, dsite, dhop, w, lam, wt);
+		for (k = 0; k < n; ++k)
+			lambda[k][j] = lam[k];
+		for (k = 0; k < 3*n; ++k)
+			weight[k][j] = wt[k];
+	}
+	free(dsite);
+}
+
+/**
+ * \brief Single-precision version of simulate_trials().
+ */
+static void simulate_trials_f(const st_trials *t, long block, st_sampler *r,
+	void (*use)(const float *V, const float *G, long offset, long m,
+		void *ctx),
+	void *ctx) {
+
+	long i, j, m, ntrials;
+	float gamma[TRIALS_PER_BATCH], epsilon[TRIALS_PER_BATCH];
+	float V[TRIALS_PER_BATCH], GV[TRIALS_PER_BATCH];
+	double gamma_d[TRIALS_PER_BATCH], epsilon_d[TRIALS_PER_BATCH];
+	double V_d[TRIALS_PER_BATCH];
+	st_sobol sobol;
+
+	ntrials = block_trials(t->n, block);
+	start_trials(t, block, block*TRIALS_PER_BLOCK, r, &sobol);
+
+	for (i = 0; i < ntrials; i += TRIALS_PER_BATCH) {
+		m = (ntrials - i < TRIALS_PER_BATCH) ? ntrials - i : TRIALS_PER_BATCH;
+
+		if (t->sampling == SAMPLING_PSEUDO && t->nstrata == 0 &&
+			t->cov == NULL && t->coupling == COUPLING_NORMAL &&
+			t->pdf_gamma == NULL && t->pdf_epsilon == NULL) {
+
+			sampler_flat_f(r, (float)t->Vmin, (float)t->Vmax, V, m);
+			sampler_gaussian_f(r, (float)t->gamma0, (float)t->dgamma, gamma,
+				m);
+			sampler_gaussian_f(r, (float)t->epsilon0, (float)t->depsilon,
+				epsilon, m);
+		}
+		else {
+			draw_trials(t, block*TRIALS_PER_BLOCK + i, r, &sobol, V_d,
+				gamma_d, epsilon_d, NULL, m);
+			for (j = 0; j < m; ++j) {
+				V[j] = (float)V_d[j];
+				gamma[j] = (float)gamma_d[j];
+				epsilon[j] = (float)epsilon_d[j];
+			}
+		}
+
+		t->cond_f(V, gamma, epsilon, (float)t->eta, (float)t->EF, GV, m);
+
+		use(V, GV, i, m, ctx);
+	}
+}
+
+conductance_batch_fn select_model(char model) {
+	switch(model) {
+	case 'i':
+		return conductance_i_batch;
+	case 's':
+		return conductance_s_batch;
+	case 'd':
+		return conductance_d_batch;
+	case 'x':
+		return conductance_x_batch;
+	default:
+		return NULL;
+	}
+}
+
+conductance_batch_a_fn select_model_a(char model) {
+	switch(model) {
+	case 'i':
+		return conductance_ia_batch;
+	case 's':
+		return conductance_sa_batch;
+	case 'd':
+		return conductance_da_batch;
+	default:
+		return NULL;
+	}
+}
+
+conductance_batch_h_fn select_model_h(char model) {
+	switch(model) {
+	case 'i':
+		return conductance_hi_batch;
+	case 's':
+		return conductance_hs_batch;
+	default:
+		return NULL;
+	}
+}
+
+conductance_batch_t_fn select_model_t(char model) {
+	switch(model) {
+	case 'i':
+		return conductance_i_thermal_batch;
+	case 's':
+		return conductance_s_thermal_batch;
+	case 'd':
+		return conductance_d_thermal_batch;
+	case 'x':
+		return conductance_x_thermal_batch;
+	default:
+		return NULL;
+	}
+}
+
+conductance_grid_fn select_model_grid(char model) {
+	switch(model) {
+	case 'i':
+		return conductance_i_grid;
+	case 's':
+		return conductance_s_grid;
+	case 'd':
+		return conductance_d_grid;
+	case 'x':
+		return conductance_x_grid;
+	default:
+		return NULL;
+	}
+}
+
+conductance_batch_f_fn select_model_f(char model) {
+	switch(model) {
+	case 'i':
+		return conductance_i_batch_f;
+	case 's':
+		return conductance_s_batch_f;
+	case 'd':
+		return conductance_d_batch_f;
+	case 'x':
+		return conductance_x_batch_f;
+	default:
+		return NULL;
+	}
+}
+
+int parse_sampling(const char *arg, en_sampling *sampling) {
+	if (strcmp(arg, "pseudo") == 0)
+		*sampling = SAMPLING_PSEUDO;
+	else if (strcmp(arg, "sobol") == 0)
+		*sampling = SAMPLING_SOBOL;
+	else
+		return -1;
+	return 0;
+}
+
+int parse_covariance(const char *arg, int dims, double *cov) {
+	const char *p = arg;
+	char *end;
+	int i, j;
+
+	for (i = 0; i < dims; ++i) {
+		for (j = i; j < dims; ++j) {
+			// separated by commas, and nothing after the last
+			if ((i > 0 || j > 0) && *p++ != ',')
+				return -1;
+			cov[i*dims + j] = cov[j*dims + i] = strtod(p, &end);
+			if (end == p)
+				return -1;
+			p = end;
+		}
+	}
+
+	return (*p == '\0') ? 0 : -1;
+}
+
+int parse_coupling(const char *arg, en_coupling *coupling) {
+	if (strcmp(arg, "normal") == 0)
+		*coupling = COUPLING_NORMAL;
+	else if (strcmp(arg, "truncated") == 0)
+		*coupling = COUPLING_TRUNCATED;
+	else if (strcmp(arg, "lognormal") == 0)
+		*coupling = COUPLING_LOGNORMAL;
+	else
+		return -1;
+	return 0;
+}
+
+int parse_precision(const char *arg, bool *single) {
+	if (strcmp(arg, "double") == 0)
+		*single = false;
+	else if (strcmp(arg, "single") == 0)
+		*single = true;
+	else
+		return -1;
+	return 0;
+}
+
+void simulate_trials(const st_trials *t, long block, st_sampler *r,
+	void (*use)(const double *V, const double *G, long offset, long m,
+		void *ctx),
+	void *ctx) {
+
+	long i, m, ntrials;
+	double gamma[TRIALS_PER_BATCH], epsilon[TRIALS_PER_BATCH];
+	double gammaR[TRIALS_PER_BATCH];
+	double V[TRIALS_PER_BATCH], GV[TRIALS_PER_BATCH];
+	double **rows;
+	st_hamiltonian_work *work;
+	st_sobol sobol;
+	st_widen widen;
+	int k, nrows;
+
+	if (t->cond_f != NULL) {
+		widen.use = use;
+		widen.ctx = ctx;
+		simulate_trials_f(t, block, r, widen_batch, &widen);
+		return;
+	}
+
+	ntrials = block_trials(t->n, block);
+	start_trials(t, block, block*TRIALS_PER_BLOCK, r, &sobol);
+
+	// the chain's site energies, then its hoppings, one row per site; or
+	// the molecule's eigenvalues, weights, and disorder
+	nrows = 0;
+	if (t->chain != NULL)
+		nrows = 2*t->chain->nsites - 1;
+	else if (t->cond_h != NULL)
+		nrows = 5*t->molecule->h->nsites + t->molecule->h->nhops;
+	rows = NULL;
+	if (nrows > 0) {
+		rows = (double**)malloc(nrows*sizeof(double*));
+		rows[0] = (double*)malloc(nrows*TRIALS_PER_BATCH*sizeof(double));
+		for (k = 1; k < nrows; ++k)
+			rows[k] = rows[k-1] + TRIALS_PER_BATCH;
+	}
+
+	work = NULL;
+	if (t->cond_h != NULL)
+		work = hamiltonian_work_alloc(t->molecule->h->nsites);
+
+	for (i = 0; i < ntrials; i += TRIALS_PER_BATCH) {
+		m = (ntrials - i < TRIALS_PER_BATCH) ? ntrials - i : TRIALS_PER_BATCH;
+
+		draw_trials(t, block*TRIALS_PER_BLOCK + i, r, &sobol, V, gamma,
+			epsilon, gammaR, m);
+
+		if (t->chain != NULL) {
+			draw_chain(t, r, epsilon, rows, rows + t->chain->nsites, m);
+			conductance_c_batch(V, gamma, rows, rows + t->chain->nsites,
+				t->chain->nsites, t->eta, t->EF, GV, m);
+		}
+		else if (t->cond_h != NULL) {
+			k = t->molecule->h->nsites;
+
+			// without disorder, every batch has the same spectra
+			if (i == 0 || t->molecule->dsite > 0.0 || t->molecule->dhop > 0.0)
+				draw_molecule(t, r, rows, rows + k, rows + 4*k, work, m);
+			t->cond_h(V, gamma, epsilon, rows, rows + k, k, t->eta, t->EF, GV,
+				m);
+		}
+		else if (t->cond_a != NULL)
+			t->cond_a(V, gamma, gammaR, epsilon, t->eta, t->EF, GV, m);
+		else if (t->cond_t != NULL)
+			t->cond_t(V, gamma, epsilon, t->eta, t->EF, t->kT, GV, m);
+		else
+			t->cond(V, gamma, epsilon, t->eta, t->EF, GV, m);
+
+		use(V, GV, i, m, ctx);
+	}
+
+	if (rows != NULL) {
+		free(rows[0]);
+		free(rows);
+	}
+	if (work != NULL)
+		hamiltonian_work_free(work);
+}
+
+void simulate_traces(const st_trials *t, conductance_grid_fn grid,
+	const double *V, long nV, long block, st_sampler *r,
+	void (*use)(const double *I, const double *G, long m, void *ctx),
+	void *ctx) {
+
+	long first, m;
+	double gamma[TRACES_PER_BLOCK], epsilon[TRACES_PER_BLOCK];
+	double Vdrawn[TRACES_PER_BLOCK], Gz[TRACES_PER_BLOCK];
+	double *G, *I;
+	const double zero = 0.0;
+	st_sobol sobol;
+
+	first = block*TRACES_PER_BLOCK;
+	m = (t->n - first < TRACES_PER_BLOCK) ? t->n - first : TRACES_PER_BLOCK;
+	start_trials(t, block, first, r, &sobol);
+
+	G = (double*)malloc(2*nV*m*sizeof(double));
+	I = G + nV*m;
+
+	draw_trials(t, first, r, &sobol, Vdrawn, gamma, epsilon, NULL, m);
+
+	grid(V, nV, gamma, epsilon, t->eta, t->EF, G, m);
+	grid(&zero, 1, gamma, epsilon, t->eta, t->EF, Gz, m);
+	conductance_current(V, nV, G, Gz, I, m);
+
+	use(I, G, m, ctx);
+
+	free(G);
+}
+
+void trials_log_range(const st_trials *t, long block, st_sampler *r,
+	double *gmin, double *gmax) {
+
+	st_log_range range;
+
+	range.gmin = gmin;
+	range.gmax = gmax;
+	if (t->cond_f != NULL)
+		simulate_trials_f(t, block, r, log_range_batch_f, &range);
+	else
+		simulate_trials(t, block, r, log_range_batch, &range);
+}
+
+void trials_histogram(const st_trials *t, long block, st_sampler *r,
+	gsl_histogram2d *h) {
+
+	if (t->cond_f != NULL)
+		simulate_trials_f(t, block, r, histogram_batch_f, h);
+	else
+		simulate_trials(t, block, r, histogram_batch, h);
+}
+
+void write_histogram(FILE *f, gsl_histogram2d *h, int nbin, en_format format,
+	const st_stream_header *header) {
+
+	int i, j;
+	double minv, maxv, ming, maxg, maxc;
+	double *binv, *bing, *binc, row[3];
+	const double *cols[3];
+	st_text_output *text;
+
+	maxc = gsl_histogram2d_max_val(h);
+	if (maxc > 0.0)
+		gsl_histogram2d_scale(h, 1.0 / maxc);
+
+	binv = (double*)malloc(nbin*sizeof(double));
+	bing = (double*)malloc(nbin*sizeof(double));
+	binc = (double*)malloc(nbin*sizeof(double));
+	cols[0] = binv;
+	cols[1] = bing;
+	cols[2] = binc;
+	text = text_output_alloc(f);
+
+	if (format != FORMAT_TEXT)
+		stream_write_header(f, header);
+
+	for (i = 0; i < nbin; ++i) {
+		gsl_histogram2d_get_xrange(h, i, &minv, &maxv);
+
+		for (j = 0; j < nbin; ++j) {
+			gsl_histogram2d_get_yrange(h, j, &ming, &maxg);
+			binv[j] = 0.5*(maxv + minv);
+			bing[j] = 0.5*(maxg + ming);
+			binc[j] = gsl_histogram2d_get(h, i, j);
+		}
+
+		if (format != FORMAT_TEXT) {
+			stream_write_frame(f, header, cols, nbin);
+			continue;
+		}
+
+		for (j = 0; j < nbin; ++j) {
+			row[0] = binv[j];
+			row[1] = bing[j];
+			row[2] = binc[j];
+			text_output_row(text, row, 3, true);
+		}
+
+		// need a newline for plotting with gnuplot
+		text_output_newline(text);
+	}
+	text_output_free(text);
+
+	if (format != FORMAT_TEXT)
+		stream_write_end(f);
+
+	free(binc);
+	free(bing);
+	free(binv);
+}
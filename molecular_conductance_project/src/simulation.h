@@ -0,0 +1,466 @@
+/*
+This work is licensed under the Creative Commons Attribution 3.0 United States
+License. To view a copy of this license, visit
+http://creativecommons.org/licenses/by/3.0/us/ or send a letter to Creative
+Commons, 444 Castro Street, Suite 900, Mountain View, California, 94041, USA.
+
+Copyright (C) 2013 Oak Ridge National Laboratory
+*/
+/**
+ * \file simulation.h
+ * \brief Prototypes for simulating blocks of voltage-dependent conductance
+ *        trials and binning them into 2D histograms.
+ *
+ * These are shared by final-sim-v-2d and the parameter sweep so that a
+ * histogram is the same whichever program produces it. Each block of trials
+ * (see parallel.h) is simulated from its own random number stream, seeded
+ * from the block index, or from its own stretch of a scrambled Sobol
+ * sequence (see sobol.h).
+ *
+ * \author agent
+ * \date October 2026
+ */
+
+#ifndef __simulation_h__
+#define __simulation_h__
+
+#include <cstdio>
+#include <cstddef>
+#include <gsl/gsl_histogram2d.h>
+#include <gsl/gsl_rng.h>
+#include "sampler.h"
+#include "sample-stream.h"
+#include "distributions.h"
+#include "hamiltonian.h"
+#include "parallel.h"
+
+/// The seed from which each block's seed is derived.
+#define SIMULATION_SEED 0xFEEDFACE
+
+/// The seed of the original programs' GSL stream (legacy sampling).
+#define SIMULATION_LEGACY_SEED 0xFEEDFACE
+
+/// Boltzmann's constant (eV/K).
+#define BOLTZMANN 8.617333262e-5
+
+/// The number of junctions in each block of traces (the last block may be
+/// shorter), which bounds the memory a block's traces take.
+#define TRACES_PER_BLOCK TRIALS_PER_BATCH
+
+/**
+ * \brief How the random parameters of the trials are drawn.
+ */
+typedef enum {
+	/// Pseudo-random numbers (see sampler.h).
+	SAMPLING_PSEUDO,
+
+	/// Scrambled Sobol points (see sobol.h).
+	SAMPLING_SOBOL,
+
+	/// The draws of the original programs: gsl_rng_uniform() and
+	/// gsl_ran_gaussian() from one GSL stream (st_trials::legacy), trial by
+	/// trial. The blocks must be simulated in order, on one thread.
+	SAMPLING_LEGACY
+} en_sampling;
+
+/**
+ * \brief The distribution of the couplings.
+ */
+typedef enum {
+	/// Normal.
+	COUPLING_NORMAL,
+
+	/// Normal, truncated to positive couplings (see normal_truncate()).
+	COUPLING_TRUNCATED,
+
+	/// Log-normal, with the same average and standard deviation (see
+	/// normal_to_lognormal()).
+	COUPLING_LOGNORMAL
+} en_coupling;
+
+/**
+ * \brief The batch conductance functions (see conductance.h).
+ */
+typedef void (*conductance_batch_fn)(const double*, const double*,
+	const double*, double, double, double*, size_t);
+
+/**
+ * \brief The batch conductance functions with asymmetric coupling (see
+ *        conductance.h).
+ */
+typedef void (*conductance_batch_a_fn)(const double*, const double*,
+	const double*, const double*, double, double, double*, size_t);
+
+/**
+ * \brief The batch conductance functions of the molecule models (see
+ *        conductance.h).
+ */
+typedef void (*conductance_batch_h_fn)(const double*, const double*,
+	const double*, const double *const*, const double *const*, int, double,
+	double, double*, size_t);
+
+/**
+ * \brief The finite-temperature batch conductance functions (see
+ *        conductance.h).
+ */
+typedef void (*conductance_batch_t_fn)(const double*, const double*,
+	const double*, double, double, double, double*, size_t);
+
+/**
+ * \brief The voltage grid conductance functions (see conductance.h).
+ */
+typedef void (*conductance_grid_fn)(const double*, size_t, const double*,
+	const double*, double, double, double*, size_t);
+
+/**
+ * \brief The single-precision batch conductance functions (see
+ *        conductance.h).
+ */
+typedef void (*conductance_batch_f_fn)(const float*, const float*,
+	const float*, float, float, float*, size_t);
+
+/**
+ * \brief The sites of the chain model (see conductance_c()).
+ */
+typedef struct {
+	/// The number of sites.
+	int nsites;
+
+	/// The average and standard deviation of the hoppings (eV).
+	double beta, dbeta;
+
+	/// The standard deviation of each site's level energy about the trial's
+	/// level energy (eV).
+	double dsite;
+} st_chain;
+
+/**
+ * \brief The molecule of the molecule models (see conductance_hi()).
+ */
+typedef struct {
+	/// The Hamiltonian, relative to the trial's level energy.
+	const st_hamiltonian *h;
+
+	/// The standard deviation of each on-site energy and each (nonzero)
+	/// hopping about the Hamiltonian's (eV).
+	double dsite, dhop;
+} st_molecule;
+
+/**
+ * \brief The parameters of a set of trials.
+ */
+typedef struct {
+	/// The conductance model (batch version).
+	conductance_batch_fn cond;
+
+	/// The single-precision version of the model, or NULL to simulate in
+	/// double precision.
+	conductance_batch_f_fn cond_f;
+
+	/// The model with asymmetric coupling, used instead of cond; or NULL
+	/// for symmetric coupling.
+	conductance_batch_a_fn cond_a;
+
+	/// The chain model, used instead of cond; or NULL.
+	const st_chain *chain;
+
+	/// The molecule model, used instead of cond; or NULL.
+	conductance_batch_h_fn cond_h;
+
+	/// The molecule (molecule models only).
+	const st_molecule *molecule;
+
+	/// The finite-temperature version of the model, used instead of cond;
+	/// or NULL at zero temperature.
+	conductance_batch_t_fn cond_t;
+
+	/// The thermal energy, k_B T (eV; finite temperature only).
+	double kT;
+
+	/// The total number of trials.
+	long n;
+
+	/// The Fermi level (eV).
+	double EF;
+
+	/// The standard deviation and average of the site level energy (eV).
+	double depsilon, epsilon0;
+
+	/// The standard deviation and average of the coupling (eV); with
+	/// asymmetric coupling, gamma0 is the average for one electrode.
+	double dgamma, gamma0;
+
+	/// The average coupling for the other electrode (eV; asymmetric
+	/// coupling only).
+	double gammaR0;
+
+	/// The joint distribution of the couplings and level energy, or NULL
+	/// to draw them independently. Its variables are (gamma, epsilon), or
+	/// (gammaL, gammaR, epsilon) with asymmetric coupling.
+	const st_mvnormal *cov;
+
+	/// The distribution of the couplings.
+	en_coupling coupling;
+
+	/// Tabulated distributions of the coupling, the other coupling
+	/// (asymmetric coupling only), and the level energy, used instead of
+	/// the normal ones; or NULL.
+	const st_empirical_dist *pdf_gamma, *pdf_gammaR, *pdf_epsilon;
+
+	/// The range of the applied bias (V).
+	double Vmin, Vmax;
+
+	/// The relative voltage drop for one electrode.
+	double eta;
+
+	/// How the voltage, couplings, and site energy are drawn.
+	en_sampling sampling;
+
+	/// The Sobol replica (scrambling) number.
+	unsigned long replica;
+
+	/// The GSL stream of legacy sampling, reseeded by block 0; or NULL.
+	gsl_rng *legacy;
+
+	/// The number of voltage strata, or 0 to draw voltages without
+	/// stratification.
+	long nstrata;
+} st_trials;
+
+/**
+ * \brief Gets the batch conductance function for a model.
+ *
+ * \param[in] model `i', `s', `d', or `x'.
+ * \return The function, or NULL if the model is unknown.
+ */
+conductance_batch_fn select_model(char model);
+
+/**
+ * \brief Gets the single-precision batch conductance function for a model.
+ *
+ * \param[in] model `i', `s', `d', or `x'.
+ * \return The function, or NULL if the model is unknown.
+ */
+conductance_batch_f_fn select_model_f(char model);
+
+/**
+ * \brief Gets the batch conductance function for a model with asymmetric
+ *        coupling.
+ *
+ * \param[in] model `i', `s', or `d' (for ia, sa, or da).
+ * \return The function, or NULL if the model is unknown.
+ */
+conductance_batch_a_fn select_model_a(char model);
+
+/**
+ * \brief Gets the batch conductance function for a molecule model.
+ *
+ * \param[in] model `i' or `s' (for hi or hs).
+ * \return The function, or NULL if the model is unknown.
+ */
+conductance_batch_h_fn select_model_h(char model);
+
+/**
+ * \brief Gets the finite-temperature batch conductance function for a
+ *        model.
+ *
+ * \param[in] model `i', `s', `d', or `x'.
+ * \return The function, or NULL if the model is unknown.
+ */
+conductance_batch_t_fn select_model_t(char model);
+
+/**
+ * \brief Gets the voltage grid conductance function for a model.
+ *
+ * \param[in] model `i', `s', `d', or `x'.
+ * \return The function, or NULL if the model is unknown.
+ */
+conductance_grid_fn select_model_grid(char model);
+
+/**
+ * \brief Parses the argument of a `--sampler' option.
+ *
+ * \param[in] arg `pseudo' or `sobol'.
+ * \param[out] sampling The sampling method.
+ * \return 0 if the method is recognized; -1 otherwise.
+ */
+int parse_sampling(const char *arg, en_sampling *sampling);
+
+/**
+ * \brief Parses the argument of a `--coupling' option.
+ *
+ * \param[in] arg `normal', `truncated', or `lognormal'.
+ * \param[out] coupling The distribution of the couplings.
+ * \return 0 if the distribution is recognized; -1 otherwise.
+ */
+int parse_coupling(const char *arg, en_coupling *coupling);
+
+/**
+ * \brief Parses the argument of a `--precision' option.
+ *
+ * \param[in] arg `double' or `single'.
+ * \param[out] single Whether to simulate in single precision.
+ * \return 0 if the precision is recognized; -1 otherwise.
+ */
+int parse_precision(const char *arg, bool *single);
+
+/**
+ * \brief Parses the argument of a `--cov' option.
+ *
+ * The argument lists the upper triangle of a symmetric matrix row by row,
+ * separated by commas; for example `a,b,c' is the 2 x 2 matrix with a and c
+ * on the diagonal and b off it.
+ *
+ * \param[in] arg The list.
+ * \param[in] dims The size of the matrix.
+ * \param[out] cov The matrix, dims x dims in row-major order.
+ * \return 0 if the list has dims (dims + 1) / 2 numbers; -1 otherwise.
+ */
+int parse_covariance(const char *arg, int dims, double *cov);
+
+/**
+ * \brief Simulates one block of trials, handing each batch to a callback.
+ *
+ * With Sobol sampling, block b uses points b*#TRIALS_PER_BLOCK onward of the
+ * sequence; the voltage is the first coordinate and the normal parameters
+ * come from the others through normal_quantile().
+ *
+ * With t->cond_a set, each trial also draws a coupling for the other
+ * electrode, after the others (from the sampler, or from a fourth Sobol
+ * coordinate), so that the voltages, first couplings, and level energies
+ * are the same as in a symmetric run.
+ *
+ * With t->cov set, the couplings and level energies are drawn as standard
+ * normal numbers in the same way and then mapped through t->cov in bulk
+ * (see mvnormal_transform()); the averages and standard deviations in t
+ * are not used.
+ *
+ * With t->coupling other than #COUPLING_NORMAL, the couplings are drawn as
+ * normal numbers (after t->cov, if set) and then mapped to the coupling
+ * distribution with the same average and standard deviation. The other
+ * parameters, and the random number streams, are unaffected.
+ *
+ * With t->chain set, the conductances come from conductance_c_batch(). Each
+ * site's level energy is the trial's plus a normal offset, and each hopping
+ * is normal; these are drawn after the other parameters, and always from
+ * the sampler (like a beta-distributed eta, even with Sobol points), so the
+ * Sobol dimensions do not grow with the chain.
+ *
+ * With t->cond_h set, the conductances come from it and the spectrum of
+ * t->molecule. Without disorder the spectrum is the one found when the
+ * Hamiltonian was read. Otherwise normal offsets are drawn for the on-site
+ * energies and then the hoppings of each trial (like the chain's, from the
+ * sampler), and each trial's Hamiltonian is decomposed afresh.
+ *
+ * With t->cond_t set, the conductances come from it at thermal energy t->kT;
+ * the trials are drawn as at zero temperature.
+ *
+ * A parameter with a tabulated distribution (t->pdf_gamma, and so on) is
+ * drawn from it instead, through its quantile function: from the same
+ * Sobol coordinate, or from uniform numbers drawn in its place. Such a
+ * coupling is not mapped by t->coupling, and t->cov must not be set.
+ *
+ * With t->nstrata > 0, [Vmin, Vmax] is divided into equal strata and trial k
+ * of the run (counting from the first trial of block 0) is placed uniformly
+ * at random within stratum k mod t->nstrata. Every stratum then receives
+ * n / t->nstrata trials, give or take one.
+ *
+ * With t->cond_f set, the trials are simulated in single precision:
+ * pseudo-random parameters come from the single-precision sampler functions
+ * (unless t->cov is set or a parameter is not normal)
+ * (Sobol points and stratified voltages are drawn as usual and rounded), and
+ * the conductances come from t->cond_f. They are widened again for use.
+ *
+ * \param[in] t The trial parameters.
+ * \param[in] block The block index.
+ * \param[in,out] r The sampler to use (it is reseeded for the block; unused
+ *                  with Sobol sampling).
+ * \param[in] use Called with the voltages, conductances, offset within the
+ *            block, and size of each batch.
+ * \param[in] ctx Passed through to use.
+ */
+void simulate_trials(const st_trials *t, long block, st_sampler *r,
+	void (*use)(const double *V, const double *G, long offset, long m,
+		void *ctx),
+	void *ctx);
+
+/**
+ * \brief Traces the current and conductance of one block of junctions
+ *        across a grid of voltages.
+ *
+ * A block of traces holds #TRACES_PER_BLOCK junctions, not the
+ * #TRIALS_PER_BLOCK trials of simulate_trials(), so that its traces fit in
+ * a modest buffer. The junctions are drawn as trials are, and their drawn
+ * voltages are not used. With Sobol (or legacy) sampling, junction k is
+ * that of trial k; with pseudo-random sampling, block b draws from the
+ * stream of trial block b, so junction k is trial k only in the first
+ * block. Each junction is evaluated at every voltage of the grid by grid,
+ * and its current is integrated from the conductances by
+ * conductance_current(). Only the symmetric, zero-temperature,
+ * double-precision models are traced (t->cond, without t->chain,
+ * t->molecule, t->cond_a, t->cond_t, or t->cond_f).
+ *
+ * \param[in] t The trial parameters.
+ * \param[in] grid The voltage grid version of t->cond.
+ * \param[in] V The voltages, in increasing order.
+ * \param[in] nV The number of voltages.
+ * \param[in] block The block index.
+ * \param[in,out] r The sampler to use (as for simulate_trials()).
+ * \param[in] use Called with the currents (in units of G0 V) and
+ *            conductances of the block, and the number of junctions in it;
+ *            I[k*m + j] is junction j at voltage k.
+ * \param[in] ctx Passed through to use.
+ */
+void simulate_traces(const st_trials *t, conductance_grid_fn grid,
+	const double *V, long nV, long block, st_sampler *r,
+	void (*use)(const double *I, const double *G, long m, void *ctx),
+	void *ctx);
+
+/**
+ * \brief Widens a log10 conductance range to cover one block of trials.
+ *
+ * In single precision (t->cond_f set) the logarithms are also taken in
+ * single precision.
+ *
+ * \param[in] t The trial parameters.
+ * \param[in] block The block index.
+ * \param[in,out] r The sampler to use.
+ * \param[in,out] gmin The smallest log10 conductance seen.
+ * \param[in,out] gmax The largest log10 conductance seen.
+ */
+void trials_log_range(const st_trials *t, long block, st_sampler *r,
+	double *gmin, double *gmax);
+
+/**
+ * \brief Bins one block of trials by voltage and log10 conductance.
+ *
+ * In single precision (t->cond_f set) the bins are computed directly from
+ * single-precision logarithms, which assumes that h has uniform ranges.
+ *
+ * \param[in] t The trial parameters.
+ * \param[in] block The block index.
+ * \param[in,out] r The sampler to use.
+ * \param[in,out] h The histogram.
+ */
+void trials_histogram(const st_trials *t, long block, st_sampler *r,
+	gsl_histogram2d *h);
+
+/**
+ * \brief Writes a histogram, scaled so that the largest bin is 1.
+ *
+ * The text layout matches final-binner-v-2d: one line of voltage, log10
+ * conductance, and count per bin, with a blank line after each voltage. The
+ * binary formats have columns `V', `logG', and `count', with one frame per
+ * voltage.
+ *
+ * \param[in] f The output file.
+ * \param[in,out] h The histogram (it is scaled).
+ * \param[in] nbin The number of bins in each direction.
+ * \param[in] format The output format.
+ * \param[in] header The stream header (binary formats only); its frame size
+ *            must be nbin.
+ */
+void write_histogram(FILE *f, gsl_histogram2d *h, int nbin, en_format format,
+	const st_stream_header *header);
+
+#endif
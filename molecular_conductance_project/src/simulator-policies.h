@@ -0,0 +1,764 @@
+/*
+This work is licensed under the Creative Commons Attribution 3.0 United States
+License. To view a copy of this license, visit
+http://creativecommons.org/licenses/by/3.0/us/ or send a letter to Creative
+Commons, 444 Castro Street, Suite 900, Mountain View, California, 94041, USA.
+
+Copyright (C) 2013 Oak Ridge National Laboratory
+*/
+/**
+ * \file simulator-policies.h
+ * \brief Compile-time policies for the Lorentzian conductance simulators.
+ *
+ * The simulator variants differ only in the transmission model, how the
+ * voltage is chosen, whether eta is fixed or beta distributed, and whether
+ * the average site level energy is fixed or linear in the voltage. Each of
+ * these is a policy class below, and simulate() combines one of each (plus a
+ * source of random numbers) into a simulator whose inner loop is completely
+ * inlined; there is no call through a function pointer per trial.
+ *
+ * simulate_junctions() is the alternative for the voltage grid that draws
+ * each junction once and evaluates it at every voltage.
+ *
+ * Every policy draws its random numbers a batch at a time. The order of the
+ * draws is a policy too, so that each variant reproduces the random numbers
+ * of the program it replaced; with legacy_source, whose batches are single
+ * trials, they are exactly the original program's numbers. The couplings and
+ * the site level energy are normal unless they are given a tabulated
+ * distribution (see draw_param()).
+ *
+ * \author agent
+ * \date October 2026
+ */
+
+#ifndef __simulator_policies_h__
+#define __simulator_policies_h__
+
+#include <cstdlib>
+#include <gsl/gsl_rng.h>
+#include <gsl/gsl_randist.h>
+#include "conductance.h"
+#include "distributions.h"
+#include "parallel.h"
+#include "sampler.h"
+#include "sample-stream.h"
+#include "sobol.h"
+#include "text-format.h"
+
+/**
+ * \brief The parameters of a simulation (see the command-line arguments).
+ *
+ * Each variant uses some of them; the rest are zero.
+ */
+typedef struct {
+	/// The number of trials (per voltage, for a voltage grid).
+	long n;
+
+	/// The Fermi level (eV).
+	double EF;
+
+	/// The standard deviation and average of the site level energy (eV).
+	double depsilon, epsilon0;
+
+	/// The slope (eV/V) and intercept (eV) of the average site level energy,
+	/// when it is linear in the voltage.
+	double mepsilon, bepsilon;
+
+	/// The standard deviation of the couplings (eV).
+	double dgamma;
+
+	/// The average couplings to the two electrodes (eV); gamma1 is also
+	/// gamma0 of the symmetric models.
+	double gamma1, gamma2;
+
+	/// The fixed applied bias (V).
+	double V;
+
+	/// The range and step size of the applied bias (V).
+	double Vmin, Vmax, Vstep;
+
+	/// The relative voltage drop for one electrode.
+	double eta;
+
+	/// The parameters of the beta distribution of eta.
+	double eta_alpha, eta_beta;
+
+	/// The tabulated beta distribution of eta, or NULL if it is unbounded
+	/// (eta_alpha < 1 or eta_beta < 1).
+	st_beta_dist *eta_dist;
+
+	/// The sampler for the tabulated beta distribution.
+	st_sampler *eta_r;
+
+	/// The generator for the beta distribution when it is not tabulated.
+	gsl_rng *beta_rng;
+
+	/// Tabulated distributions of the two couplings and of the site level
+	/// energy (its fluctuation, when the average is linear in the voltage),
+	/// used instead of the normal ones; or NULL.
+	const st_empirical_dist *gamma1_pdf, *gamma2_pdf, *epsilon_pdf;
+} st_sim_params;
+
+/**
+ * \brief A batch of trials.
+ */
+typedef struct {
+	/// The applied bias.
+	double V[TRIALS_PER_BATCH];
+
+	/// The couplings to the two electrodes.
+	double gammaL[TRIALS_PER_BATCH], gammaR[TRIALS_PER_BATCH];
+
+	/// The site level energy.
+	double epsilon[TRIALS_PER_BATCH];
+
+	/// The relative voltage drop.
+	double eta[TRIALS_PER_BATCH];
+
+	/// The conductance.
+	double G[TRIALS_PER_BATCH];
+} st_sim_batch;
+
+/**
+ * \brief Where the trials go.
+ */
+typedef struct {
+	/// The output format.
+	en_format format;
+
+	/// The stream header (binary formats only).
+	st_stream_header header;
+
+	/// The text output (text format only).
+	st_text_output *text;
+
+	/// Whether the voltage is output along with the conductance.
+	bool voltage;
+} st_sim_output;
+
+/**
+ * \brief Outputs a batch of trials.
+ *
+ * \param[in,out] out The output.
+ * \param[in] b The batch.
+ * \param[in] m The number of trials in the batch.
+ */
+inline void output_batch(st_sim_output *out, const st_sim_batch *b, long m) {
+	const double *cols[2];
+	double row[2];
+	long j;
+
+	if (out->format != FORMAT_TEXT) {
+		cols[0] = out->voltage ? b->V : b->G;
+		cols[1] = b->G;
+		stream_write_frame(stdout, &out->header, cols, m);
+		return;
+	}
+
+	for (j = 0; j < m; ++j) {
+		row[0] = b->V[j];
+		row[1] = b->G[j];
+		if (out->voltage)
+			text_output_row(out->text, row, 2, false);
+		else
+			text_output_row(out->text, row + 1, 1, false);
+	}
+}
+
+// ---------------------------------------------------------------------------
+// Random number sources
+
+/**
+ * \brief Pseudo-random numbers from one sampler.
+ */
+class pseudo_source {
+public:
+	/// The most trials in a batch.
+	enum { batch = TRIALS_PER_BATCH };
+
+	/// The sampler.
+	st_sampler *r;
+
+	/// Prepares the random numbers for a batch of m trials.
+	void begin(long m) {}
+
+	/// Draws m uniform numbers in [a, b).
+	void uniform(double a, double b, double *x, long m) {
+		sampler_flat(r, a, b, x, m);
+	}
+
+	/// Draws m normal numbers.
+	void gaussian(double mean, double stdev, double *x, long m) {
+		sampler_gaussian(r, mean, stdev, x, m);
+	}
+};
+
+/**
+ * \brief Scrambled Sobol points; each draw in a batch is one dimension.
+ */
+class sobol_source {
+public:
+	/// The most trials in a batch.
+	enum { batch = TRIALS_PER_BATCH };
+
+	/// The sequence.
+	st_sobol s;
+
+	/// The points of the current batch.
+	double u[SOBOL_MAX_DIMS][TRIALS_PER_BATCH];
+
+	/// The next dimension to use.
+	int next;
+
+	/// Prepares the random numbers for a batch of m trials.
+	void begin(long m) {
+		double *p[SOBOL_MAX_DIMS];
+		int d;
+
+		for (d = 0; d < s.dims; ++d)
+			p[d] = u[d];
+		sobol_next(&s, p, m);
+		next = 0;
+	}
+
+	/// Draws m uniform numbers in [a, b).
+	void uniform(double a, double b, double *x, long m) {
+		const double *v = u[next++];
+		long j;
+
+		for (j = 0; j < m; ++j)
+			x[j] = a + (b - a) * v[j];
+	}
+
+	/// Draws m normal numbers.
+	void gaussian(double mean, double stdev, double *x, long m) {
+		const double *v = u[next++];
+		long j;
+
+		for (j = 0; j < m; ++j)
+			x[j] = mean + stdev * normal_quantile(v[j]);
+	}
+};
+
+/**
+ * \brief The original programs' random numbers: gsl_rng_uniform() and
+ *        gsl_ran_gaussian() from one GSL stream.
+ *
+ * The original programs drew all of a trial's numbers before the next
+ * trial's, so a batch holds one trial.
+ */
+class legacy_source {
+public:
+	/// The most trials in a batch.
+	enum { batch = 1 };
+
+	/// The generator.
+	gsl_rng *r;
+
+	/// Prepares the random numbers for a batch of m trials.
+	void begin(long m) {}
+
+	/// Draws m uniform numbers in [a, b).
+	void uniform(double a, double b, double *x, long m) {
+		long j;
+
+		for (j = 0; j < m; ++j)
+			x[j] = a + gsl_rng_uniform(r) * (b - a);
+	}
+
+	/// Draws m normal numbers.
+	void gaussian(double mean, double stdev, double *x, long m) {
+		long j;
+
+		for (j = 0; j < m; ++j)
+			x[j] = gsl_ran_gaussian(r, stdev) + mean;
+	}
+};
+
+/**
+ * \brief Draws m values of a parameter.
+ *
+ * With a tabulated distribution, the parameter takes the place of one normal
+ * draw: one uniform number (or Sobol coordinate) each, mapped through the
+ * distribution's quantile function.
+ *
+ * \param[in,out] src The source of random numbers.
+ * \param[in] pdf The tabulated distribution, or NULL for a normal one.
+ * \param[in] mean The average of the normal distribution.
+ * \param[in] stdev Its standard deviation.
+ * \param[out] x The values.
+ * \param[in] m The number of values.
+ */
+template <class Source>
+inline void draw_param(Source *src, const st_empirical_dist *pdf, double mean,
+	double stdev, double *x, long m) {
+
+	if (pdf == NULL) {
+		src->gaussian(mean, stdev, x, m);
+		return;
+	}
+
+	src->uniform(0.0, 1.0, x, m);
+	empirical_dist_quantile(pdf, x, x, m);
+}
+
+// ---------------------------------------------------------------------------
+// Transmission models
+
+/**
+ * \brief Symmetric coupling, T = 4 gamma^2 / (4 (E-epsilon)^2 + (2 gamma)^2).
+ */
+struct model_pair_symmetric {
+	/// The number of random numbers drawn per trial.
+	enum { draws = 0 };
+
+	/// Draws the second coupling (none; it equals the first).
+	template <class Source>
+	static void draw(const st_sim_params *p, Source *src, st_sim_batch *b,
+		long m) {}
+
+	/// The transmission at energy E.
+	static double transmission(const st_sim_batch *b, long j, double E) {
+		double gamma = b->gammaL[j], x = E - b->epsilon[j];
+
+		return 4.0*gamma*gamma / (4.0*x*x + (gamma + gamma)*(gamma + gamma));
+	}
+};
+
+/**
+ * \brief Asymmetric coupling, T = 4 gammaL gammaR / (4 (E-epsilon)^2 +
+ *        (gammaL + gammaR)^2).
+ */
+struct model_pair_asymmetric {
+	/// The number of random numbers drawn per trial.
+	enum { draws = 1 };
+
+	/// Draws the second coupling.
+	template <class Source>
+	static void draw(const st_sim_params *p, Source *src, st_sim_batch *b,
+		long m) {
+
+		draw_param(src, p->gamma2_pdf, p->gamma2, p->dgamma, b->gammaR, m);
+	}
+
+	/// The transmission at energy E.
+	static double transmission(const st_sim_batch *b, long j, double E) {
+		double gL = b->gammaL[j], gR = b->gammaR[j], x = E - b->epsilon[j];
+
+		return 4.0*gL*gR / (4.0*x*x + (gL + gR)*(gL + gR));
+	}
+};
+
+/**
+ * \brief Symmetric coupling, T = gamma^2 / ((E-epsilon)^2 + gamma^2).
+ */
+struct model_symmetric {
+	/// The number of random numbers drawn per trial.
+	enum { draws = 0 };
+
+	/// Draws the second coupling (none; it equals the first).
+	template <class Source>
+	static void draw(const st_sim_params *p, Source *src, st_sim_batch *b,
+		long m) {}
+
+	/// The transmission at energy E.
+	static double transmission(const st_sim_batch *b, long j, double E) {
+		double gamma = b->gammaL[j], x = E - b->epsilon[j];
+
+		return gamma*gamma / (x*x + gamma*gamma);
+	}
+
+	/// The conductances of m trials at each of nV voltages, with a fixed
+	/// eta; G[k*m + j] is trial j at voltage k. This is the voltage-
+	/// independent model of conductance.h, whose grid function gives the same
+	/// conductances as transmission() does.
+	static void grid(const st_sim_params *p, const double *V, long nV,
+		const st_sim_batch *b, double *G, long m) {
+
+		conductance_i_grid(V, nV, b->gammaL, b->epsilon, p->eta, p->EF, G, m);
+	}
+};
+
+// ---------------------------------------------------------------------------
+// Voltage policies
+
+/**
+ * \brief No applied bias; the conductance is the transmission at EF.
+ */
+struct voltage_none {
+	/// The number of random numbers drawn per trial.
+	enum { draws = 0 };
+
+	/// Whether the bias window is used.
+	static const bool biased = false;
+
+	/// The number of voltages to loop over.
+	static long points(const st_sim_params *p) {
+		return 1;
+	}
+
+	/// Sets the voltages of a batch.
+	template <class Source>
+	static void draw(const st_sim_params *p, long k, Source *src,
+		double *V, long m) {
+
+		long j;
+
+		for (j = 0; j < m; ++j)
+			V[j] = 0.0;
+	}
+};
+
+/**
+ * \brief A fixed applied bias.
+ */
+struct voltage_fixed {
+	/// The number of random numbers drawn per trial.
+	enum { draws = 0 };
+
+	/// Whether the bias window is used.
+	static const bool biased = true;
+
+	/// The number of voltages to loop over.
+	static long points(const st_sim_params *p) {
+		return 1;
+	}
+
+	/// Sets the voltages of a batch.
+	template <class Source>
+	static void draw(const st_sim_params *p, long k, Source *src,
+		double *V, long m) {
+
+		long j;
+
+		for (j = 0; j < m; ++j)
+			V[j] = p->V;
+	}
+};
+
+/**
+ * \brief n trials at each voltage Vmin, Vmin + Vstep, ... below Vmax.
+ */
+struct voltage_grid {
+	/// The number of random numbers drawn per trial.
+	enum { draws = 0 };
+
+	/// Whether the bias window is used.
+	static const bool biased = true;
+
+	/// The number of voltages to loop over.
+	static long points(const st_sim_params *p) {
+		double V;
+		long k = 0;
+
+		// count exactly as the loop over the voltages steps
+		for (V = p->Vmin; V < p->Vmax; V += p->Vstep)
+			++k;
+		return k;
+	}
+
+	/// Gets all of the voltages, as draw() sets them.
+	static void voltages(const st_sim_params *p, double *V) {
+		double v = p->Vmin;
+		long k, npoints = points(p);
+
+		for (k = 0; k < npoints; ++k) {
+			V[k] = v;
+			v += p->Vstep;
+		}
+	}
+
+	/// Sets the voltages of a batch.
+	template <class Source>
+	static void draw(const st_sim_params *p, long k, Source *src,
+		double *V, long m) {
+
+		double v = p->Vmin;
+		long j;
+
+		// accumulate the steps, as the original loop did
+		for (j = 0; j < k; ++j)
+			v += p->Vstep;
+		for (j = 0; j < m; ++j)
+			V[j] = v;
+	}
+};
+
+/**
+ * \brief A voltage drawn uniformly from [Vmin, Vmax) for each trial.
+ */
+struct voltage_uniform {
+	/// The number of random numbers drawn per trial.
+	enum { draws = 1 };
+
+	/// Whether the bias window is used.
+	static const bool biased = true;
+
+	/// The number of voltages to loop over.
+	static long points(const st_sim_params *p) {
+		return 1;
+	}
+
+	/// Sets the voltages of a batch.
+	template <class Source>
+	static void draw(const st_sim_params *p, long k, Source *src,
+		double *V, long m) {
+
+		src->uniform(p->Vmin, p->Vmax, V, m);
+	}
+};
+
+// ---------------------------------------------------------------------------
+// Site level energy policies
+
+/**
+ * \brief Normally distributed about a fixed average.
+ */
+struct epsilon_fixed {
+	/// Draws the site level energies of a batch.
+	template <class Source>
+	static void draw(const st_sim_params *p, Source *src, st_sim_batch *b,
+		long m) {
+
+		draw_param(src, p->epsilon_pdf, p->epsilon0, p->depsilon, b->epsilon,
+			m);
+	}
+
+	/// Adds any extra terms to the bias-window average of the transmission.
+	static double combine(const st_sim_params *p, double G, double Tplus,
+		double Tminus) {
+
+		return G;
+	}
+};
+
+/**
+ * \brief Normally distributed about mepsilon * V + bepsilon.
+ *
+ * The voltage dependence of the level adds mepsilon * (T(EF + (eta-1)V) -
+ * T(EF + eta V)) to the conductance.
+ */
+struct epsilon_linear {
+	/// Draws the site level energies of a batch.
+	template <class Source>
+	static void draw(const st_sim_params *p, Source *src, st_sim_batch *b,
+		long m) {
+
+		long j;
+
+		// draw the fluctuations; the mean is shifted with V
+		draw_param(src, p->epsilon_pdf, 0.0, p->depsilon, b->epsilon, m);
+		for (j = 0; j < m; ++j)
+			b->epsilon[j] += p->mepsilon * b->V[j] + p->bepsilon;
+	}
+
+	/// Adds any extra terms to the bias-window average of the transmission.
+	static double combine(const st_sim_params *p, double G, double Tplus,
+		double Tminus) {
+
+		// extended definite integral simplifies down to coefficient *
+		// transmission
+		return G + p->mepsilon * Tminus - p->mepsilon * Tplus;
+	}
+};
+
+// ---------------------------------------------------------------------------
+// Eta policies
+
+/**
+ * \brief A fixed relative voltage drop.
+ */
+struct eta_fixed {
+	/// Sets the relative voltage drops of a batch.
+	static void draw(const st_sim_params *p, double *eta, long m) {
+		long j;
+
+		for (j = 0; j < m; ++j)
+			eta[j] = p->eta;
+	}
+};
+
+/**
+ * \brief A beta-distributed relative voltage drop.
+ *
+ * This is always pseudo-random, even with Sobol points. The batch is drawn
+ * from the tabulated distribution (see distributions.h) with p->eta_r; an
+ * unbounded density, which cannot be tabulated, falls back to gsl_ran_beta
+ * with p->beta_rng.
+ */
+struct eta_beta {
+	/// Draws the relative voltage drops of a batch.
+	static void draw(const st_sim_params *p, double *eta, long m) {
+		long j;
+
+		if (p->eta_dist != NULL) {
+			beta_dist_sample(p->eta_dist, p->eta_r, eta, m);
+			return;
+		}
+
+		for (j = 0; j < m; ++j)
+			eta[j] = gsl_ran_beta(p->beta_rng, p->eta_alpha, p->eta_beta);
+	}
+};
+
+// ---------------------------------------------------------------------------
+// Draw orders
+
+/**
+ * \brief Voltage, coupling, site level energy, then the other coupling.
+ */
+struct order_standard {
+	/// Draws a batch.
+	template <class Model, class Voltage, class Epsilon, class Source>
+	static void draw(const st_sim_params *p, long k, Source *src,
+		st_sim_batch *b, long m) {
+
+		Voltage::draw(p, k, src, b->V, m);
+		draw_param(src, p->gamma1_pdf, p->gamma1, p->dgamma, b->gammaL, m);
+		Epsilon::draw(p, src, b, m);
+		Model::draw(p, src, b, m);
+	}
+};
+
+/**
+ * \brief Voltage, site level energy, coupling, then the other coupling.
+ */
+struct order_epsilon_first {
+	/// Draws a batch.
+	template <class Model, class Voltage, class Epsilon, class Source>
+	static void draw(const st_sim_params *p, long k, Source *src,
+		st_sim_batch *b, long m) {
+
+		Voltage::draw(p, k, src, b->V, m);
+		Epsilon::draw(p, src, b, m);
+		draw_param(src, p->gamma1_pdf, p->gamma1, p->dgamma, b->gammaL, m);
+		Model::draw(p, src, b, m);
+	}
+};
+
+/**
+ * \brief Site level energy, couplings, then voltage.
+ *
+ * Not for epsilon_linear, which needs the voltage first.
+ */
+struct order_voltage_last {
+	/// Draws a batch.
+	template <class Model, class Voltage, class Epsilon, class Source>
+	static void draw(const st_sim_params *p, long k, Source *src,
+		st_sim_batch *b, long m) {
+
+		Epsilon::draw(p, src, b, m);
+		draw_param(src, p->gamma1_pdf, p->gamma1, p->dgamma, b->gammaL, m);
+		Model::draw(p, src, b, m);
+		Voltage::draw(p, k, src, b->V, m);
+	}
+};
+
+// ---------------------------------------------------------------------------
+
+/**
+ * \brief The number of random numbers per trial (Sobol dimensions) used by a
+ *        combination of policies.
+ */
+template <class Model, class Voltage>
+inline int simulate_draws() {
+	return Voltage::draws + 2 + Model::draws;
+}
+
+/**
+ * \brief Simulates all trials with the given policies.
+ *
+ * \param[in] p The parameters.
+ * \param[in,out] src The source of random numbers.
+ * \param[in,out] out Where the trials go.
+ */
+template <class Model, class Voltage, class Eta, class Epsilon, class Order,
+	class Source>
+void simulate(const st_sim_params *p, Source *src, st_sim_output *out) {
+	st_sim_batch b;
+	long k, i, j, m, npoints;
+	double Tplus, Tminus;
+
+	npoints = Voltage::points(p);
+	for (k = 0; k < npoints; ++k) {
+		for (i = 0; i < p->n; i += Source::batch) {
+			m = (p->n - i < Source::batch) ? p->n - i : Source::batch;
+
+			src->begin(m);
+			Order::template draw<Model, Voltage, Epsilon>(p, k, src, &b, m);
+			Eta::draw(p, b.eta, m);
+
+			for (j = 0; j < m; ++j) {
+				if (!Voltage::biased) {
+					b.G[j] = Model::transmission(&b, j, p->EF);
+					continue;
+				}
+
+				Tplus = Model::transmission(&b, j, p->EF + b.eta[j]*b.V[j]);
+				Tminus = Model::transmission(&b, j,
+					p->EF + (b.eta[j] - 1.0)*b.V[j]);
+				b.G[j] = Epsilon::combine(p,
+					b.eta[j] * Tplus + (1.0 - b.eta[j]) * Tminus, Tplus, Tminus);
+			}
+
+			output_batch(out, &b, m);
+		}
+	}
+}
+
+/**
+ * \brief Simulates n junctions, each at every voltage of the grid.
+ *
+ * Where simulate() with voltage_grid draws new parameters for every trial,
+ * here each junction's parameters are drawn once and Model::grid() evaluates
+ * the junction across the whole grid, so there are fewer random numbers by a
+ * factor of the number of voltages. The trials are output junction by
+ * junction: each junction's trials, in the order of the voltages, form its
+ * conductance-voltage trace. Eta and the average site level energy are
+ * fixed.
+ *
+ * \param[in] p The parameters.
+ * \param[in,out] src The source of random numbers.
+ * \param[in,out] out Where the trials go.
+ */
+template <class Model, class Order, class Source>
+void simulate_junctions(const st_sim_params *p, Source *src,
+	st_sim_output *out) {
+
+	st_sim_batch b, rows;
+	double *V, *G;
+	long k, i, j, m, npoints, nrows;
+
+	npoints = voltage_grid::points(p);
+	V = (double*)malloc(npoints*sizeof(double));
+	G = (double*)malloc(npoints*TRIALS_PER_BATCH*sizeof(double));
+	voltage_grid::voltages(p, V);
+
+	nrows = 0;
+	for (i = 0; i < p->n; i += Source::batch) {
+		m = (p->n - i < Source::batch) ? p->n - i : Source::batch;
+
+		src->begin(m);
+		Order::template draw<Model, voltage_grid, epsilon_fixed>(p, 0, src,
+			&b, m);
+		Model::grid(p, V, npoints, &b, G, m);
+
+		// regroup the trials by junction
+		for (j = 0; j < m; ++j)
+			for (k = 0; k < npoints; ++k) {
+				rows.V[nrows] = V[k];
+				rows.G[nrows] = G[k*m + j];
+				if (++nrows == TRIALS_PER_BATCH) {
+					output_batch(out, &rows, nrows);
+					nrows = 0;
+				}
+			}
+	}
+	if (nrows > 0)
+		output_batch(out, &rows, nrows);
+
+	free(G);
+	free(V);
+}
+
+#endif
@@ -0,0 +1,155 @@
+/*
+This work is licensed under the Creative Commons Attribution 3.0 United States
+License. To view a copy of this license, visit
+http://creativecommons.org/licenses/by/3.0/us/ or send a letter to Creative
+Commons, 444 Castro Street, Suite 900, Mountain View, California, 94041, USA.
+
+Copyright (C) 2013 Oak Ridge National Laboratory
+*/
+/**
+ * \file sobol.cc
+ * \brief Implementation of the scrambled Sobol sequence.
+ *
+ * \author agent
+ * \date October 2026
+ */
+
+#include "sobol.h"
+
+/// 2^-32, to convert a coordinate into (0, 1).
+static const double sobol_unit = 1.0 / 4294967296.0;
+
+/**
+ * \brief The Joe-Kuo primitive polynomials and initial direction numbers for
+ *        dimensions 2 through #SOBOL_MAX_DIMS.
+ */
+typedef struct {
+	/// The degree of the polynomial.
+	int s;
+
+	/// The polynomial's interior coefficients, as bits.
+	unsigned int a;
+
+	/// The initial direction numbers.
+	unsigned int m[5];
+} st_joe_kuo;
+
+/// Dimensions 2 through 8 of new-joe-kuo-6.21201.
+static const st_joe_kuo joe_kuo[SOBOL_MAX_DIMS - 1] = {
+	{1, 0, {1}},
+	{2, 1, {1, 3}},
+	{3, 1, {1, 3, 1}},
+	{3, 2, {1, 1, 1}},
+	{4, 1, {1, 1, 3, 3}},
+	{4, 4, {1, 3, 5, 13}},
+	{5, 2, {1, 1, 5, 5, 17}}
+};
+
+/**
+ * \brief Reverses the bits of a 32-bit word.
+ */
+static inline unsigned int reverse_bits(unsigned int x) {
+	x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+	x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+	x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+	x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+	return (x >> 16) | (x << 16);
+}
+
+/**
+ * \brief Owen scrambles a coordinate.
+ *
+ * Each bit is flipped according to a hash of the bits above it (a nested
+ * uniform scramble). The Laine-Karras hash only propagates upward, so it is
+ * applied to the bit-reversed coordinate.
+ *
+ * \param[in] x The coordinate.
+ * \param[in] seed The dimension's scrambling seed.
+ * \return The scrambled coordinate.
+ */
+static inline unsigned int owen_scramble(unsigned int x, unsigned int seed) {
+	x = reverse_bits(x);
+	x += seed;
+	x ^= x * 0x6C50B47Cu;
+	x ^= x * 0xB82F1E52u;
+	x ^= x * 0xC7AFE638u;
+	x ^= x * 0x8D22F6E6u;
+	return reverse_bits(x);
+}
+
+/**
+ * \brief Hashes the replica and dimension into a scrambling seed.
+ */
+static unsigned int scramble_seed(unsigned long replica, int dim) {
+	unsigned long long z = replica * 0x9E3779B97F4A7C15ULL + (dim + 1) *
+		0xD1B54A32D192ED03ULL;
+
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return (unsigned int)(z ^ (z >> 31));
+}
+
+void sobol_init(st_sobol *s, int dims, unsigned long replica) {
+	int d, i, k, deg;
+	unsigned int a;
+
+	if (dims > SOBOL_MAX_DIMS)
+		dims = SOBOL_MAX_DIMS;
+	s->dims = dims;
+
+	for (d = 0; d < dims; ++d) {
+		if (d == 0) {
+			// the first dimension is the van der Corput sequence
+			for (i = 0; i < SOBOL_BITS; ++i)
+				s->v[d][i] = 1u << (SOBOL_BITS - 1 - i);
+		}
+		else {
+			deg = joe_kuo[d - 1].s;
+			a = joe_kuo[d - 1].a;
+			for (i = 0; i < deg; ++i)
+				s->v[d][i] = joe_kuo[d - 1].m[i] << (SOBOL_BITS - 1 - i);
+			for (i = deg; i < SOBOL_BITS; ++i) {
+				s->v[d][i] = s->v[d][i - deg] ^ (s->v[d][i - deg] >> deg);
+				for (k = 1; k < deg; ++k)
+					if ((a >> (deg - 1 - k)) & 1)
+						s->v[d][i] ^= s->v[d][i - k];
+			}
+		}
+
+		s->seed[d] = scramble_seed(replica, d);
+	}
+
+	sobol_skip(s, 0);
+}
+
+void sobol_skip(st_sobol *s, unsigned long index) {
+	unsigned long gray = index ^ (index >> 1);
+	int d, i;
+
+	// the points are generated in Gray-code order
+	s->index = index;
+	for (d = 0; d < s->dims; ++d) {
+		s->x[d] = 0;
+		for (i = 0; i < SOBOL_BITS; ++i)
+			if ((gray >> i) & 1)
+				s->x[d] ^= s->v[d][i];
+	}
+}
+
+void sobol_next(st_sobol *s, double *const *u, size_t n) {
+	size_t k;
+	int d, c;
+
+	for (k = 0; k < n; ++k) {
+		for (d = 0; d < s->dims; ++d)
+			u[d][k] = (owen_scramble(s->x[d], s->seed[d]) + 0.5) * sobol_unit;
+
+		// the next point differs in the direction number of the lowest zero
+		// bit of the index
+		c = __builtin_ctzl(~s->index);
+		if (c < SOBOL_BITS)
+			for (d = 0; d < s->dims; ++d)
+				s->x[d] ^= s->v[d][c];
+		++s->index;
+	}
+}
@@ -0,0 +1,92 @@
+/*
+This work is licensed under the Creative Commons Attribution 3.0 United States
+License. To view a copy of this license, visit
+http://creativecommons.org/licenses/by/3.0/us/ or send a letter to Creative
+Commons, 444 Castro Street, Suite 900, Mountain View, California, 94041, USA.
+
+Copyright (C) 2013 Oak Ridge National Laboratory
+*/
+/**
+ * \file sobol.h
+ * \brief Prototypes for scrambled Sobol (quasi-random) points.
+ *
+ * The Sobol sequence fills the unit cube far more evenly than pseudo-random
+ * numbers, so histograms built from it converge faster. Each coordinate is
+ * Owen scrambled with a hash-based nested uniform permutation; the scrambled
+ * points are still low-discrepancy, but are randomized by the replica
+ * number. Independent replicas therefore give independent estimates, whose
+ * spread measures the error.
+ *
+ * Any point can be reached directly by its index, so a block of trials (see
+ * parallel.h) can start at its own offset in the sequence, and the output
+ * does not depend on the number of threads.
+ *
+ * The direction numbers are those of S.\ Joe and F.\ Y.\ Kuo, SIAM J.\ Sci.\
+ * Comput.\ \b 30, 2635-2654 (2008). The scrambling follows B.\ Burley,
+ * J.\ Comput.\ Graph.\ Tech.\ \b 9, 10-25 (2020).
+ *
+ * \author agent
+ * \date October 2026
+ */
+
+#ifndef __sobol_h__
+#define __sobol_h__
+
+#include <cstddef>
+
+/// The largest number of dimensions supported.
+#define SOBOL_MAX_DIMS 8
+
+/// The number of bits in each coordinate (and in the point index).
+#define SOBOL_BITS 32
+
+/**
+ * \brief The state of a scrambled Sobol sequence.
+ */
+typedef struct {
+	/// The number of dimensions.
+	int dims;
+
+	/// The direction numbers of each dimension.
+	unsigned int v[SOBOL_MAX_DIMS][SOBOL_BITS];
+
+	/// The scrambling seed of each dimension.
+	unsigned int seed[SOBOL_MAX_DIMS];
+
+	/// The index of the next point.
+	unsigned long index;
+
+	/// The (unscrambled) coordinates of the next point.
+	unsigned int x[SOBOL_MAX_DIMS];
+} st_sobol;
+
+/**
+ * \brief Sets up a scrambled Sobol sequence, positioned at its first point.
+ *
+ * \param[out] s The sequence.
+ * \param[in] dims The number of dimensions (at most #SOBOL_MAX_DIMS).
+ * \param[in] replica The replica number, from which the scrambling is
+ *            derived.
+ */
+void sobol_init(st_sobol *s, int dims, unsigned long replica);
+
+/**
+ * \brief Moves to the specified point of the sequence.
+ *
+ * \param[in,out] s The sequence.
+ * \param[in] index The index of the next point to generate (less than
+ *            2^#SOBOL_BITS).
+ */
+void sobol_skip(st_sobol *s, unsigned long index);
+
+/**
+ * \brief Generates the next points of the sequence.
+ *
+ * \param[in,out] s The sequence.
+ * \param[out] u One array per dimension; u[d][k] is coordinate d of the
+ *             k-th point, in (0, 1).
+ * \param[in] n The number of points.
+ */
+void sobol_next(st_sobol *s, double *const *u, size_t n);
+
+#endif
@@ -0,0 +1,97 @@
+/*
+This work is licensed under the Creative Commons Attribution 3.0 United States
+License. To view a copy of this license, visit
+http://creativecommons.org/licenses/by/3.0/us/ or send a letter to Creative
+Commons, 444 Castro Street, Suite 900, Mountain View, California, 94041, USA.
+
+Copyright (C) 2013 Oak Ridge National Laboratory
+*/
+/**
+ * \file text-format.cc
+ * \brief Implementation of the fast text output.
+ *
+ * \author agent
+ * \date October 2026
+ */
+
+#include "text-format.h"
+#include <cstdlib>
+#include <charconv>
+
+/**
+ * \brief Formats a number with six digits after the decimal point.
+ *
+ * \param[out] p Where to write the number.
+ * \param[in] end The end of the space available.
+ * \param[in] x The number.
+ * \param[in] fmt Fixed or scientific notation.
+ * \return The end of the number.
+ */
+static char *format_six(char *p, char *end, double x, std::chars_format fmt) {
+	std::to_chars_result r = std::to_chars(p, end, x, fmt, 6);
+	int len;
+
+	if (r.ec == std::errc())
+		return r.ptr;
+
+	// too long for the space; fall back to (truncating) snprintf
+	len = snprintf(p, end - p, (fmt == std::chars_format::fixed) ? "%.6f" :
+		"%.6e", x);
+	return (len < end - p) ? p + len : end - 1;
+}
+
+char *format_fixed(char *p, char *end, double x) {
+	return format_six(p, end, x, std::chars_format::fixed);
+}
+
+char *format_scientific(char *p, char *end, double x) {
+	return format_six(p, end, x, std::chars_format::scientific);
+}
+
+st_text_output *text_output_alloc(FILE *f) {
+	st_text_output *t = (st_text_output*)malloc(sizeof(st_text_output));
+
+	t->f = f;
+	t->buf = (char*)malloc(TEXT_OUTPUT_BUFFER);
+	t->len = 0;
+	return t;
+}
+
+void text_output_free(st_text_output *t) {
+	text_output_flush(t);
+	free(t->buf);
+	free(t);
+}
+
+void text_output_flush(st_text_output *t) {
+	fwrite(t->buf, 1, t->len, t->f);
+	t->len = 0;
+}
+
+void text_output_row(st_text_output *t, const double *x, int n,
+	bool scientific) {
+
+	char *p, *end;
+	int i;
+
+	if (t->len + (size_t)n*(TEXT_MAX_NUMBER + 1) > TEXT_OUTPUT_BUFFER)
+		text_output_flush(t);
+
+	p = t->buf + t->len;
+	end = t->buf + TEXT_OUTPUT_BUFFER;
+	for (i = 0; i < n; ++i) {
+		if (i > 0)
+			*p++ = ' ';
+		p = scientific ? format_scientific(p, end, x[i]) :
+			format_fixed(p, end, x[i]);
+	}
+	*p++ = '\n';
+
+	t->len = p - t->buf;
+}
+
+void text_output_newline(st_text_output *t) {
+	if (t->len == TEXT_OUTPUT_BUFFER)
+		text_output_flush(t);
+	t->buf[t->len++] = '\n';
+}
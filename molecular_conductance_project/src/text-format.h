@@ -0,0 +1,111 @@
+/*
+This work is licensed under the Creative Commons Attribution 3.0 United States
+License. To view a copy of this license, visit
+http://creativecommons.org/licenses/by/3.0/us/ or send a letter to Creative
+Commons, 444 Castro Street, Suite 900, Mountain View, California, 94041, USA.
+
+Copyright (C) 2013 Oak Ridge National Laboratory
+*/
+/**
+ * \file text-format.h
+ * \brief Prototypes for writing the text output of the simulators and
+ *        binners quickly.
+ *
+ * Numbers are formatted with std::to_chars, which produces exactly the same
+ * characters as printf's `%.6f' and `%.6e' without parsing a format string
+ * or locking the stream for every number. Rows are collected in a large
+ * buffer that is flushed with one fwrite at a time.
+ *
+ * \author agent
+ * \date October 2026
+ */
+
+#ifndef __text_format_h__
+#define __text_format_h__
+
+#include <cstdio>
+#include <cstddef>
+
+/// The most characters needed for one number (`%.6f' of the largest double).
+#define TEXT_MAX_NUMBER 330
+
+/// The size of the output buffer.
+#define TEXT_OUTPUT_BUFFER (1 << 20)
+
+/**
+ * \brief A buffered text output stream.
+ */
+typedef struct {
+	/// The file the text goes to.
+	FILE *f;
+
+	/// The buffered text.
+	char *buf;
+
+	/// The number of buffered characters.
+	size_t len;
+} st_text_output;
+
+/**
+ * \brief Formats a number as printf's `%.6f' would.
+ *
+ * \param[out] p Where to write the number.
+ * \param[in] end The end of the space available; if the number does not fit,
+ *            it is truncated as snprintf would.
+ * \param[in] x The number.
+ * \return The end of the number.
+ */
+char *format_fixed(char *p, char *end, double x);
+
+/**
+ * \brief Formats a number as printf's `%.6e' would.
+ *
+ * \param[out] p Where to write the number.
+ * \param[in] end The end of the space available.
+ * \param[in] x The number.
+ * \return The end of the number.
+ */
+char *format_scientific(char *p, char *end, double x);
+
+/**
+ * \brief Allocates a buffered text output stream.
+ *
+ * \param[in] f The file the text goes to.
+ * \return The stream.
+ */
+st_text_output *text_output_alloc(FILE *f);
+
+/**
+ * \brief Flushes and frees a buffered text output stream.
+ *
+ * \param[in] t The stream.
+ */
+void text_output_free(st_text_output *t);
+
+/**
+ * \brief Writes the buffered text to the file.
+ *
+ * \param[in,out] t The stream.
+ */
+void text_output_flush(st_text_output *t);
+
+/**
+ * \brief Writes a row of numbers, separated by spaces and ended by a
+ *        newline.
+ *
+ * \param[in,out] t The stream.
+ * \param[in] x The numbers.
+ * \param[in] n The number of numbers.
+ * \param[in] scientific Whether to use `%.6e' (true) or `%.6f' (false).
+ */
+void text_output_row(st_text_output *t, const double *x, int n,
+	bool scientific);
+
+/**
+ * \brief Writes an empty line.
+ *
+ * \param[in,out] t The stream.
+ */
+void text_output_newline(st_text_output *t);
+
+#endif